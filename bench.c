@@ -0,0 +1,1026 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Microbenchmarks for controller and plant hot paths.
+ *
+ * Each case reports nanoseconds and steps per second where a step is one
+ * controller update, one plant advance, one lane of a bank, or one
+ * frequency of a loop response.  Open-loop
+ * controller cases replay small precomputed input streams so that only the
+ * controller itself is measured, while case \c step3 closes the loop around
+ * the third-order process of \ref step3.c.  The best of several repetitions
+ * is reported.  On Linux, cycles, instructions, branch misses, and cache
+ * misses per step are collected via \c perf_event_open whenever permitted.
+ *
+ * Results print as a table or as JSON.  Given a JSON baseline from an
+ * earlier run, every case slower than the baseline by more than a threshold
+ * is flagged and the exit status is nonzero.  The exit status is also
+ * nonzero whenever the telemetry of \ref helm_trace.h adds more than a
+ * budgeted number of nanoseconds per step.
+ */
+
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+#include "helm.h"
+#include "helm_bank.h"
+#include "helm_fixed.h"
+#include "helm_freq.h"
+#include "helm_hist.h"
+#include "helm_plant.h"
+#include "helm_trace.h"
+
+/** Length of each precomputed input stream, a power of two. */
+enum { STREAM = 4096 };
+
+/** Lanes within each bank case. */
+enum { LANES = 1024 };
+
+/** Physical units per count within fixed point cases. */
+static const double COUNT = 0x1p-12;
+
+/** Hardware counters collected per case, in group order. */
+enum { CYCLES, INSTRUCTIONS, BRANCH_MISSES, CACHE_MISSES, NCOUNTERS };
+
+/** Names of each hardware counter, in group order. */
+static const char * const counter_name[NCOUNTERS] = {
+    "cycles", "instructions", "branch_misses", "cache_misses"
+};
+
+/** Defeats dead-code elimination of benchmarked loops. */
+static volatile double sink;
+
+/** Precomputed inputs shared by the open-loop cases. */
+static struct
+{
+    double dt [STREAM];  ///< Jittered time steps around 1e-3
+    double y  [STREAM];  ///< Smooth process observations
+    double yn [STREAM];  ///< Observations with roughly half NaN at random
+    double r  [LANES];   ///< Per-lane references
+    double dtl[LANES];   ///< Per-lane time steps
+    int32_t yq[STREAM];  ///< Observations #y quantized to counts
+    int32_t rq[LANES];   ///< References #r quantized to counts
+} in;
+
+/** Fill #in from a fixed-seed generator so runs are comparable. */
+static
+void
+prepare(void)
+{
+    uint64_t s = 88172645463325252ull;                // xorshift64
+    for (size_t i = 0; i < STREAM; ++i) {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        const double uniform = (s >> 11) * 0x1p-53;
+        in.dt[i] = 1e-3 * (0.5 + uniform);
+        in.y [i] = sin(2*M_PI*i/STREAM) + 0.01*uniform;
+        in.yn[i] = (s >> 3) & 1 ? NAN : in.y[i];
+        in.yq[i] = helm_fixed_quantize(in.y[i], COUNT);
+    }
+    for (size_t k = 0; k < LANES; ++k) {
+        in.r  [k] = 1 + 1e-3*k;
+        in.dtl[k] = 1e-3;
+        in.rq [k] = helm_fixed_quantize(in.r[k], COUNT);
+    }
+}
+
+/** Tuning shared by every controller case. */
+static
+void
+tune(struct helm_state * const h)
+{
+    helm_reset(h);
+    h->kp = 2;
+    h->Td = 0.25;
+    h->Tf = 0.025;
+    h->Ti = 1.5;
+    h->Tt = 1.5;
+    helm_approach(h);
+}
+
+/** Monotonic wall time in nanoseconds. */
+static
+double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return 1e9*ts.tv_sec + ts.tv_nsec;
+}
+
+/** Hardware counter group, where file descriptors are negative if absent. */
+static int counter_fd[NCOUNTERS] = { -1, -1, -1, -1 };
+
+/** Open #counter_fd for this thread when the kernel permits. */
+static
+void
+counters_open(void)
+{
+#ifdef __linux__
+    static const uint64_t config[NCOUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES,    PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES
+    };
+    for (int c = 0; c < NCOUNTERS; ++c) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.config         = config[c];
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        const int leader    = counter_fd[CYCLES];
+        counter_fd[c] = (int) syscall(SYS_perf_event_open, &attr, 0, -1,
+                                      c == CYCLES ? -1 : leader, 0);
+        if (c == CYCLES && counter_fd[c] < 0) {
+            return;                       // No leader means no counters
+        }
+    }
+#endif
+}
+
+/** Reset and enable every open counter. */
+static
+void
+counters_start(void)
+{
+#ifdef __linux__
+    for (int c = 0; c < NCOUNTERS; ++c) {
+        if (counter_fd[c] >= 0) {
+            ioctl(counter_fd[c], PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+    if (counter_fd[CYCLES] >= 0) {
+        ioctl(counter_fd[CYCLES], PERF_EVENT_IOC_ENABLE,
+              PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+/** Disable counters and store totals into \c out, NaN where absent. */
+static
+void
+counters_stop(double out[NCOUNTERS])
+{
+#ifdef __linux__
+    if (counter_fd[CYCLES] >= 0) {
+        ioctl(counter_fd[CYCLES], PERF_EVENT_IOC_DISABLE,
+              PERF_IOC_FLAG_GROUP);
+    }
+#endif
+    for (int c = 0; c < NCOUNTERS; ++c) {
+        uint64_t value;
+        out[c] = counter_fd[c] >= 0
+              && sizeof(value) == read(counter_fd[c], &value, sizeof(value))
+               ? (double) value : NAN;
+    }
+}
+
+/** Measurements for one repetition of one case. */
+struct sample
+{
+    double ns;                  ///< Wall time in nanoseconds
+    double counter[NCOUNTERS];  ///< Counter totals, NaN where unavailable
+};
+
+/** Begin timing a repetition. */
+static
+void
+begin(struct sample * const m)
+{
+    counters_start();
+    m->ns = now();
+}
+
+/** Finish timing a repetition begun by begin(). */
+static
+void
+end(struct sample * const m)
+{
+    m->ns = now() - m->ns;
+    counters_stop(m->counter);
+}
+
+/** Signature for each case, which times \c n steps into \c m. */
+typedef void (*case_fn)(long n, struct sample *m);
+
+static
+void
+case_steady(const long n, struct sample * const m)
+{
+    struct helm_state h;
+    tune(&h);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steady(&h, 1e-3, 1, v, v, in.y[i & (STREAM-1)]);
+    }
+    end(m);
+    sink = v;
+}
+
+static
+void
+case_steady_dt(const long n, struct sample * const m)
+{
+    struct helm_state h;
+    tune(&h);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        const long j = i & (STREAM-1);
+        v += helm_steady(&h, in.dt[j], 1, v, v, in.y[j]);
+    }
+    end(m);
+    sink = v;
+}
+
+static
+void
+case_steady_nan(const long n, struct sample * const m)
+{
+    struct helm_state h;
+    tune(&h);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steady(&h, 1e-3, 1, v, v, in.yn[i & (STREAM-1)]);
+    }
+    end(m);
+    sink = v;
+}
+
+static
+void
+case_steadyf(const long n, struct sample * const m)
+{
+    struct helm_state  h;
+    struct helm_statef hf;
+    tune(&h);
+    helm_resetf(&hf);
+    hf.kp = (float) h.kp; hf.Td = (float) h.Td; hf.Tf = (float) h.Tf;
+    hf.Ti = (float) h.Ti; hf.Tt = (float) h.Tt;
+    helm_approachf(&hf);
+    float v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steadyf(&hf, 1e-3f, 1, v, v, (float) in.y[i & (STREAM-1)]);
+    }
+    end(m);
+    sink = v;
+}
+
+static
+void
+case_compiled(const long n, struct sample * const m)
+{
+    struct helm_state h;
+    tune(&h);
+    struct helm_compiled c = helm_compile(&h, 1e-3);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steady_compiled(&h, &c, 1e-3, 1, v, v,
+                                  in.y[i & (STREAM-1)]);
+    }
+    end(m);
+    sink = v;
+}
+
+static
+void
+case_fixed(const long n, struct sample * const m)
+{
+    struct helm_state h;
+    tune(&h);
+    struct helm_fixed c;
+    helm_fixed_compile(&c, &h, 1e-3, COUNT, COUNT);
+    helm_fixed_approach(&c);
+    const int32_t r = helm_fixed_quantize(1, COUNT);
+    int32_t v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v = helm_fixed_add(v, helm_fixed_steady(&c, r, v, v,
+                                                in.yq[i & (STREAM-1)]));
+    }
+    end(m);
+    sink = v;
+}
+
+/** Replay #in in blocks of #STREAM through helm_steady_series(). */
+static
+void
+series(const long n, struct sample * const m, const int flags)
+{
+    static double r[STREAM], u[STREAM], v[STREAM];
+    for (size_t i = 0; i < STREAM; ++i) {
+        r[i] = 1;
+        u[i] = 0;
+    }
+    struct helm_state h;
+    tune(&h);
+    begin(m);
+    for (long i = 0; i < n; i += STREAM) {
+        v[0] = v[STREAM-1];
+        helm_steady_series(&h, STREAM, in.dt, r, u, v, in.y,
+                           flags | HELM_SERIES_ACCUMULATE);
+    }
+    end(m);
+    sink = v[STREAM-1];
+}
+
+static
+void
+case_series(const long n, struct sample * const m)
+{
+    series(n, m, HELM_SERIES_DT_CONSTANT);
+}
+
+static
+void
+case_series_dt(const long n, struct sample * const m)
+{
+    series(n, m, 0);
+}
+
+static
+void
+case_trace(const long n, struct sample * const m)
+{
+    enum { CAPACITY = 1 << 16 };
+    struct helm_trace t;
+    struct helm_trace_writer w;
+    void * const mem = malloc(helm_trace_bytes(CAPACITY));
+    FILE * const devnull = fopen("/dev/null", "w");
+    if (!mem || !devnull || (helm_trace_init(&t, CAPACITY, mem),
+                  helm_trace_writer_start(&w, &t, devnull, 100))) {
+        perror("trace");
+        exit(EXIT_FAILURE);
+    }
+    struct helm_state h;
+    tune(&h);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steady_trace(&h, &t, 1e-3, 1, v, v, in.y[i & (STREAM-1)]);
+    }
+    end(m);
+    sink = v;
+    helm_trace_writer_stop(&w);
+    fclose(devnull);
+    free(mem);
+}
+
+/** Time each helm_steady() into a histogram, \c shared or not. */
+static
+void
+hist(const long n, struct sample * const m, const int shared)
+{
+    static struct helm_hist g;
+    helm_hist_init(&g, 1);
+    struct helm_state h;
+    tune(&h);
+    double v = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        const uint64_t t0 = helm_hist_ticks();
+        v += helm_steady(&h, 1e-3, 1, v, v, in.y[i & (STREAM-1)]);
+        const uint64_t dt = helm_hist_ticks() - t0;
+        if (shared) {
+            helm_hist_record_shared(&g, dt);
+        } else {
+            helm_hist_record(&g, dt);
+        }
+    }
+    end(m);
+    sink = v + (double) helm_hist_total(&g);
+}
+
+static
+void
+case_hist(const long n, struct sample * const m)
+{
+    hist(n, m, 0);
+}
+
+static
+void
+case_hist_shared(const long n, struct sample * const m)
+{
+    hist(n, m, 1);
+}
+
+/** Kernels of \ref helm_bank.h measurable by bank(). */
+enum kernel { DISPATCH, SCALAR, SSE2, AVX2, AVX512 };
+
+/** Advance a bank of #LANES controllers using \c kernel. */
+static
+void
+bank(const long n, struct sample * const m, const enum kernel kernel)
+{
+    static double u[LANES], v[LANES], y[LANES], dv[LANES];
+    struct helm_bank b;
+    void *mem;
+    if (posix_memalign(&mem, HELM_BANK_ALIGN, helm_bank_bytes(LANES))) {
+        perror("bank");
+        exit(EXIT_FAILURE);
+    }
+    helm_bank_init(&b, LANES, mem);
+    struct helm_state h;
+    tune(&h);
+    for (size_t k = 0; k < LANES; ++k) {
+        helm_bank_set(&b, k, &h);
+        u[k] = v[k] = 0;
+    }
+    begin(m);
+    for (long i = 0; i < n; i += LANES) {
+        const double yi = in.y[(i / LANES) & (STREAM-1)];
+        for (size_t k = 0; k < LANES; ++k) {
+            y[k] = yi;
+        }
+        switch (kernel) {
+        case DISPATCH:
+            helm_bank_steady(&b, in.dtl, in.r, u, v, y, dv);
+            break;
+        case SCALAR:
+            helm_bank_steady_scalar(&b, 0, LANES, in.dtl, in.r, u, v, y, dv);
+            break;
+#if HELM_BANK_X86
+        case SSE2:
+            helm_bank_steady_sse2(&b, 0, LANES, in.dtl, in.r, u, v, y, dv);
+            break;
+        case AVX2:
+            helm_bank_steady_avx2(&b, 0, LANES, in.dtl, in.r, u, v, y, dv);
+            break;
+        case AVX512:
+            helm_bank_steady_avx512(&b, 0, LANES, in.dtl, in.r, u, v, y, dv);
+            break;
+#endif
+        default:
+            abort();
+        }
+        for (size_t k = 0; k < LANES; ++k) {
+            u[k] = v[k] += dv[k];
+        }
+    }
+    end(m);
+    sink = v[LANES-1];
+    free(mem);
+}
+
+static
+void
+case_bank(const long n, struct sample * const m)
+{
+    bank(n, m, DISPATCH);
+}
+
+static
+void
+case_bank_scalar(const long n, struct sample * const m)
+{
+    bank(n, m, SCALAR);
+}
+
+#if HELM_BANK_X86
+static
+void
+case_bank_sse2(const long n, struct sample * const m)
+{
+    bank(n, m, SSE2);
+}
+
+static
+void
+case_bank_avx2(const long n, struct sample * const m)
+{
+    bank(n, m, AVX2);
+}
+
+static
+void
+case_bank_avx512(const long n, struct sample * const m)
+{
+    bank(n, m, AVX512);
+}
+#endif
+
+/** Advance a fixed point bank of #LANES controllers using \c kernel. */
+static
+void
+fixbank(const long n, struct sample * const m, const enum kernel kernel)
+{
+    static int32_t u[LANES], v[LANES], y[LANES], dv[LANES];
+    struct helm_fixed_bank b;
+    void *mem;
+    if (posix_memalign(&mem, HELM_FIXED_ALIGN, helm_fixed_bank_bytes(LANES))) {
+        perror("fixbank");
+        exit(EXIT_FAILURE);
+    }
+    helm_fixed_bank_init(&b, LANES, mem);
+    struct helm_state h;
+    struct helm_fixed c;
+    tune(&h);
+    helm_fixed_compile(&c, &h, 1e-3, COUNT, COUNT);
+    helm_fixed_approach(&c);
+    for (size_t k = 0; k < LANES; ++k) {
+        helm_fixed_bank_set(&b, k, &c);
+        u[k] = v[k] = 0;
+    }
+    begin(m);
+    for (long i = 0; i < n; i += LANES) {
+        const int32_t yi = in.yq[(i / LANES) & (STREAM-1)];
+        for (size_t k = 0; k < LANES; ++k) {
+            y[k] = yi;
+        }
+        switch (kernel) {
+        case DISPATCH:
+            helm_fixed_bank_steady(&b, in.rq, u, v, y, dv);
+            break;
+        case SCALAR:
+            helm_fixed_bank_steady_scalar(&b, 0, LANES, in.rq, u, v, y, dv);
+            break;
+#if HELM_FIXED_X86
+        case AVX2:
+            helm_fixed_bank_steady_avx2(&b, 0, LANES, in.rq, u, v, y, dv);
+            break;
+        case AVX512:
+            helm_fixed_bank_steady_avx512(&b, 0, LANES, in.rq, u, v, y, dv);
+            break;
+#endif
+        default:
+            abort();
+        }
+        for (size_t k = 0; k < LANES; ++k) {
+            u[k] = v[k] = helm_fixed_add(v[k], dv[k]);
+        }
+    }
+    end(m);
+    sink = v[LANES-1];
+    free(mem);
+}
+
+static
+void
+case_fixbank(const long n, struct sample * const m)
+{
+    fixbank(n, m, DISPATCH);
+}
+
+static
+void
+case_fixbank_scalar(const long n, struct sample * const m)
+{
+    fixbank(n, m, SCALAR);
+}
+
+#if HELM_FIXED_X86
+static
+void
+case_fixbank_avx2(const long n, struct sample * const m)
+{
+    fixbank(n, m, AVX2);
+}
+
+static
+void
+case_fixbank_avx512(const long n, struct sample * const m)
+{
+    fixbank(n, m, AVX512);
+}
+#endif
+
+/** Process coefficients matching step3 defaults. */
+static const double plant_a[3] = {1, 3, 3};
+static const double plant_b[3] = {1, 0, 0};
+
+static
+void
+case_plant(const long n, struct sample * const m)
+{
+    struct helm_plant p;
+    helm_plant_init(&p, 3, plant_a, plant_b, 1e-2, HELM_PLANT_EULER);
+    double x[3] = {0, 0, 0}, y = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        y = helm_plant_advance(&p, x, in.y[i & (STREAM-1)] + 1e-3*y);
+    }
+    end(m);
+    sink = y;
+}
+
+static
+void
+case_plant_bank(const long n, struct sample * const m)
+{
+    static double u[LANES], y[LANES];
+    struct helm_plant p;
+    struct helm_plant_bank pb;
+    helm_plant_init(&p, 3, plant_a, plant_b, 1e-2, HELM_PLANT_EULER);
+    void *mem;
+    if (posix_memalign(&mem, 64, helm_plant_bank_bytes(3, LANES))) {
+        perror("plant_bank");
+        exit(EXIT_FAILURE);
+    }
+    helm_plant_bank_init(&pb, 3, LANES, mem);
+    for (size_t k = 0; k < LANES; ++k) {
+        helm_plant_bank_set(&pb, k, &p);
+        u[k] = y[k] = 0;
+    }
+    begin(m);
+    for (long i = 0; i < n; i += LANES) {
+        const double ui = in.y[(i / LANES) & (STREAM-1)];
+        for (size_t k = 0; k < LANES; ++k) {
+            u[k] = ui + 1e-3*y[k];
+        }
+        helm_plant_bank_advance(&pb, u, y);
+    }
+    end(m);
+    sink = y[LANES-1];
+    free(mem);
+}
+
+/** Frequencies within each freq case. */
+enum { FREQS = 1024 };
+
+/** Analyses of \ref helm_freq.h measurable by freq(). */
+enum analysis { LOOP, LOOP_SCALAR, MARGINS };
+
+/** Screen candidate tunings against the step3 process, one per #FREQS. */
+static
+void
+freq(const long n, struct sample * const m, const enum analysis analysis)
+{
+    struct helm_plant p;
+    struct helm_freq g;
+    struct helm_freq_margins fm;
+    helm_plant_init(&p, 3, plant_a, plant_b, 1e-2, HELM_PLANT_ZOH);
+    void *mem;
+    if (posix_memalign(&mem, HELM_FREQ_ALIGN, helm_freq_bytes(FREQS))
+            || helm_freq_init(&g, FREQS, 1e-3, 1e3, &p, 1, 0, mem)) {
+        perror("freq");
+        exit(EXIT_FAILURE);
+    }
+    struct helm_state h;
+    tune(&h);
+    double c[HELM_FREQ_NCOEFF], acc = 0;
+    begin(m);
+    for (long i = 0; i < n; i += FREQS) {
+        h.kp = 1 + 1e-3*in.y[(i / FREQS) & (STREAM-1)];
+        switch (analysis) {
+        case LOOP:
+            helm_freq_loop(&g, &h);
+            break;
+        case LOOP_SCALAR:
+            helm_freq_loop_scalar(&g, 0, FREQS,
+                                  helm_freq_coeffs(&g, &h, c));
+            break;
+        case MARGINS:
+            acc += helm_freq_analyze(&g, &h, &fm)->ms;
+            break;
+        }
+        acc += g.lr[FREQS-1];
+    }
+    end(m);
+    sink = acc;
+    free(mem);
+}
+
+static
+void
+case_freq(const long n, struct sample * const m)
+{
+    freq(n, m, LOOP);
+}
+
+static
+void
+case_freq_scalar(const long n, struct sample * const m)
+{
+    freq(n, m, LOOP_SCALAR);
+}
+
+static
+void
+case_freq_margins(const long n, struct sample * const m)
+{
+    freq(n, m, MARGINS);
+}
+
+/** Closed loop as within step3.c with a one step dead time. */
+static
+void
+case_step3(const long n, struct sample * const m)
+{
+    struct helm_plant p;
+    helm_plant_init(&p, 3, plant_a, plant_b, 1e-2, HELM_PLANT_EULER);
+    struct helm_state h;
+    helm_reset(&h);
+    h.kp = 1;
+    h.Td = 1;
+    h.Tf = 0.01;
+    h.Ti = 1;
+    helm_approach(&h);
+    double buf[1];
+    struct helm_delay dl;
+    helm_delay_init(&dl, 1, 1, buf, 0);
+    double x[3] = {0, 0, 0}, u = 0, v = 0, y = 0;
+    begin(m);
+    for (long i = 0; i < n; ++i) {
+        v += helm_steady(&h, 1e-2, (i >> 12) & 1, u, v, y);
+        u  = v;
+        double ud = u;
+        helm_delay_shift(&dl, &ud);
+        y  = helm_plant_advance(&p, x, ud);
+    }
+    end(m);
+    sink = y;
+}
+
+/** Every case in reporting order. */
+static const struct
+{
+    const char *name;  ///< Name used for selection and baselines
+    case_fn     fn;    ///< Case implementation
+    const char *isa;   ///< Required processor feature or NULL
+} cases[] = {
+    { "steady",        case_steady,        NULL      },
+    { "steady_dt",     case_steady_dt,     NULL      },
+    { "steady_nan",    case_steady_nan,    NULL      },
+    { "steadyf",       case_steadyf,       NULL      },
+    { "compiled",      case_compiled,      NULL      },
+    { "fixed",         case_fixed,         NULL      },
+    { "series",        case_series,        NULL      },
+    { "series_dt",     case_series_dt,     NULL      },
+    { "trace",         case_trace,         NULL      },
+    { "hist",          case_hist,          NULL      },
+    { "hist_shared",   case_hist_shared,   NULL      },
+    { "bank",          case_bank,          NULL      },
+    { "bank_scalar",   case_bank_scalar,   NULL      },
+#if HELM_BANK_X86
+    { "bank_sse2",     case_bank_sse2,     "sse2"    },
+    { "bank_avx2",     case_bank_avx2,     "avx2"    },
+    { "bank_avx512",   case_bank_avx512,   "avx512f" },
+#endif
+    { "fixbank",       case_fixbank,       NULL      },
+    { "fixbank_scalar", case_fixbank_scalar, NULL    },
+#if HELM_FIXED_X86
+    { "fixbank_avx2",  case_fixbank_avx2,  "avx2"    },
+    { "fixbank_avx512", case_fixbank_avx512, "avx512f" },
+#endif
+    { "plant",         case_plant,         NULL      },
+    { "plant_bank",    case_plant_bank,    NULL      },
+    { "freq",          case_freq,          NULL      },
+    { "freq_scalar",   case_freq_scalar,   NULL      },
+    { "freq_margins",  case_freq_margins,  NULL      },
+    { "step3",         case_step3,         NULL      },
+};
+
+/** Number of entries within #cases. */
+enum { NCASES = sizeof(cases) / sizeof(cases[0]) };
+
+/** Whether processor feature \c isa, if any, is available. */
+static
+int
+supported(const char * const isa)
+{
+    if (!isa) {
+        return 1;
+    }
+#if HELM_BANK_X86
+    if (!strcmp(isa, "sse2"))    return __builtin_cpu_supports("sse2");
+    if (!strcmp(isa, "avx2"))    return __builtin_cpu_supports("avx2");
+    if (!strcmp(isa, "avx512f")) return __builtin_cpu_supports("avx512f");
+#endif
+    return 0;
+}
+
+/** Reported outcome for one case. */
+struct result
+{
+    const char *name;                 ///< Case name
+    double      ns;                   ///< Best nanoseconds per step
+    double      counter[NCOUNTERS];   ///< Per-step counters, NaN if absent
+    double      baseline;             ///< Baseline ns per step, NaN if absent
+    int         regressed;            ///< Slower than baseline beyond limit
+};
+
+/**
+ * Load \c ns_per_step for \c name from a baseline written by \c -f json.
+ * \return NaN when \c name is not found.
+ */
+static
+double
+baseline_lookup(FILE * const f, const char * const name)
+{
+    char line[1024], key[64];
+    double ns;
+    rewind(f);
+    while (fgets(line, sizeof(line), f)) {
+        if (2 == sscanf(line, " { \"name\": \"%63[^\"]\", \"ns_per_step\": %lf",
+                        key, &ns)
+                && !strcmp(key, name)) {
+            return ns;
+        }
+    }
+    return NAN;
+}
+
+/** Output a JSON number or null when \c x is not finite. */
+static
+void
+json_number(const double x)
+{
+    if (isfinite(x)) {
+        printf("%.6g", x);
+    } else {
+        printf("null");
+    }
+}
+
+static
+void
+print_usage(const char *arg0, FILE *out)
+{
+    fprintf(out, "Usage: %s [OPTION...] [CASE...]\n", arg0);
+    fprintf(out, "Report ns/step and steps/s for controller and plant hot "
+                    "paths.\n");
+    fprintf(out, "Naming one or more CASE prefixes restricts which run.\n");
+    fputc('\n', out);
+    fprintf(out, "  -n N\t\tSteps per repetition (default 10000000)\n");
+    fprintf(out, "  -r R\t\tRepetitions per case, best reported (default 3)\n");
+    fprintf(out, "  -f fmt\tOne of text or json (default text)\n");
+    fprintf(out, "  -c FILE\tCompare against JSON baseline FILE\n");
+    fprintf(out, "  -p PCT\tFlag cases slower than baseline by PCT "
+                    "(default 10)\n");
+    fprintf(out, "  -b NS\t\tFail when tracing adds more ns/step "
+                    "(default 25)\n");
+    fprintf(out, "  -l\t\tList cases and exit\n");
+    fprintf(out, "  -h\t\tDisplay this help and exit\n");
+    fputc('\n', out);
+    fprintf(out, "Exit status is nonzero on any regression or exceeded "
+                    "budget.\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    long        n        = 10000000;
+    int         reps     = 3;
+    int         json     = 0;
+    const char *compare  = NULL;
+    double      pct      = 10;
+    double      budget   = 25;
+    int option;
+    while ((option = getopt(argc, argv, "n:r:f:c:p:b:lh")) != -1) {
+        switch (option) {
+            case 'n': n       = atol(optarg);            break;
+            case 'r': reps    = atoi(optarg);            break;
+            case 'f': json    = !strcmp(optarg, "json");
+                      if (!json && strcmp(optarg, "text")) {
+                          print_usage(argv[0], stderr);
+                          return EXIT_FAILURE;
+                      }                                  break;
+            case 'c': compare = optarg;                  break;
+            case 'p': pct     = atof(optarg);            break;
+            case 'b': budget  = atof(optarg);            break;
+            case 'l': for (int c = 0; c < NCASES; ++c) {
+                          puts(cases[c].name);
+                      }
+                      return EXIT_SUCCESS;
+            case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
+            default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
+        }
+    }
+    if (n <= 0 || reps <= 0) {
+        print_usage(argv[0], stderr);
+        return EXIT_FAILURE;
+    }
+    FILE * const base = compare ? fopen(compare, "r") : NULL;
+    if (compare && !base) {
+        perror(compare);
+        return EXIT_FAILURE;
+    }
+
+    prepare();
+    counters_open();
+
+    struct result results[NCASES];
+    int nresults = 0, failed = 0;
+    for (int c = 0; c < NCASES; ++c) {
+        int selected = optind == argc;
+        for (int a = optind; a < argc; ++a) {
+            selected |= !strncmp(cases[c].name, argv[a], strlen(argv[a]));
+        }
+        if (!selected || !supported(cases[c].isa)) {
+            continue;
+        }
+
+        struct sample best, s;
+        cases[c].fn(n / 10 + 1, &best);         // Warm up
+        best.ns = INFINITY;
+        for (int r = 0; r < reps; ++r) {
+            cases[c].fn(n, &s);
+            if (s.ns < best.ns) {
+                best = s;
+            }
+        }
+
+        struct result * const q = results + nresults++;
+        q->name = cases[c].name;
+        q->ns   = best.ns / n;
+        for (int k = 0; k < NCOUNTERS; ++k) {
+            q->counter[k] = best.counter[k] / n;
+        }
+        q->baseline  = base ? baseline_lookup(base, q->name) : NAN;
+        q->regressed = q->ns > q->baseline * (1 + pct/100);
+        failed      |= q->regressed;
+    }
+
+    // Bound tracing overhead whenever both relevant cases ran
+    double overhead = NAN;
+    for (int i = 0; i < nresults; ++i) {
+        for (int j = 0; j < nresults; ++j) {
+            if (!strcmp(results[i].name, "trace")
+                    && !strcmp(results[j].name, "steady")) {
+                overhead = results[i].ns - results[j].ns;
+            }
+        }
+    }
+    failed |= overhead > budget;
+
+    if (json) {
+        printf("{\n  \"steps\": %ld,\n  \"repetitions\": %d,\n", n, reps);
+        printf("  \"trace_overhead_ns\": ");
+        json_number(overhead);
+        printf(",\n  \"cases\": [\n");
+        for (int i = 0; i < nresults; ++i) {
+            const struct result * const q = results + i;
+            printf("    { \"name\": \"%s\", \"ns_per_step\": %.6g, "
+                   "\"steps_per_s\": %.6g", q->name, q->ns, 1e9 / q->ns);
+            for (int k = 0; k < NCOUNTERS; ++k) {
+                printf(", \"%s\": ", counter_name[k]);
+                json_number(q->counter[k]);
+            }
+            if (base) {
+                printf(", \"baseline_ns_per_step\": ");
+                json_number(q->baseline);
+                printf(", \"regressed\": %s", q->regressed ? "true" : "false");
+            }
+            printf(" }%s\n", i + 1 < nresults ? "," : "");
+        }
+        printf("  ]\n}\n");
+    } else {
+        printf("%-14s %10s %12s %10s %10s %10s %10s",
+               "case", "ns/step", "steps/s",
+               "cycles", "instrs", "br-miss", "cache-miss");
+        if (base) {
+            printf(" %10s %8s", "baseline", "change");
+        }
+        putchar('\n');
+        for (int i = 0; i < nresults; ++i) {
+            const struct result * const q = results + i;
+            printf("%-14s %10.3f %12.4g", q->name, q->ns, 1e9 / q->ns);
+            for (int k = 0; k < NCOUNTERS; ++k) {
+                printf(" %10.3g", q->counter[k]);
+            }
+            if (base) {
+                printf(" %10.3f %+7.1f%%%s", q->baseline,
+                       100*(q->ns / q->baseline - 1),
+                       q->regressed ? " REGRESSION" : "");
+            }
+            putchar('\n');
+        }
+        if (isfinite(overhead)) {
+            printf("# trace overhead %.3f ns/step, budget %g%s\n",
+                   overhead, budget, overhead > budget ? " EXCEEDED" : "");
+        }
+    }
+
+    if (base) {
+        fclose(base);
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -27,6 +27,18 @@ extern
 struct helm_state *
 helm_approach(struct helm_state * const h);
 
+extern
+double
+helm_steady_terms(const struct helm_state * const h,
+                  const double dt,
+                  const double r,
+                  const double u,
+                  const double v,
+                  const double y,
+                  double * const a,
+                  double * const df,
+                  double * const dy);
+
 extern
 double
 helm_steady(struct helm_state * const h,
@@ -35,3 +47,84 @@ helm_steady(struct helm_state * const h,
             const double u,
             const double v,
             const double y);
+
+extern
+struct helm_compiled
+helm_compile(const struct helm_state * const h,
+             const double dt);
+
+extern
+double
+helm_steady_compiled(struct helm_state * const h,
+                     struct helm_compiled * const c,
+                     const double dt,
+                     const double r,
+                     const double u,
+                     const double v,
+                     const double y);
+
+extern
+struct helm_statef *
+helm_resetf(struct helm_statef * const h);
+
+extern
+struct helm_statef *
+helm_approachf(struct helm_statef * const h);
+
+extern
+float
+helm_steady_termsf(const struct helm_statef * const h,
+                   const float dt,
+                   const float r,
+                   const float u,
+                   const float v,
+                   const float y,
+                   float * const a,
+                   float * const df,
+                   float * const dy);
+
+extern
+float
+helm_steadyf(struct helm_statef * const h,
+             const float dt,
+             const float r,
+             const float u,
+             const float v,
+             const float y);
+
+extern
+struct helm_compiledf
+helm_compilef(const struct helm_statef * const h,
+              const float dt);
+
+extern
+float
+helm_steady_compiledf(struct helm_statef * const h,
+                      struct helm_compiledf * const c,
+                      const float dt,
+                      const float r,
+                      const float u,
+                      const float v,
+                      const float y);
+
+extern
+struct helm_state *
+helm_steady_series(struct helm_state * const h,
+                   const size_t n,
+                   const double * const dt,
+                   const double * const r,
+                   const double * const u,
+                   double * const v,
+                   const double * const y,
+                   const unsigned flags);
+
+extern
+struct helm_statef *
+helm_steady_seriesf(struct helm_statef * const h,
+                    const size_t n,
+                    const float * const dt,
+                    const float * const r,
+                    const float * const u,
+                    float * const v,
+                    const float * const y,
+                    const unsigned flags);
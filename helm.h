@@ -13,6 +13,7 @@
 
 #include <assert.h>
 #include <math.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -127,6 +128,11 @@ extern "C" {
  * needs only to track two pieces of state, namely \f$f(t_{i-1})\f$ and
  * \f$y(t_{i-1})\f$, across time steps.
  *
+ * Every type and function is available in double precision, e.g. helm_state
+ * and helm_steady(), as well as in single precision with an \c f suffix,
+ * e.g. \c helm_statef and \c helm_steadyf().  Both are generated from the
+ * one definition within \ref helm_real.h.
+ *
  * Sample written with nomenclature from helm_state and helm_steady():
  * \code
  *   struct helm_state h;
@@ -163,122 +169,26 @@ extern "C" {
  * \endcode
  */
 
-/**
- * Tuning parameters and internal state for an incremental PID controller.
- *
- * Gain #kp has units of \f$u_0 / y_0\f$ where \f$u_0\f$ and \f$y_0\f$
- * are the natural actuator and process observable signals, respectively.
- * Parameter #Tt has units of time multiplied by \f$u_0 / y_0\f$.
- * Parameters #Td, #Tf, and #Ti possess units of time.  Time units are
- * fixed by the scaling provided in the \c dt argument to helm_steady().
- */
-struct helm_state
+/** Flags modifying the behavior of helm_steady_series(). */
+enum helm_series_flags
 {
-    double kp;  /**< Proportional gain modifying P, I, and D terms.    */
-    double Td;  /**< Time scale governing derivative action.
-                     Set to zero to disable derivative control.        */
-    double Tf;  /**< Time scale filtering process observable for D.
-                     Set to infinity to disable observable filtering.  */
-    double Ti;  /**< Time scale governing integral action.
-                     Set to infinity to disable integral control.      */
-    double Tt;  /**< Time scale governing automatic reset.
-                     Set to infinity to disable automatic reset.       */
-    double y;   /**< Internal tracking of the process observable.      */
-    double f;   /**< Internal tracking the filtered process.           */
+    HELM_SERIES_DT_CONSTANT = 1,  /**< Use \c dt[0] for every sample.     */
+    HELM_SERIES_ACCUMULATE  = 2   /**< Output accumulated \c v not \c dv. */
 };
 
-/**
- * \brief Reset all tuning parameters, but \e not transient state.
- *
- * Resets gain to one and disables filtering, integral action, and derivative
- * action.  Enable those terms by setting their associated time scales.
- *
- * \param[in,out] h Houses tuning parameters to be reset.
- * \return Argument \c h to permit call chaining.
- */
-static inline
-struct helm_state *
-helm_reset(struct helm_state * const h)
-{
-    h->kp = 1;        // Unit gain
-    h->Td = 0;        // No derivative action
-    h->Tf = INFINITY; // No filtering
-    h->Ti = INFINITY; // No integral action
-    h->Tt = INFINITY; // No automatic reset
-    return h;
-}
-
-/**
- * \brief Reset any transient state, but \e not tuning parameters.
- *
- * Necessary to achieve bumpless manual-to-automatic transitions
- * before calling to helm_steady() after a period of manual control,
- * including \e before the first call to helm_steady().
- *
- * \param[in,out] h Houses transient state to be reset.
- * \return Argument \c h to permit call chaining.
- */
-static inline
-struct helm_state *
-helm_approach(struct helm_state * const h)
-{
-    assert(h->Td >= 0);
-    assert(h->Tf >  0);
-    assert(h->Ti >  0);
-    assert(h->Tt >  0);
-    h->y = NAN;
-    h->f = NAN;
-    return h;
-}
-
-/**
- * \brief Find the control signal necessary to steady unsteady process y(t).
- *
- * \param[in,out] h  Tuning parameters and state maintained across invocations.
- * \param[in]     dt Time since last samples collected.
- * \param[in]     r  Reference value, often called the "setpoint".
- * \param[in]     u  Actuator signal currently observed.
- * \param[in]     v  Actuator signal currently requested.
- * \param[in]     y  Observed process output to drive to \c r.
- *
- * \return Incremental suggested change to control signal \c v.
- * \see Overview of \ref helm.h for the discrete evolution equations.
- */
-static inline
-double
-helm_steady(struct helm_state * const h,
-            const double dt,
-            const double r,
-            const double u,
-            const double v,
-            const double y)
-{
-    double dv = 0;
-
-    if (!isnan(y)) {                      // Avoid driving blind
-
-        if (isnan(h->f)) {                // Avoid startup kick
-            h->y = y;
-            h->f = y;
-        }
-
-        double a, df, dy;
-        a   = dt / (h->Tf + dt);          // Convex combination parameter alpha
-        df  = a*(y - h->f);               // Filtered difference for y
-        dy  =    y - h->y ;               // Backward difference for y
-        dv += (r - y) / h->Ti;            // Action from integral control
-        dv += (u - v) / h->Tt;            // Action from automatic reset
-        dv *= dt;                         // Scale integral actions by time step
-        dv += (h->Td / h->Tf)*(df - dy);  // Action from derivative control
-        dv += /*dr=0*/ - dy;              // Action from proporational control
-        dv *= h->kp;                      // Scale by unified gain parameter
-
-        h->y  = y;                        // Update observable for next call
-        h->f += df;                       // Update filter for next call
-    }
+// Double precision: struct helm_state, helm_steady(), etc.
+#define HELM_REAL    double
+#define HELM_NAME(x) x
+#include "helm_real.h"
+#undef  HELM_NAME
+#undef  HELM_REAL
 
-    return dv;
-}
+// Single precision: struct helm_statef, helm_steadyf(), etc.
+#define HELM_REAL    float
+#define HELM_NAME(x) x ## f
+#include "helm_real.h"
+#undef  HELM_NAME
+#undef  HELM_REAL
 
 #ifdef __cplusplus
 } /* extern "C" */
@@ -0,0 +1,263 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_HPP
+#define HELM_HPP
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "helm.h"
+
+/**
+ * \file
+ * A header-only C++11 controller template specialized on its enabled terms.
+ *
+ * Within \ref helm.h, helm_reset() disables terms at runtime by setting
+ * \c Td to zero and \c Ti and \c Tt to infinity.  helm_steady() nonetheless
+ * divides by those infinities and multiplies by those zeros on every call.
+ * Here the enabled terms are a template parameter so that disabled terms
+ * vanish at compile time:
+ * \code
+ *   constexpr auto pi = helm::controller<helm::Terms::PI>::from_gains(kp, ki);
+ *   auto h = pi;
+ *   h.approach();
+ *   for (;;) {
+ *      y  = process(dt, u);
+ *      v += h.steady(dt, r, u, v, y);
+ *      u  = actuate(dt, v);
+ *   }
+ * \endcode
+ *
+ * For the enabled terms, helm::controller::steady() performs the same
+ * operations in the same order as helm_steady() and therefore returns the
+ * same result up to the sign of a zero.  Interoperation with helm_state and
+ * helm_statef is provided by converting constructors along with
+ * helm::controller::state() and helm::controller::statef().
+ */
+
+namespace helm {
+
+/**
+ * Terms enabled within a helm::controller.  Proportional action is always
+ * present.  Letter \c I denotes integral action, \c D denotes derivative
+ * action, and \c T denotes automatic reset with time scale \c Tt.
+ */
+enum class Terms : unsigned
+{
+    P    = 0,          ///< Proportional only
+    I    = 1,          ///< Bit flag for integral action
+    D    = 2,          ///< Bit flag for derivative action
+    T    = 4,          ///< Bit flag for automatic reset
+    PI   = I,          ///< Proportional-integral
+    PD   = D,          ///< Proportional-derivative
+    PID  = I | D,      ///< Proportional-integral-derivative
+    PIT  = I | T,      ///< Proportional-integral with automatic reset
+    PIDT = I | D | T   ///< Proportional-integral-derivative with automatic reset
+};
+
+/** Is flag \c t enabled within \c terms? */
+constexpr bool has(Terms terms, Terms t)
+{
+    return (static_cast<unsigned>(terms) & static_cast<unsigned>(t)) != 0;
+}
+
+/**
+ * Tuning parameters and internal state for an incremental PID controller
+ * whose disabled terms are eliminated at compile time.
+ *
+ * Members carry the same meaning as those within helm_state.  Parameters
+ * for disabled terms are retained, at their helm_reset() values, only so
+ * that conversion to and from helm_state is lossless.
+ *
+ * \tparam terms Enabled terms.
+ * \tparam Real  Floating point type for parameters and state.
+ */
+template <Terms terms, typename Real = double>
+struct controller
+{
+    static constexpr bool integral   = has(terms, Terms::I); ///< Has I?
+    static constexpr bool derivative = has(terms, Terms::D); ///< Has D?
+    static constexpr bool reset      = has(terms, Terms::T); ///< Has reset?
+
+    Real kp;  ///< Proportional gain modifying P, I, and D terms.
+    Real Td;  ///< Time scale governing derivative action.
+    Real Tf;  ///< Time scale filtering process observable for D.
+    Real Ti;  ///< Time scale governing integral action.
+    Real Tt;  ///< Time scale governing automatic reset.
+    Real y;   ///< Internal tracking of the process observable.
+    Real f;   ///< Internal tracking the filtered process.
+
+    /** Construct with the given tuning, awaiting approach(). */
+    constexpr explicit
+    controller(Real kp = 1,
+               Real Td = 0,
+               Real Tf = std::numeric_limits<Real>::infinity(),
+               Real Ti = std::numeric_limits<Real>::infinity(),
+               Real Tt = std::numeric_limits<Real>::infinity())
+        : kp(kp)
+        , Td(derivative ? Td : Real(0))
+        , Tf(Tf)
+        , Ti(integral ? Ti : std::numeric_limits<Real>::infinity())
+        , Tt(reset    ? Tt : std::numeric_limits<Real>::infinity())
+        , y(std::numeric_limits<Real>::quiet_NaN())
+        , f(std::numeric_limits<Real>::quiet_NaN())
+    {}
+
+    /**
+     * Construct from commonly given parallel-form gains \c kp, \c ki, \c kd,
+     * and \c kt following the sample within \ref helm.h.  Gains for
+     * disabled terms are ignored.
+     */
+    static constexpr
+    controller
+    from_gains(Real kp,
+               Real ki = 0,
+               Real kd = 0,
+               Real Tf = std::numeric_limits<Real>::infinity(),
+               Real kt = 0)
+    {
+        return controller(kp,
+                          derivative ? kd / kp : Real(0),
+                          Tf,
+                          integral   ? kp / ki : Real(0),
+                          reset      ? kp / kt : Real(0));
+    }
+
+    /**
+     * Construct from tuning and transient state within \c h.  Parameters
+     * for disabled terms are replaced by their helm_reset() values.
+     */
+    explicit
+    controller(const helm_state& h)
+        : kp(static_cast<Real>(h.kp))
+        , Td(derivative ? static_cast<Real>(h.Td) : Real(0))
+        , Tf(static_cast<Real>(h.Tf))
+        , Ti(integral ? static_cast<Real>(h.Ti)
+                      : std::numeric_limits<Real>::infinity())
+        , Tt(reset    ? static_cast<Real>(h.Tt)
+                      : std::numeric_limits<Real>::infinity())
+        , y (static_cast<Real>(h.y ))
+        , f (static_cast<Real>(h.f ))
+    {}
+
+    /** \copydoc controller(const helm_state&) */
+    explicit
+    controller(const helm_statef& h)
+        : kp(static_cast<Real>(h.kp))
+        , Td(derivative ? static_cast<Real>(h.Td) : Real(0))
+        , Tf(static_cast<Real>(h.Tf))
+        , Ti(integral ? static_cast<Real>(h.Ti)
+                      : std::numeric_limits<Real>::infinity())
+        , Tt(reset    ? static_cast<Real>(h.Tt)
+                      : std::numeric_limits<Real>::infinity())
+        , y (static_cast<Real>(h.y ))
+        , f (static_cast<Real>(h.f ))
+    {}
+
+    /**
+     * Obtain a helm_state with equivalent tuning and transient state.  When
+     * derivative action is disabled the filter is not evolved and member
+     * #f tracks #y, which is immaterial to helm_steady() in that case.
+     */
+    helm_state
+    state() const
+    {
+        helm_state h;
+        h.kp = kp;
+        h.Td = derivative ? Td : 0;
+        h.Tf = Tf;
+        h.Ti = integral   ? Ti : INFINITY;
+        h.Tt = reset      ? Tt : INFINITY;
+        h.y  = y;
+        h.f  = f;
+        return h;
+    }
+
+    /** Obtain a helm_statef as by state(). */
+    helm_statef
+    statef() const
+    {
+        helm_statef h;
+        h.kp = static_cast<float>(kp);
+        h.Td = derivative ? static_cast<float>(Td) : 0;
+        h.Tf = static_cast<float>(Tf);
+        h.Ti = integral   ? static_cast<float>(Ti) : INFINITY;
+        h.Tt = reset      ? static_cast<float>(Tt) : INFINITY;
+        h.y  = static_cast<float>(y);
+        h.f  = static_cast<float>(f);
+        return h;
+    }
+
+    /** \copydoc helm_approach() */
+    controller&
+    approach()
+    {
+        assert(!derivative || Td >= 0);
+        assert(!derivative || Tf >  0);
+        assert(!integral   || Ti >  0);
+        assert(!reset      || Tt >  0);
+        y = std::numeric_limits<Real>::quiet_NaN();
+        f = std::numeric_limits<Real>::quiet_NaN();
+        return *this;
+    }
+
+    /**
+     * \brief Find the control signal necessary to steady unsteady process.
+     * \copydetails helm_steady()
+     */
+    Real
+    steady(const Real dt,
+           const Real r,
+           const Real u,
+           const Real v,
+           const Real y)
+    {
+        Real dv = 0;
+
+        if (!std::isnan(y)) {                     // Avoid driving blind
+
+            if (std::isnan(this->f)) {            // Avoid startup kick
+                this->y = y;
+                this->f = y;
+            }
+
+            const Real dy = y - this->y;          // Backward difference for y
+            if (integral) {
+                dv += (r - y) / Ti;               // Action from integral control
+            }
+            if (reset) {
+                dv += (u - v) / Tt;               // Action from automatic reset
+            }
+            if (integral || reset) {
+                dv *= dt;                         // Scale integral actions
+            }
+            if (derivative) {
+                const Real a  = dt / (Tf + dt);   // Convex combination alpha
+                const Real df = a*(y - this->f);  // Filtered difference for y
+                dv += (Td / Tf)*(df - dy);        // Action from derivative
+                this->f += df;                    // Update filter
+            } else {
+                this->f  = y;                     // Filter unused
+            }
+            dv += /*dr=0*/ - dy;                  // Action from proportional
+            dv *= kp;                             // Scale by unified gain
+
+            this->y = y;                          // Update observable
+        }
+
+        return dv;
+    }
+};
+
+} // namespace helm
+
+#endif /* HELM_HPP */
@@ -0,0 +1,57 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_bank.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_bank.h"
+
+extern
+size_t
+helm_bank_bytes(const size_t n);
+
+extern
+struct helm_bank *
+helm_bank_init(struct helm_bank * const b,
+               const size_t n,
+               void * const mem);
+
+extern
+struct helm_bank *
+helm_bank_reset(struct helm_bank * const b);
+
+extern
+struct helm_bank *
+helm_bank_approach(struct helm_bank * const b);
+
+extern
+struct helm_bank *
+helm_bank_set(struct helm_bank * const b,
+              const size_t i,
+              const struct helm_state * const h);
+
+extern
+struct helm_state *
+helm_bank_get(const struct helm_bank * const b,
+              const size_t i,
+              struct helm_state * const h);
+
+extern
+struct helm_bank *
+helm_bank_steady(struct helm_bank * const b,
+                 const double * const dt,
+                 const double * const r,
+                 const double * const u,
+                 const double * const v,
+                 const double * const y,
+                 double * const dv);
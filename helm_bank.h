@@ -0,0 +1,457 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_BANK_H
+#define HELM_BANK_H
+
+#include <stddef.h>
+
+#include "helm.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HELM_BANK_X86 1  ///< SSE2/AVX2/AVX-512 kernels with runtime dispatch
+#else
+#define HELM_BANK_X86 0  ///< Portable scalar kernel only
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * A structure-of-arrays bank of independent controllers sharing the update
+ * equations of helm_steady().
+ *
+ * Where many loops are advanced together, storing each tuning parameter and
+ * each piece of transient state as a contiguous array permits advancing every
+ * controller within one call.  Kernel helm_bank_steady() evaluates exactly
+ * the same floating point operations in exactly the same order as
+ * helm_steady() so results are bit-identical lane by lane.  The two data
+ * dependent branches within helm_steady(), namely \c isnan(y) and \c
+ * isnan(h->f), become lane masks.  On x86 hardware SSE2, AVX2, and AVX-512
+ * variants are selected at runtime according to processor support.
+ *
+ * Bit-identical results require that the compiler not contract multiplies
+ * and adds into fused multiply-adds.  ISO C modes like \c -std=c99 disable
+ * contraction by default whereas GNU modes require \c -ffp-contract=off.
+ *
+ * Sample usage with caller-provided storage:
+ * \code
+ *   struct helm_bank b;
+ *   void * const mem = malloc(helm_bank_bytes(n));
+ *   helm_bank_init(&b, n, mem);
+ *   helm_bank_reset(&b);
+ *   for (size_t i = 0; i < n; ++i) {
+ *       b.kp[i] = kp[i];
+ *       b.Ti[i] = b.kp[i] / ki[i];
+ *   }
+ *   helm_bank_approach(&b);
+ *   for (;;) {
+ *       helm_bank_steady(&b, dt, r, u, v, y, dv);
+ *       // ...apply each dv[i] to v[i]...
+ *   }
+ * \endcode
+ */
+
+/**
+ * Tuning parameters and internal state for a bank of incremental PID
+ * controllers stored as parallel arrays.  Lane \c i of each array carries
+ * the same meaning as the like-named member of helm_state.
+ */
+struct helm_bank
+{
+    size_t  n;   /**< Number of controllers within the bank.            */
+    double *kp;  /**< Proportional gains modifying P, I, and D terms.   */
+    double *Td;  /**< Time scales governing derivative action.          */
+    double *Tf;  /**< Time scales filtering process observables for D.  */
+    double *Ti;  /**< Time scales governing integral action.            */
+    double *Tt;  /**< Time scales governing automatic reset.            */
+    double *y;   /**< Internal tracking of the process observables.     */
+    double *f;   /**< Internal tracking the filtered processes.         */
+};
+
+/** Alignment and padding, in bytes, applied to each array of a helm_bank. */
+#define HELM_BANK_ALIGN 64
+
+/**
+ * \brief Bytes of storage required by helm_bank_init() for \c n controllers.
+ *
+ * Each of the seven arrays is padded to a multiple of #HELM_BANK_ALIGN bytes.
+ */
+static inline
+size_t
+helm_bank_bytes(const size_t n)
+{
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    return 7 * ((n + per - 1) / per) * per * sizeof(double);
+}
+
+/**
+ * \brief Carve the arrays of \c b from caller-provided storage.
+ *
+ * When \c mem is aligned to #HELM_BANK_ALIGN bytes so is every array.
+ * No tuning parameters or state are set.
+ *
+ * \param[out] b   Bank to be initialized.
+ * \param[in]  n   Number of controllers within the bank.
+ * \param[in]  mem At least helm_bank_bytes(n) bytes of storage.
+ * \return Argument \c b to permit call chaining.
+ */
+static inline
+struct helm_bank *
+helm_bank_init(struct helm_bank * const b,
+               const size_t n,
+               void * const mem)
+{
+    const size_t per    = HELM_BANK_ALIGN / sizeof(double);
+    const size_t stride = ((n + per - 1) / per) * per;
+    double * const p    = (double *) mem;
+    b->n  = n;
+    b->kp = p + 0*stride;
+    b->Td = p + 1*stride;
+    b->Tf = p + 2*stride;
+    b->Ti = p + 3*stride;
+    b->Tt = p + 4*stride;
+    b->y  = p + 5*stride;
+    b->f  = p + 6*stride;
+    return b;
+}
+
+/**
+ * \brief Reset all tuning parameters, but \e not transient state.
+ * \see helm_reset() for the per-controller semantics.
+ */
+static inline
+struct helm_bank *
+helm_bank_reset(struct helm_bank * const b)
+{
+    for (size_t i = 0; i < b->n; ++i) {
+        b->kp[i] = 1;
+        b->Td[i] = 0;
+        b->Tf[i] = INFINITY;
+        b->Ti[i] = INFINITY;
+        b->Tt[i] = INFINITY;
+    }
+    return b;
+}
+
+/**
+ * \brief Reset any transient state, but \e not tuning parameters.
+ * \see helm_approach() for the per-controller semantics.
+ */
+static inline
+struct helm_bank *
+helm_bank_approach(struct helm_bank * const b)
+{
+    for (size_t i = 0; i < b->n; ++i) {
+        assert(b->Td[i] >= 0);
+        assert(b->Tf[i] >  0);
+        assert(b->Ti[i] >  0);
+        assert(b->Tt[i] >  0);
+        b->y[i] = NAN;
+        b->f[i] = NAN;
+    }
+    return b;
+}
+
+/**
+ * \brief Copy controller \c h into lane \c i of bank \c b.
+ * \return Argument \c b to permit call chaining.
+ */
+static inline
+struct helm_bank *
+helm_bank_set(struct helm_bank * const b,
+              const size_t i,
+              const struct helm_state * const h)
+{
+    assert(i < b->n);
+    b->kp[i] = h->kp;
+    b->Td[i] = h->Td;
+    b->Tf[i] = h->Tf;
+    b->Ti[i] = h->Ti;
+    b->Tt[i] = h->Tt;
+    b->y [i] = h->y;
+    b->f [i] = h->f;
+    return b;
+}
+
+/**
+ * \brief Copy lane \c i of bank \c b into controller \c h.
+ * \return Argument \c h to permit call chaining.
+ */
+static inline
+struct helm_state *
+helm_bank_get(const struct helm_bank * const b,
+              const size_t i,
+              struct helm_state * const h)
+{
+    assert(i < b->n);
+    h->kp = b->kp[i];
+    h->Td = b->Td[i];
+    h->Tf = b->Tf[i];
+    h->Ti = b->Ti[i];
+    h->Tt = b->Tt[i];
+    h->y  = b->y [i];
+    h->f  = b->f [i];
+    return h;
+}
+
+/**
+ * \brief Portable kernel advancing lanes <tt>[begin, end)</tt> of \c b.
+ *
+ * Structured as helm_steady() with each branch replaced by a selection so
+ * that the vectorized variants can mirror it operation for operation.
+ */
+static inline
+void
+helm_bank_steady_scalar(struct helm_bank * const b,
+                        const size_t begin,
+                        const size_t end,
+                        const double * const dt,
+                        const double * const r,
+                        const double * const u,
+                        const double * const v,
+                        const double * const y,
+                        double * const dv)
+{
+    for (size_t i = begin; i < end; ++i) {
+        const int    skip = isnan(y[i]);           // Avoid driving blind
+        const int    kick = isnan(b->f[i]);        // Avoid startup kick
+        const double hy   = kick ? y[i] : b->y[i];
+        const double hf   = kick ? y[i] : b->f[i];
+
+        double a, df, dy, d = 0;
+        a  = dt[i] / (b->Tf[i] + dt[i]);
+        df = a*(y[i] - hf);
+        dy =    y[i] - hy ;
+        d += (r[i] - y[i]) / b->Ti[i];
+        d += (u[i] - v[i]) / b->Tt[i];
+        d *= dt[i];
+        d += (b->Td[i] / b->Tf[i])*(df - dy);
+        d += - dy;
+        d *= b->kp[i];
+
+        dv  [i] = skip ? 0       : d;
+        b->y[i] = skip ? b->y[i] : y[i];
+        b->f[i] = skip ? b->f[i] : hf + df;
+    }
+}
+
+#if HELM_BANK_X86
+
+/** \brief SSE2 kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+__attribute__((target("sse2")))
+static inline
+size_t
+helm_bank_steady_sse2(struct helm_bank * const b,
+                      const size_t begin,
+                      const size_t end,
+                      const double * const dt,
+                      const double * const r,
+                      const double * const u,
+                      const double * const v,
+                      const double * const y,
+                      double * const dv)
+{
+    const __m128d zero = _mm_setzero_pd();
+    size_t i = begin;
+    for (; i + 2 <= end; i += 2) {
+        const __m128d Y   = _mm_loadu_pd(y + i);
+        const __m128d DT  = _mm_loadu_pd(dt + i);
+        const __m128d Tf  = _mm_loadu_pd(b->Tf + i);
+        const __m128d oy  = _mm_loadu_pd(b->y  + i);
+        const __m128d of  = _mm_loadu_pd(b->f  + i);
+        const __m128d skip = _mm_cmpunord_pd(Y,  Y);
+        const __m128d kick = _mm_cmpunord_pd(of, of);
+        const __m128d hy = _mm_or_pd(_mm_and_pd(kick, Y),
+                                     _mm_andnot_pd(kick, oy));
+        const __m128d hf = _mm_or_pd(_mm_and_pd(kick, Y),
+                                     _mm_andnot_pd(kick, of));
+
+        const __m128d a  = _mm_div_pd(DT, _mm_add_pd(Tf, DT));
+        const __m128d df = _mm_mul_pd(a, _mm_sub_pd(Y, hf));
+        const __m128d dy = _mm_sub_pd(Y, hy);
+        __m128d d = zero;
+        d = _mm_add_pd(d, _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(r + i), Y),
+                                     _mm_loadu_pd(b->Ti + i)));
+        d = _mm_add_pd(d, _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(u + i),
+                                                _mm_loadu_pd(v + i)),
+                                     _mm_loadu_pd(b->Tt + i)));
+        d = _mm_mul_pd(d, DT);
+        d = _mm_add_pd(d, _mm_mul_pd(_mm_div_pd(_mm_loadu_pd(b->Td + i), Tf),
+                                     _mm_sub_pd(df, dy)));
+        d = _mm_sub_pd(d, dy);
+        d = _mm_mul_pd(d, _mm_loadu_pd(b->kp + i));
+
+        _mm_storeu_pd(dv   + i, _mm_andnot_pd(skip, d));
+        _mm_storeu_pd(b->y + i, _mm_or_pd(_mm_and_pd(skip, oy),
+                                          _mm_andnot_pd(skip, Y)));
+        _mm_storeu_pd(b->f + i, _mm_or_pd(_mm_and_pd(skip, of),
+                                          _mm_andnot_pd(skip,
+                                              _mm_add_pd(hf, df))));
+    }
+    return i;
+}
+
+/** \brief AVX2 kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+__attribute__((target("avx2")))
+static inline
+size_t
+helm_bank_steady_avx2(struct helm_bank * const b,
+                      const size_t begin,
+                      const size_t end,
+                      const double * const dt,
+                      const double * const r,
+                      const double * const u,
+                      const double * const v,
+                      const double * const y,
+                      double * const dv)
+{
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m256d Y   = _mm256_loadu_pd(y + i);
+        const __m256d DT  = _mm256_loadu_pd(dt + i);
+        const __m256d Tf  = _mm256_loadu_pd(b->Tf + i);
+        const __m256d oy  = _mm256_loadu_pd(b->y  + i);
+        const __m256d of  = _mm256_loadu_pd(b->f  + i);
+        const __m256d skip = _mm256_cmp_pd(Y,  Y,  _CMP_UNORD_Q);
+        const __m256d kick = _mm256_cmp_pd(of, of, _CMP_UNORD_Q);
+        const __m256d hy = _mm256_blendv_pd(oy, Y, kick);
+        const __m256d hf = _mm256_blendv_pd(of, Y, kick);
+
+        const __m256d a  = _mm256_div_pd(DT, _mm256_add_pd(Tf, DT));
+        const __m256d df = _mm256_mul_pd(a, _mm256_sub_pd(Y, hf));
+        const __m256d dy = _mm256_sub_pd(Y, hy);
+        __m256d d = zero;
+        d = _mm256_add_pd(d, _mm256_div_pd(
+                _mm256_sub_pd(_mm256_loadu_pd(r + i), Y),
+                _mm256_loadu_pd(b->Ti + i)));
+        d = _mm256_add_pd(d, _mm256_div_pd(
+                _mm256_sub_pd(_mm256_loadu_pd(u + i), _mm256_loadu_pd(v + i)),
+                _mm256_loadu_pd(b->Tt + i)));
+        d = _mm256_mul_pd(d, DT);
+        d = _mm256_add_pd(d, _mm256_mul_pd(
+                _mm256_div_pd(_mm256_loadu_pd(b->Td + i), Tf),
+                _mm256_sub_pd(df, dy)));
+        d = _mm256_sub_pd(d, dy);
+        d = _mm256_mul_pd(d, _mm256_loadu_pd(b->kp + i));
+
+        _mm256_storeu_pd(dv   + i, _mm256_blendv_pd(d, zero, skip));
+        _mm256_storeu_pd(b->y + i, _mm256_blendv_pd(Y, oy, skip));
+        _mm256_storeu_pd(b->f + i, _mm256_blendv_pd(_mm256_add_pd(hf, df),
+                                                    of, skip));
+    }
+    return i;
+}
+
+/** \brief AVX-512 kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+__attribute__((target("avx512f")))
+static inline
+size_t
+helm_bank_steady_avx512(struct helm_bank * const b,
+                        const size_t begin,
+                        const size_t end,
+                        const double * const dt,
+                        const double * const r,
+                        const double * const u,
+                        const double * const v,
+                        const double * const y,
+                        double * const dv)
+{
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m512d Y   = _mm512_loadu_pd(y + i);
+        const __m512d DT  = _mm512_loadu_pd(dt + i);
+        const __m512d Tf  = _mm512_loadu_pd(b->Tf + i);
+        const __m512d oy  = _mm512_loadu_pd(b->y  + i);
+        const __m512d of  = _mm512_loadu_pd(b->f  + i);
+        const __mmask8 skip = _mm512_cmp_pd_mask(Y,  Y,  _CMP_UNORD_Q);
+        const __mmask8 kick = _mm512_cmp_pd_mask(of, of, _CMP_UNORD_Q);
+        const __m512d hy = _mm512_mask_blend_pd(kick, oy, Y);
+        const __m512d hf = _mm512_mask_blend_pd(kick, of, Y);
+
+        const __m512d a  = _mm512_div_pd(DT, _mm512_add_pd(Tf, DT));
+        const __m512d df = _mm512_mul_pd(a, _mm512_sub_pd(Y, hf));
+        const __m512d dy = _mm512_sub_pd(Y, hy);
+        __m512d d = zero;
+        d = _mm512_add_pd(d, _mm512_div_pd(
+                _mm512_sub_pd(_mm512_loadu_pd(r + i), Y),
+                _mm512_loadu_pd(b->Ti + i)));
+        d = _mm512_add_pd(d, _mm512_div_pd(
+                _mm512_sub_pd(_mm512_loadu_pd(u + i), _mm512_loadu_pd(v + i)),
+                _mm512_loadu_pd(b->Tt + i)));
+        d = _mm512_mul_pd(d, DT);
+        d = _mm512_add_pd(d, _mm512_mul_pd(
+                _mm512_div_pd(_mm512_loadu_pd(b->Td + i), Tf),
+                _mm512_sub_pd(df, dy)));
+        d = _mm512_sub_pd(d, dy);
+        d = _mm512_mul_pd(d, _mm512_loadu_pd(b->kp + i));
+
+        _mm512_storeu_pd(dv   + i, _mm512_mask_blend_pd(skip, d, zero));
+        _mm512_storeu_pd(b->y + i, _mm512_mask_blend_pd(skip, Y, oy));
+        _mm512_storeu_pd(b->f + i, _mm512_mask_blend_pd(
+                skip, _mm512_add_pd(hf, df), of));
+    }
+    return i;
+}
+
+#endif /* HELM_BANK_X86 */
+
+/**
+ * \brief Find the control signals necessary to steady every process.
+ *
+ * Lane by lane, the result is bit-identical to invoking helm_steady() on each
+ * controller within the bank.  Arrays must not overlap those within \c b.
+ *
+ * \param[in,out] b  Tuning parameters and state maintained across invocations.
+ * \param[in]     dt Times since last samples collected.
+ * \param[in]     r  Reference values, often called "setpoints".
+ * \param[in]     u  Actuator signals currently observed.
+ * \param[in]     v  Actuator signals currently requested.
+ * \param[in]     y  Observed process outputs to drive to \c r.
+ * \param[out]    dv Incremental suggested changes to control signals \c v.
+ *                   May alias any one of \c dt, \c r, \c u, \c v, or \c y.
+ *
+ * \return Argument \c b to permit call chaining.
+ * \see helm_steady() for the single-controller semantics.
+ */
+static inline
+struct helm_bank *
+helm_bank_steady(struct helm_bank * const b,
+                 const double * const dt,
+                 const double * const r,
+                 const double * const u,
+                 const double * const v,
+                 const double * const y,
+                 double * const dv)
+{
+    size_t i = 0;
+#if HELM_BANK_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        i = helm_bank_steady_avx512(b, i, b->n, dt, r, u, v, y, dv);
+    } else if (__builtin_cpu_supports("avx2")) {
+        i = helm_bank_steady_avx2(b, i, b->n, dt, r, u, v, y, dv);
+    } else if (__builtin_cpu_supports("sse2")) {
+        i = helm_bank_steady_sse2(b, i, b->n, dt, r, u, v, y, dv);
+    }
+#endif
+    helm_bank_steady_scalar(b, i, b->n, dt, r, u, v, y, dv);
+    return b;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_BANK_H */
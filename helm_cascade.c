@@ -0,0 +1,45 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_cascade.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_cascade.h"
+
+extern
+size_t
+helm_cascade_stride(const size_t m);
+
+extern
+size_t
+helm_cascade_bytes(const size_t L,
+                   const size_t m);
+
+extern
+struct helm_cascade *
+helm_cascade_init(struct helm_cascade * const c,
+                  const size_t L,
+                  const size_t m,
+                  void * const mem);
+
+extern
+struct helm_cascade *
+helm_cascade_approach(struct helm_cascade * const c);
+
+extern
+struct helm_cascade *
+helm_cascade_steady(struct helm_cascade * const c,
+                    const double * const dt,
+                    const double * const r,
+                    const double * const u,
+                    const double * const * const y);
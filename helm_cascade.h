@@ -0,0 +1,242 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_CASCADE_H
+#define HELM_CASCADE_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "helm.h"
+#include "helm_bank.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Fused evaluation of cascaded and ratio-coupled controllers, batched across
+ * many independent cascades.
+ *
+ * A cascade chains levels \c 0 (outermost) through \c L-1 (innermost).
+ * The request \f$v_k\f$ of level \f$k\f$ scaled by ratio \f$g_{k+1}\f$
+ * becomes the reference of level \f$k+1\f$, i.e. \f$r_{k+1} = g_{k+1}
+ * v_k\f$, so that a unit ratio gives classic cascade control and other
+ * ratios give ratio control.  The innermost request drives the actuator.
+ *
+ * Each level of every cascade is a lane of one helm_bank, with all levels
+ * carved contiguously from a single allocation.  One call to
+ * helm_cascade_steady() walks blocks of #HELM_CASCADE_BLOCK cascades and,
+ * within each block, steps every level top-down through helm_bank_steady().
+ * A level's fresh request therefore reaches the next level's reference
+ * within the same pass while the block's working set stays in cache.
+ *
+ * Saturation propagates outward through automatic reset.  Level \f$L-1\f$
+ * is saturated whenever the observed actuator position differs from its
+ * request.  Level \f$k\f$ is saturated whenever level \f$k+1\f$ is.  An
+ * outer level whose inner level is saturated sees as its "actuator
+ * position" the reference the inner loop actually achieves, namely
+ * \f$y_{k+1} / g_{k+1}\f$, so that its \f$(u - v)/T_t\f$ term unwinds it
+ * exactly as helm_steady() unwinds a single saturated loop.  An outer level
+ * whose inner level tracks sees \f$u_k = v_k\f$ and no reset action.
+ * Unknown quantities likewise give no reset action.  A NaN actuator
+ * position is treated as tracking rather than saturated, and an outer level
+ * whose inner observable is NaN or whose ratio is zero sees its own request,
+ * so that one bad sample cannot permanently wind every outer level to NaN.
+ *
+ * Sample usage with caller-provided storage for \c m two-level cascades:
+ * \code
+ *   struct helm_cascade c;
+ *   helm_cascade_init(&c, 2, m, malloc(helm_cascade_bytes(2, m)));
+ *   for (size_t i = 0; i < m; ++i) {
+ *       helm_bank_set(&c.level[0], i, &outer[i]);
+ *       helm_bank_set(&c.level[1], i, &inner[i]);
+ *   }
+ *   helm_cascade_approach(&c);
+ *   const double *y[2] = { y_outer, y_inner };
+ *   for (;;) {
+ *       helm_cascade_steady(&c, dt, r, u, y);
+ *       // ...actuate each c.v[1][i], observing positions into u[i]...
+ *   }
+ * \endcode
+ */
+
+/** Maximum number of levels within one cascade. */
+#define HELM_CASCADE_MAX 8
+
+/** Cascades processed together by each level within one block. */
+#define HELM_CASCADE_BLOCK 256
+
+/**
+ * A structure-of-arrays batch of \c m cascades each having \c L levels.
+ * Array \c X[k] holds quantity \c X of level \c k for every cascade.
+ */
+struct helm_cascade
+{
+    size_t           L;                        /**< Levels per cascade.    */
+    size_t           m;                        /**< Number of cascades.    */
+    struct helm_bank level[HELM_CASCADE_MAX];  /**< Controllers per level. */
+    double          *g [HELM_CASCADE_MAX];     /**< Ratios \f$g_k\f$, with
+                                                    \c g[0] unused.        */
+    double          *v [HELM_CASCADE_MAX];     /**< Requests \f$v_k\f$.    */
+    double          *r [HELM_CASCADE_MAX];     /**< Scratch references.    */
+    double          *u [HELM_CASCADE_MAX];     /**< Scratch positions.     */
+    double          *dv[HELM_CASCADE_MAX];     /**< Latest increments.     */
+};
+
+/** \brief Padded length of each array within a helm_cascade of \c m. */
+static inline
+size_t
+helm_cascade_stride(const size_t m)
+{
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    return ((m + per - 1) / per) * per;
+}
+
+/** \brief Bytes of storage required by helm_cascade_init(). */
+static inline
+size_t
+helm_cascade_bytes(const size_t L,
+                   const size_t m)
+{
+    return L * (helm_bank_bytes(m)
+                + 5 * helm_cascade_stride(m) * sizeof(double));
+}
+
+/**
+ * \brief Carve \c L levels for \c m cascades from caller-provided storage.
+ *
+ * Every level is reset per helm_bank_reset(), every ratio is one, and every
+ * request is zero.  Each level's bank is followed immediately by its ratio,
+ * request, and scratch arrays.
+ *
+ * \param[out] c   Batch to be initialized.
+ * \param[in]  L   Levels per cascade, at most #HELM_CASCADE_MAX.
+ * \param[in]  m   Number of cascades.
+ * \param[in]  mem At least helm_cascade_bytes(L, m) bytes of storage.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+struct helm_cascade *
+helm_cascade_init(struct helm_cascade * const c,
+                  const size_t L,
+                  const size_t m,
+                  void * const mem)
+{
+    assert(L >= 1 && L <= HELM_CASCADE_MAX);
+    const size_t stride = helm_cascade_stride(m);
+    char * p = (char *) mem;
+    c->L = L;
+    c->m = m;
+    for (size_t k = 0; k < L; ++k) {
+        helm_bank_init(&c->level[k], m, p);
+        helm_bank_reset(&c->level[k]);
+        p += helm_bank_bytes(m);
+        double * const q = (double *) p;
+        c->g [k] = q + 0*stride;
+        c->v [k] = q + 1*stride;
+        c->r [k] = q + 2*stride;
+        c->u [k] = q + 3*stride;
+        c->dv[k] = q + 4*stride;
+        p += 5 * stride * sizeof(double);
+        for (size_t i = 0; i < m; ++i) {
+            c->g [k][i] = 1;
+            c->v [k][i] = 0;
+            c->dv[k][i] = 0;
+        }
+    }
+    return c;
+}
+
+/**
+ * \brief Reset transient state of every level, but \e not tuning, ratios,
+ * or requests.
+ * \see helm_approach() for the per-controller semantics.
+ */
+static inline
+struct helm_cascade *
+helm_cascade_approach(struct helm_cascade * const c)
+{
+    for (size_t k = 0; k < c->L; ++k) {
+        helm_bank_approach(&c->level[k]);
+    }
+    return c;
+}
+
+/**
+ * \brief Advance every cascade by one fused top-down pass.
+ *
+ * On return \c c->v[L-1][i] holds the innermost request for cascade \c i
+ * and \c c->dv[k][i] the increment just applied to level \c k.
+ *
+ * \param[in,out] c  Batch of cascades.
+ * \param[in]     dt Time since previous call for each cascade.
+ * \param[in]     r  Outermost reference for each cascade.
+ * \param[in]     u  Observed actuator position for each cascade.
+ * \param[in]     y  Array of \c L arrays with \c y[k][i] the observable
+ *                   of level \c k within cascade \c i.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+struct helm_cascade *
+helm_cascade_steady(struct helm_cascade * const c,
+                    const double * const dt,
+                    const double * const r,
+                    const double * const u,
+                    const double * const * const y)
+{
+    const size_t L = c->L;
+    for (size_t b = 0; b < c->m; b += HELM_CASCADE_BLOCK) {
+        const size_t e = b + HELM_CASCADE_BLOCK < c->m
+                       ? b + HELM_CASCADE_BLOCK : c->m;
+
+        // Bottom-up: propagate saturation as effective actuator positions
+        for (size_t i = b; i < e; ++i) {
+            const int known = !isnan(u[i]);
+            const int sat   = known && u[i] != c->v[L-1][i];
+            c->u[L-1][i] = known ? u[i] : c->v[L-1][i];
+            for (size_t k = L - 1; k-- > 0;) {
+                const double yk = y[k+1][i], gk = c->g[k+1][i];
+                c->u[k][i] = sat && !isnan(yk) && gk != 0 ? yk / gk
+                                                         : c->v[k][i];
+            }
+        }
+
+        // Top-down: step each level then hand its request inward
+        for (size_t i = b; i < e; ++i) {
+            c->r[0][i] = r[i];
+        }
+        for (size_t k = 0; k < L; ++k) {
+            struct helm_bank view = c->level[k];
+            view.n   = e - b;
+            view.kp += b; view.Td += b; view.Tf += b; view.Ti += b;
+            view.Tt += b; view.y  += b; view.f  += b;
+            helm_bank_steady(&view, dt + b, c->r[k] + b, c->u[k] + b,
+                             c->v[k] + b, y[k] + b, c->dv[k] + b);
+            double * const v = c->v[k];
+            for (size_t i = b; i < e; ++i) {
+                v[i] += c->dv[k][i];
+            }
+            if (k + 1 < L) {
+                for (size_t i = b; i < e; ++i) {
+                    c->r[k+1][i] = c->g[k+1][i] * v[i];
+                }
+            }
+        }
+    }
+    return c;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_CASCADE_H */
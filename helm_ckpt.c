@@ -0,0 +1,403 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Mapping, restoring, and snapshotting for \ref helm_ckpt.h along with C99
+ * extern declarations for its static inline functions.
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "helm_ckpt.h"
+
+extern
+void
+helm_ckpt_begin(struct helm_ckpt * const c);
+
+extern
+void
+helm_ckpt_end(struct helm_ckpt * const c);
+
+extern
+struct helm_ckpt *
+helm_ckpt_steady(struct helm_ckpt * const c,
+                 const double * const dt,
+                 const double * const r,
+                 const double * const u,
+                 const double * const y,
+                 double * const dv);
+
+/** The bytes "helmckpt" read as a little-endian integer. */
+#define MAGIC UINT64_C(0x74706b636d6c6568)
+
+/** Layout version, incremented upon any incompatible change. */
+enum { VERSION = 1 };
+
+/** Bytes reserved for the header so that the payload is page aligned. */
+enum { HEADER = 4096 };
+
+/** Copies attempted by helm_ckpt_snapshot() before giving up. */
+enum { TRIES = 1000 };
+
+/**
+ * Start of every live file and snapshot, followed at offset #HEADER by the
+ * arrays of a helm_bank and then the requests \c v.  Snapshots share this
+ * layout so any snapshot may also be used as a live file.
+ */
+struct header
+{
+    uint64_t magic;     ///< Equal to MAGIC
+    uint32_t version;   ///< Equal to VERSION
+    uint32_t clean;     ///< Nonzero when durably written in full
+    uint64_t n;         ///< Number of lanes
+    uint64_t bytes;     ///< Total file length
+    uint64_t sum;       ///< Checksum of the payload within snapshots
+    char     boot[40];  ///< Kernel boot identifier when last opened
+    uint64_t seq __attribute__((aligned(64)));  ///< See helm_ckpt::seq
+};
+
+/** Total file length holding \c n lanes. */
+static
+size_t
+length(const size_t n)
+{
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    return HEADER + helm_bank_bytes(n) + ((n + per - 1) / per) * per
+                                         * sizeof(double);
+}
+
+/** Read the kernel's boot identifier into \c id, empty if unavailable. */
+static
+void
+boot_id(char id[40])
+{
+    memset(id, 0, 40);
+    FILE * const f = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (f) {
+        if (!fgets(id, 40, f)) {
+            memset(id, 0, 40);
+        }
+        fclose(f);
+    }
+}
+
+/** Checksum \c bytes, a multiple of eight, at \c p by word-wise FNV-1a. */
+static
+uint64_t
+checksum(const void * const p, const size_t bytes)
+{
+    const uint64_t * const w = (const uint64_t *) p;
+    uint64_t h = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < bytes / sizeof(*w); ++i) {
+        h = (h ^ w[i]) * UINT64_C(0x100000001b3);
+    }
+    return h;
+}
+
+/** Allocate \c path followed by \c suffix. */
+static
+char *
+suffixed(const char * const path, const char * const suffix)
+{
+    const size_t a = strlen(path), b = strlen(suffix);
+    char * const s = malloc(a + b + 1);
+    if (s) {
+        memcpy(s, path, a);
+        memcpy(s + a, suffix, b + 1);
+    }
+    return s;
+}
+
+/** Write all \c bytes from \c p to \c fd, returning zero or an errno. */
+static
+int
+write_all(const int fd, const void * const p, const size_t bytes)
+{
+    const char *q = (const char *) p;
+    for (size_t left = bytes; left;) {
+        const ssize_t w = write(fd, q, left);
+        if (w < 0 && errno != EINTR) {
+            return errno;
+        }
+        if (w > 0) {
+            q    += w;
+            left -= (size_t) w;
+        }
+    }
+    return 0;
+}
+
+/** Flush the directory containing \c path so a rename is durable. */
+static
+int
+sync_dir(const char * const path)
+{
+    const char * const slash = strrchr(path, '/');
+    char * const dir = slash ? strndup(path, (size_t) (slash - path) + 1)
+                             : strdup(".");
+    if (!dir) {
+        return ENOMEM;
+    }
+    const int fd = open(dir, O_RDONLY | O_DIRECTORY);
+    free(dir);
+    if (fd < 0) {
+        return errno;
+    }
+    const int err = fsync(fd) ? errno : 0;
+    close(fd);
+    return err;
+}
+
+/**
+ * Read any snapshot of \c n lanes at \c path into \c buf of \c bytes.
+ * Returns zero when a valid snapshot was read, \c ENOENT when none is
+ * usable, or another \c errno value.
+ */
+static
+int
+read_snapshot(const char * const path,
+              const size_t n,
+              void * const buf,
+              const size_t bytes)
+{
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno == ENOENT ? ENOENT : errno;
+    }
+    int err = ENOENT;
+    size_t got = 0;
+    while (got < bytes) {
+        const ssize_t r = read(fd, (char *) buf + got, bytes - got);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r <= 0) {
+            break;
+        }
+        got += (size_t) r;
+    }
+    close(fd);
+
+    const struct header * const h = (const struct header *) buf;
+    if (got >= sizeof(*h) && h->magic == MAGIC && h->version == VERSION) {
+        if (h->n != n) {
+            err = EINVAL;               // Never silently discard lanes
+        } else if (got == bytes && h->bytes == bytes && h->clean
+                   && h->sum == checksum((const char *) buf + HEADER,
+                                         bytes - HEADER)) {
+            err = 0;
+        }
+    }
+    return err;
+}
+
+int
+helm_ckpt_open(struct helm_ckpt *c,
+               const char *path,
+               size_t n,
+               const struct helm_state *h,
+               enum helm_ckpt_origin *origin)
+{
+    memset(c, 0, sizeof(*c));
+    const size_t bytes = length(n);
+    char * const snap = suffixed(path, ".snap");
+    c->path    = strdup(path);
+    c->scratch = malloc(bytes);
+    int err = 0, fd = -1;
+    if (!snap || !c->path || !c->scratch) {
+        err = ENOMEM;
+        goto fail;
+    }
+
+    // Inspect any existing live file, refusing a lane count mismatch
+    if ((fd = open(path, O_RDWR | O_CREAT, 0644)) < 0) {
+        err = errno;
+        goto fail;
+    }
+    struct header old;
+    memset(&old, 0, sizeof(old));
+    if (pread(fd, &old, sizeof(old), 0) == (ssize_t) sizeof(old)
+            && old.magic == MAGIC && old.version == VERSION
+            && old.n != n) {
+        err = EINVAL;
+        goto fail;
+    }
+    char boot[40];
+    boot_id(boot);
+    const int trusted = old.magic == MAGIC && old.version == VERSION
+                     && old.bytes == bytes && !(old.seq & 1)
+                     && (old.clean || (boot[0] && !memcmp(boot, old.boot,
+                                                          sizeof(boot))));
+
+    // Map the live file in place
+    if (ftruncate(fd, (off_t) bytes)) {
+        err = errno;
+        goto fail;
+    }
+    c->map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (c->map == MAP_FAILED) {
+        c->map = NULL;
+        err = errno;
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+    c->bytes = bytes;
+    struct header * const live = (struct header *) c->map;
+    c->seq = &live->seq;
+    helm_bank_init(&c->bank, n, (char *) c->map + HEADER);
+    c->v = (double *) ((char *) c->map + HEADER + helm_bank_bytes(n));
+
+    // Otherwise restore the latest snapshot or start fresh
+    enum helm_ckpt_origin o = HELM_CKPT_LIVE;
+    if (!trusted) {
+        err = read_snapshot(snap, n, c->scratch, bytes);
+        if (!err) {
+            memcpy((char *) c->map + HEADER, (char *) c->scratch + HEADER,
+                   bytes - HEADER);
+            o = HELM_CKPT_SNAPSHOT;
+        } else if (err == ENOENT) {
+            for (size_t i = 0; i < n; ++i) {
+                helm_bank_set(&c->bank, i, h);
+                c->v[i] = 0;
+            }
+            helm_bank_approach(&c->bank);
+            o = HELM_CKPT_FRESH;
+            err = 0;
+        } else {
+            goto fail;
+        }
+        live->seq = 0;
+    }
+
+    // Durably mark the file dirty before any step so that it is distrusted
+    // should the system crash before helm_ckpt_close()
+    live->magic   = MAGIC;
+    live->version = VERSION;
+    live->clean   = 0;
+    live->n       = n;
+    live->bytes   = bytes;
+    live->sum     = 0;
+    memcpy(live->boot, boot, sizeof(boot));
+    if (msync(c->map, o == HELM_CKPT_LIVE ? HEADER : bytes, MS_SYNC)) {
+        err = errno;
+        goto fail;
+    }
+    if (origin) {
+        *origin = o;
+    }
+    free(snap);
+    return 0;
+
+fail:
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (c->map) {
+        munmap(c->map, c->bytes);
+    }
+    free(snap);
+    free(c->path);
+    free(c->scratch);
+    memset(c, 0, sizeof(*c));
+    return err;
+}
+
+int
+helm_ckpt_snapshot(struct helm_ckpt *c)
+{
+    // Copy the payload while no step overlaps, never blocking the stepper
+    const size_t payload = c->bytes - HEADER;
+    char * const dst = (char *) c->scratch + HEADER;
+    uint64_t s = 0;
+    int tries = 0;
+    for (; tries < TRIES; ++tries) {
+        s = __atomic_load_n(c->seq, __ATOMIC_ACQUIRE);
+        if (s & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(dst, (const char *) c->map + HEADER, payload);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(c->seq, __ATOMIC_RELAXED) == s) {
+            break;
+        }
+    }
+    if (tries == TRIES) {
+        return EAGAIN;
+    }
+    struct header * const hdr = (struct header *) c->scratch;
+    memcpy(hdr, c->map, sizeof(*hdr));
+    hdr->clean = 1;
+    hdr->seq   = s;
+    hdr->sum   = checksum(dst, payload);
+    memset(hdr + 1, 0, HEADER - sizeof(*hdr));
+
+    // Write a temporary file durably and then atomically replace
+    char * const tmp  = suffixed(c->path, ".snap.tmp");
+    char * const snap = suffixed(c->path, ".snap");
+    int err = 0;
+    if (!tmp || !snap) {
+        err = ENOMEM;
+    } else {
+        const int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            err = errno;
+        } else {
+            err = write_all(fd, c->scratch, c->bytes);
+            if (!err && fsync(fd)) {
+                err = errno;
+            }
+            close(fd);
+            if (!err && rename(tmp, snap)) {
+                err = errno;
+            }
+            if (err) {
+                unlink(tmp);
+            } else {
+                err = sync_dir(snap);
+            }
+        }
+    }
+    free(tmp);
+    free(snap);
+    return err;
+}
+
+int
+helm_ckpt_close(struct helm_ckpt *c)
+{
+    if (!c->map) {
+        return 0;
+    }
+    struct header * const live = (struct header *) c->map;
+    int err = msync(c->map, c->bytes, MS_SYNC) ? errno : 0;
+    if (!err) {
+        live->clean = 1;
+        err = msync(c->map, HEADER, MS_SYNC) ? errno : 0;
+    }
+    munmap(c->map, c->bytes);
+    free(c->path);
+    free(c->scratch);
+    memset(c, 0, sizeof(*c));
+    return err;
+}
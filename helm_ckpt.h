@@ -0,0 +1,195 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_CKPT_H
+#define HELM_CKPT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helm.h"
+#include "helm_bank.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * A helm_bank whose live state is a memory-mapped file, permitting warm
+ * restarts without helm_approach() and crash-consistent snapshots.
+ *
+ * The live file holds a versioned header followed by the seven arrays of a
+ * helm_bank and the current request \c v of every lane, exactly as they are
+ * stepped.  Reopening the file after a process restart therefore resumes
+ * every loop with its tuning, filter history, and request intact so that
+ * the next helm_steady() increment continues bumplessly.  Nothing is parsed
+ * and nothing is copied, so restarting costs one \c mmap.
+ *
+ * The live file is only as durable as the page cache.  It is trusted on
+ * reopening when it was closed cleanly by helm_ckpt_close() or when the
+ * system has not rebooted since it was last opened.  Otherwise, or when a
+ * process died mid-step, the latest snapshot is restored instead.
+ *
+ * Snapshots are taken by helm_ckpt_snapshot(), typically periodically from
+ * a background thread.  Stepping through helm_ckpt_steady() brackets each
+ * pass by a sequence lock as in \ref helm_retune.h.  The snapshotting thread
+ * copies the arrays into a private buffer and retries whenever the sequence
+ * shows that a step overlapped its copy, so the control loop never waits.
+ * The copy is checksummed, written to a temporary file, flushed by \c
+ * fsync, and atomically renamed over the previous snapshot.  A snapshot file
+ * is therefore always either the prior or the new one, never a mixture.
+ *
+ * Sample usage with snapshots taken by a second thread:
+ * \code
+ *   // Control thread
+ *   struct helm_ckpt c;
+ *   enum helm_ckpt_origin origin;
+ *   helm_ckpt_open(&c, "loops.ckpt", n, &h_default, &origin);
+ *   for (;;) {
+ *       helm_ckpt_steady(&c, dt, r, u, y, dv);
+ *       // ...actuate each c.v[i]...
+ *   }
+ *
+ *   // Snapshot thread
+ *   for (;;) {
+ *       sleep(1);
+ *       helm_ckpt_snapshot(&c);
+ *   }
+ * \endcode
+ */
+
+/** How helm_ckpt_open() obtained its state. */
+enum helm_ckpt_origin
+{
+    HELM_CKPT_FRESH    = 0,  /**< Initialized from default tuning.       */
+    HELM_CKPT_LIVE     = 1,  /**< Resumed from the live file in place.   */
+    HELM_CKPT_SNAPSHOT = 2   /**< Restored from the most recent snapshot. */
+};
+
+/**
+ * A bank of controllers and requests living within a mapped file.  Members
+ * #bank and #v may be read and written freely by the control thread.
+ * Remaining members are private.
+ */
+struct helm_ckpt
+{
+    struct helm_bank  bank;     /**< Live controllers within the mapping. */
+    double           *v;        /**< Live request of every lane.          */
+    uint64_t         *seq;      /**< Sequence, odd while stepping.        */
+    void             *map;      /**< Mapping of the live file.            */
+    size_t            bytes;    /**< Length of #map.                      */
+    char             *path;     /**< Path of the live file.               */
+    void             *scratch;  /**< Staging buffer for snapshots.        */
+};
+
+/**
+ * \brief Map or create the live file at \c path holding \c n lanes.
+ *
+ * A trusted live file is mapped in place.  Otherwise any valid snapshot at
+ * \c path with suffix ".snap" is restored.  Otherwise every lane receives
+ * the tuning of \c h, has its state reset by helm_approach(), and has \c v
+ * zero.  A live file or snapshot holding other than \c n lanes is an error
+ * rather than being discarded.
+ *
+ * \param[out] c      Checkpointed bank to be initialized.
+ * \param[in]  path   Path of the live file.
+ * \param[in]  n      Number of lanes.
+ * \param[in]  h      Default tuning for a fresh start.
+ * \param[out] origin If non-NULL, how the state was obtained.
+ *
+ * \return Zero on success or an \c errno value, e.g. \c EINVAL upon a lane
+ *         count mismatch.
+ */
+int
+helm_ckpt_open(struct helm_ckpt *c,
+               const char *path,
+               size_t n,
+               const struct helm_state *h,
+               enum helm_ckpt_origin *origin);
+
+/**
+ * \brief Durably write a crash-consistent snapshot of \c c.
+ *
+ * Safe to call from one thread while another steps \c c through
+ * helm_ckpt_steady() or between helm_ckpt_begin() and helm_ckpt_end().
+ * Snapshots must be serialized by the caller.
+ *
+ * \return Zero on success, \c EAGAIN if every attempted copy overlapped a
+ *         step, or another \c errno value from file I/O.
+ */
+int
+helm_ckpt_snapshot(struct helm_ckpt *c);
+
+/**
+ * \brief Flush, mark clean, and unmap the live file of \c c.
+ * \return Zero on success or an \c errno value.
+ */
+int
+helm_ckpt_close(struct helm_ckpt *c);
+
+/**
+ * \brief Mark the start of a modification of \c c->bank or \c c->v.
+ *
+ * Wait-free.  Only one thread may modify \c c.
+ */
+static inline
+void
+helm_ckpt_begin(struct helm_ckpt * const c)
+{
+    const uint64_t s = __atomic_load_n(c->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(c->seq, s + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/** \brief Mark the end of a modification begun by helm_ckpt_begin(). */
+static inline
+void
+helm_ckpt_end(struct helm_ckpt * const c)
+{
+    const uint64_t s = __atomic_load_n(c->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(c->seq, s + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * \brief Step every lane by helm_bank_steady() and accumulate each \c dv
+ * into \c c->v, all bracketed by the sequence lock.
+ *
+ * \param[in,out] c  Checkpointed bank.
+ * \param[in]     dt Time since previous call for each lane.
+ * \param[in]     r  Reference value for each lane.
+ * \param[in]     u  Observed actuator position for each lane.
+ * \param[in]     y  Observed process output for each lane.
+ * \param[out]    dv Increment just applied to each lane's request.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+struct helm_ckpt *
+helm_ckpt_steady(struct helm_ckpt * const c,
+                 const double * const dt,
+                 const double * const r,
+                 const double * const u,
+                 const double * const y,
+                 double * const dv)
+{
+    helm_ckpt_begin(c);
+    helm_bank_steady(&c->bank, dt, r, u, c->v, y, dv);
+    for (size_t i = 0; i < c->bank.n; ++i) {
+        c->v[i] += dv[i];
+    }
+    helm_ckpt_end(c);
+    return c;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_CKPT_H */
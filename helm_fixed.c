@@ -0,0 +1,84 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_fixed.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_fixed.h"
+
+extern
+int32_t
+helm_fixed_quantize(const double x, const double scale);
+
+extern
+int32_t
+helm_fixed_saturate(const int64_t x);
+
+extern
+int32_t
+helm_fixed_add(const int32_t a, const int32_t b);
+
+extern
+int
+helm_fixed_compile(struct helm_fixed * const c,
+                   const struct helm_state * const h,
+                   const double dt,
+                   const double sy,
+                   const double su);
+
+extern
+struct helm_fixed *
+helm_fixed_approach(struct helm_fixed * const c);
+
+extern
+int32_t
+helm_fixed_steady(struct helm_fixed * const c,
+                  const int32_t r,
+                  const int32_t u,
+                  const int32_t v,
+                  const int32_t y);
+
+extern
+size_t
+helm_fixed_bank_bytes(const size_t n);
+
+extern
+struct helm_fixed_bank *
+helm_fixed_bank_init(struct helm_fixed_bank * const b,
+                     const size_t n,
+                     void * const mem);
+
+extern
+struct helm_fixed_bank *
+helm_fixed_bank_set(struct helm_fixed_bank * const b,
+                    const size_t i,
+                    const struct helm_fixed * const c);
+
+extern
+struct helm_fixed *
+helm_fixed_bank_get(const struct helm_fixed_bank * const b,
+                    const size_t i,
+                    struct helm_fixed * const c);
+
+extern
+struct helm_fixed_bank *
+helm_fixed_bank_approach(struct helm_fixed_bank * const b);
+
+extern
+struct helm_fixed_bank *
+helm_fixed_bank_steady(struct helm_fixed_bank * const b,
+                       const int32_t * const r,
+                       const int32_t * const u,
+                       const int32_t * const v,
+                       const int32_t * const y,
+                       int32_t * const dv);
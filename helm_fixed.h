@@ -0,0 +1,647 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_FIXED_H
+#define HELM_FIXED_H
+
+#include <errno.h>
+#include <stdint.h>
+
+#include "helm.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HELM_FIXED_X86 1  ///< AVX2/AVX-512 kernels with runtime dispatch
+#else
+#define HELM_FIXED_X86 0  ///< Portable scalar kernel only
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * An integer-only equivalent of helm_steady() for data paths carrying
+ * scaled integer signals.
+ *
+ * Reference \c r, observable \c y, actuator position \c u, and request \c v
+ * are \c int32_t counts such that, e.g., the physical observable is \c y
+ * times a caller-chosen scale \c sy while the physical actuator position is
+ * \c u times scale \c su.  Every signal must lie within
+ * <tt>[-HELM_FIXED_MAX, HELM_FIXED_MAX]</tt>, which admits any \c int16_t
+ * and leaves one bit of headroom within \c int32_t so that differences of
+ * signals never overflow.  Value #HELM_FIXED_NONE marks a missing
+ * observable exactly as NaN does for helm_steady().
+ *
+ * helm_fixed_compile() converts a helm_state at fixed \c dt into integer
+ * mantissas for the proportional, integral, automatic reset, and derivative
+ * coefficients of helm_steady_compiled().  The four share one binary
+ * exponent chosen so that the largest mantissa nears \f$2^{29}\f$.  Rather
+ * than tracking the filtered observable \f$f\f$, the deviation \f$g = f -
+ * y\f$ is tracked in Q.8 format because \f$\mathrm{d}f - \mathrm{d}y =
+ * \mathrm{d}g\f$ and \f$g_i = (1 - \alpha)\left(g_{i-1} - \mathrm{d}y_i
+ * \right)\f$ with \f$1 - \alpha\f$ held in Q0.31 format.  Bounding \f$g\f$
+ * rather than \f$f\f$ keeps filter precision independent of signal level.
+ *
+ * Each step accumulates the four products in 64 bits and returns the integer
+ * part of the increment.  The fractional remainder is carried into the next
+ * step so that small integral actions accumulate rather than rounding away.
+ * The accumulated request therefore tracks that of helm_steady() to within
+ * one count plus the quantization of the coefficients and of the signals
+ * themselves.  Intermediate state and every increment saturate at
+ * #HELM_FIXED_MAX rather than wrapping.  Right shifts of negative values are
+ * taken to be arithmetic as for every GCC-like compiler.
+ *
+ * A structure-of-arrays helm_fixed_bank advances many controllers in one
+ * call with AVX2 and AVX-512 kernels selected at runtime.  Integer results
+ * are bit-identical lane by lane to helm_fixed_steady().
+ *
+ * Sample usage with 4096 counts per unit for both observable and actuator:
+ * \code
+ *   struct helm_fixed c;
+ *   helm_fixed_compile(&c, &h, dt, 1.0/4096, 1.0/4096);
+ *   helm_fixed_approach(&c);
+ *   for (;;) {
+ *       y  = read_sensor();
+ *       v  = helm_fixed_add(v, helm_fixed_steady(&c, r, u, v, y));
+ *       u  = write_actuator(v);
+ *   }
+ * \endcode
+ */
+
+/** Largest magnitude permitted for any signal or state. */
+#define HELM_FIXED_MAX ((int32_t) 0x3fffffff)
+
+/** Observable value marking a missing measurement. */
+#define HELM_FIXED_NONE INT32_MIN
+
+/** Fractional bits within the filter deviation helm_fixed::g. */
+#define HELM_FIXED_GUARD 8
+
+/** Largest binary exponent shared by compiled coefficient mantissas. */
+#define HELM_FIXED_SHIFT 30
+
+/** Alignment and padding, in bytes, applied to each helm_fixed_bank array. */
+#define HELM_FIXED_ALIGN 64
+
+/**
+ * Integer coefficients compiled from a helm_state and integer transient
+ * state.  Coefficient mantissas are scaled by \f$2^{\mathrm{shift}}\f$.
+ */
+struct helm_fixed
+{
+    int32_t kp;     /**< Proportional coefficient \f$k_p s_y / s_u\f$.       */
+    int32_t ki;     /**< Integral coefficient \f$k_p s_y dt / (s_u T_i)\f$.  */
+    int32_t kt;     /**< Automatic reset coefficient \f$k_p dt / T_t\f$.     */
+    int32_t kd;     /**< Derivative coefficient \f$k_p s_y T_d/(s_u T_f)\f$. */
+    int32_t beta;   /**< Filter retention \f$1 - \alpha\f$ in Q0.31.         */
+    int32_t shift;  /**< Binary exponent shared by the mantissas.           */
+    int32_t y;      /**< Prior observable or #HELM_FIXED_NONE on approach.  */
+    int32_t g;      /**< Filter deviation \f$f - y\f$ in Q.8.               */
+    int32_t q;      /**< Carried remainder in units of 2^-shift counts.     */
+};
+
+/**
+ * \brief Round \c x divided by \c scale to counts, saturating.
+ * \return Counts within <tt>[-HELM_FIXED_MAX, HELM_FIXED_MAX]</tt> or
+ *         #HELM_FIXED_NONE when \c x is NaN.
+ */
+static inline
+int32_t
+helm_fixed_quantize(const double x, const double scale)
+{
+    if (isnan(x)) {
+        return HELM_FIXED_NONE;
+    }
+    const double c = nearbyint(x / scale);
+    return c >  HELM_FIXED_MAX ?  HELM_FIXED_MAX
+         : c < -HELM_FIXED_MAX ? -HELM_FIXED_MAX
+         : (int32_t) c;
+}
+
+/** \brief Saturate \c x to <tt>[-HELM_FIXED_MAX, HELM_FIXED_MAX]</tt>. */
+static inline
+int32_t
+helm_fixed_saturate(const int64_t x)
+{
+    return x >  HELM_FIXED_MAX ?  HELM_FIXED_MAX
+         : x < -HELM_FIXED_MAX ? -HELM_FIXED_MAX
+         : (int32_t) x;
+}
+
+/** \brief Add \c a and \c b, e.g. a request and its increment, saturating. */
+static inline
+int32_t
+helm_fixed_add(const int32_t a, const int32_t b)
+{
+    return helm_fixed_saturate((int64_t) a + b);
+}
+
+/**
+ * \brief Compile the tuning within \c h for use at time step \c dt.
+ *
+ * Transient state within \c c is untouched so that retuning is bumpless.
+ *
+ * \param[in,out] c  Fixed point controller to receive coefficients.
+ * \param[in]     h  Tuning parameters to compile.  State is ignored.
+ * \param[in]     dt Time step between helm_fixed_steady() invocations.
+ * \param[in]     sy Physical observable per count of \c y and \c r.
+ * \param[in]     su Physical actuator position per count of \c u and \c v.
+ *
+ * \return Zero on success or \c EDOM when some coefficient is non-finite or
+ *         too large to be represented.
+ */
+static inline
+int
+helm_fixed_compile(struct helm_fixed * const c,
+                   const struct helm_state * const h,
+                   const double dt,
+                   const double sy,
+                   const double su)
+{
+    assert(dt > 0 && sy > 0 && su > 0);
+    const double g    = h->kp * sy / su;
+    const double k[4] = {
+        g, g * dt / h->Ti, h->kp * dt / h->Tt, g * (h->Td / h->Tf)
+    };
+    double big = 0;
+    for (int j = 0; j < 4; ++j) {
+        if (!isfinite(k[j])) {
+            return EDOM;
+        }
+        big = fmax(big, fabs(k[j]));
+    }
+    int s = HELM_FIXED_SHIFT;
+    while (s > 0 && ldexp(big, s) > 0x1p29) {
+        --s;
+    }
+    if (ldexp(big, s) > 0x1p29) {
+        return EDOM;
+    }
+    const double a = dt / (h->Tf + dt);  // Identical to helm_steady()
+    c->kp    = (int32_t) nearbyint(ldexp(k[0], s));
+    c->ki    = (int32_t) nearbyint(ldexp(k[1], s));
+    c->kt    = (int32_t) nearbyint(ldexp(k[2], s));
+    c->kd    = (int32_t) nearbyint(ldexp(k[3], s));
+    c->beta  = (int32_t) fmin(nearbyint(ldexp(1 - a, 31)), INT32_MAX);
+    c->shift = s;
+    return 0;
+}
+
+/**
+ * \brief Reset any transient state, but \e not coefficients.
+ * \see helm_approach() for the semantics.
+ */
+static inline
+struct helm_fixed *
+helm_fixed_approach(struct helm_fixed * const c)
+{
+    c->y = HELM_FIXED_NONE;
+    c->g = 0;
+    c->q = 0;
+    return c;
+}
+
+/**
+ * \brief Find the integer control increment steadying observable \c y.
+ *
+ * \param[in,out] c  Coefficients and state maintained across invocations.
+ * \param[in]     r  Reference value in counts.
+ * \param[in]     u  Actuator position currently observed in counts.
+ * \param[in]     v  Actuator position currently requested in counts.
+ * \param[in]     y  Observed process output in counts or #HELM_FIXED_NONE.
+ *
+ * \return Incremental suggested change to \c v in counts.
+ * \see helm_steady() for the floating point reference.
+ */
+static inline
+int32_t
+helm_fixed_steady(struct helm_fixed * const c,
+                  const int32_t r,
+                  const int32_t u,
+                  const int32_t v,
+                  const int32_t y)
+{
+    if (y == HELM_FIXED_NONE) {           // Avoid driving blind
+        return 0;
+    }
+    assert(-HELM_FIXED_MAX <= r && r <= HELM_FIXED_MAX);
+    assert(-HELM_FIXED_MAX <= u && u <= HELM_FIXED_MAX);
+    assert(-HELM_FIXED_MAX <= v && v <= HELM_FIXED_MAX);
+    assert(-HELM_FIXED_MAX <= y && y <= HELM_FIXED_MAX);
+
+    const int     kick = c->y == HELM_FIXED_NONE;  // Avoid startup kick
+    const int64_t hy   = kick ? y : c->y;
+    const int64_t hg   = kick ? 0 : c->g;
+
+    int64_t dy, t, gn, acc, dv;
+    dy   = y - hy;                                   // Backward difference
+    t    = helm_fixed_saturate(hg - dy * (1 << HELM_FIXED_GUARD));
+    gn   = (t * c->beta) >> 31;                      // Filter deviation
+    acc  = c->q;                                     // Carried remainder
+    acc += (int64_t) c->ki * (r - y);                // Integral control
+    acc += (int64_t) c->kt * (u - v);                // Automatic reset
+    acc -= (int64_t) c->kp * dy;                     // Proportional control
+    acc += ((int64_t) c->kd * (gn - hg)) >> HELM_FIXED_GUARD;  // Derivative
+    dv   = acc >> c->shift;                          // Integer part
+
+    c->y = y;                                        // Update for next call
+    c->g = (int32_t) gn;
+    c->q = (int32_t) (acc - dv * ((int64_t) 1 << c->shift));
+    return helm_fixed_saturate(dv);
+}
+
+/**
+ * Coefficients and state for a bank of fixed point controllers stored as
+ * parallel arrays.  Lane \c i of each array carries the same meaning as the
+ * like-named member of helm_fixed.
+ */
+struct helm_fixed_bank
+{
+    size_t   n;      /**< Number of controllers within the bank.  */
+    int32_t *kp;     /**< Proportional coefficient mantissas.     */
+    int32_t *ki;     /**< Integral coefficient mantissas.         */
+    int32_t *kt;     /**< Automatic reset coefficient mantissas.  */
+    int32_t *kd;     /**< Derivative coefficient mantissas.       */
+    int32_t *beta;   /**< Filter retentions in Q0.31.             */
+    int32_t *shift;  /**< Binary exponents.                       */
+    int32_t *y;      /**< Prior observables.                      */
+    int32_t *g;      /**< Filter deviations in Q.8.               */
+    int32_t *q;      /**< Carried remainders.                     */
+};
+
+/**
+ * \brief Bytes of storage required by helm_fixed_bank_init() for \c n
+ * controllers.
+ *
+ * Each of the nine arrays is padded to a multiple of #HELM_FIXED_ALIGN bytes.
+ */
+static inline
+size_t
+helm_fixed_bank_bytes(const size_t n)
+{
+    const size_t per = HELM_FIXED_ALIGN / sizeof(int32_t);
+    return 9 * ((n + per - 1) / per) * per * sizeof(int32_t);
+}
+
+/**
+ * \brief Carve the arrays of \c b from caller-provided storage.
+ *
+ * When \c mem is aligned to #HELM_FIXED_ALIGN bytes so is every array.
+ * No coefficients or state are set.
+ *
+ * \param[out] b   Bank to be initialized.
+ * \param[in]  n   Number of controllers within the bank.
+ * \param[in]  mem At least helm_fixed_bank_bytes(n) bytes of storage.
+ * \return Argument \c b to permit call chaining.
+ */
+static inline
+struct helm_fixed_bank *
+helm_fixed_bank_init(struct helm_fixed_bank * const b,
+                     const size_t n,
+                     void * const mem)
+{
+    const size_t per    = HELM_FIXED_ALIGN / sizeof(int32_t);
+    const size_t stride = ((n + per - 1) / per) * per;
+    int32_t * const p   = (int32_t *) mem;
+    b->n     = n;
+    b->kp    = p + 0*stride;
+    b->ki    = p + 1*stride;
+    b->kt    = p + 2*stride;
+    b->kd    = p + 3*stride;
+    b->beta  = p + 4*stride;
+    b->shift = p + 5*stride;
+    b->y     = p + 6*stride;
+    b->g     = p + 7*stride;
+    b->q     = p + 8*stride;
+    return b;
+}
+
+/**
+ * \brief Copy controller \c c into lane \c i of bank \c b.
+ * \return Argument \c b to permit call chaining.
+ */
+static inline
+struct helm_fixed_bank *
+helm_fixed_bank_set(struct helm_fixed_bank * const b,
+                    const size_t i,
+                    const struct helm_fixed * const c)
+{
+    assert(i < b->n);
+    b->kp   [i] = c->kp;
+    b->ki   [i] = c->ki;
+    b->kt   [i] = c->kt;
+    b->kd   [i] = c->kd;
+    b->beta [i] = c->beta;
+    b->shift[i] = c->shift;
+    b->y    [i] = c->y;
+    b->g    [i] = c->g;
+    b->q    [i] = c->q;
+    return b;
+}
+
+/**
+ * \brief Copy lane \c i of bank \c b into controller \c c.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+struct helm_fixed *
+helm_fixed_bank_get(const struct helm_fixed_bank * const b,
+                    const size_t i,
+                    struct helm_fixed * const c)
+{
+    assert(i < b->n);
+    c->kp    = b->kp   [i];
+    c->ki    = b->ki   [i];
+    c->kt    = b->kt   [i];
+    c->kd    = b->kd   [i];
+    c->beta  = b->beta [i];
+    c->shift = b->shift[i];
+    c->y     = b->y    [i];
+    c->g     = b->g    [i];
+    c->q     = b->q    [i];
+    return c;
+}
+
+/**
+ * \brief Reset any transient state, but \e not coefficients.
+ * \see helm_fixed_approach() for the per-controller semantics.
+ */
+static inline
+struct helm_fixed_bank *
+helm_fixed_bank_approach(struct helm_fixed_bank * const b)
+{
+    for (size_t i = 0; i < b->n; ++i) {
+        b->y[i] = HELM_FIXED_NONE;
+        b->g[i] = 0;
+        b->q[i] = 0;
+    }
+    return b;
+}
+
+/** \brief Portable kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+static inline
+void
+helm_fixed_bank_steady_scalar(struct helm_fixed_bank * const b,
+                              const size_t begin,
+                              const size_t end,
+                              const int32_t * const r,
+                              const int32_t * const u,
+                              const int32_t * const v,
+                              const int32_t * const y,
+                              int32_t * const dv)
+{
+    for (size_t i = begin; i < end; ++i) {
+        struct helm_fixed c;
+        helm_fixed_bank_get(b, i, &c);
+        dv[i] = helm_fixed_steady(&c, r[i], u[i], v[i], y[i]);
+        b->y[i] = c.y;
+        b->g[i] = c.g;
+        b->q[i] = c.q;
+    }
+}
+
+#if HELM_FIXED_X86
+
+/** \brief Sign-extend four \c int32_t from \c p into 64-bit lanes. */
+__attribute__((target("avx2")))
+static inline
+__m256i
+helm_fixed_load_avx2(const int32_t * const p)
+{
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *) p));
+}
+
+/** \brief Narrow four 64-bit lanes of \c x, each within range, into \c p. */
+__attribute__((target("avx2")))
+static inline
+void
+helm_fixed_store_avx2(int32_t * const p, const __m256i x)
+{
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    _mm_storeu_si128((__m128i *) p, _mm256_castsi256_si128(
+            _mm256_permutevar8x32_epi32(x, even)));
+}
+
+/** \brief Arithmetic right shift of each 64-bit lane of \c x by \c s. */
+__attribute__((target("avx2")))
+static inline
+__m256i
+helm_fixed_srav_avx2(const __m256i x, const __m256i s)
+{
+    const __m256i m = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x);
+    return _mm256_xor_si256(_mm256_srlv_epi64(_mm256_xor_si256(x, m), s), m);
+}
+
+/** \brief Saturate 64-bit lanes of \c x as by helm_fixed_saturate(). */
+__attribute__((target("avx2")))
+static inline
+__m256i
+helm_fixed_saturate_avx2(__m256i x)
+{
+    const __m256i hi = _mm256_set1_epi64x( HELM_FIXED_MAX);
+    const __m256i lo = _mm256_set1_epi64x(-HELM_FIXED_MAX);
+    x = _mm256_blendv_epi8(x, hi, _mm256_cmpgt_epi64(x, hi));
+    return _mm256_blendv_epi8(x, lo, _mm256_cmpgt_epi64(lo, x));
+}
+
+/** \brief AVX2 kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+__attribute__((target("avx2")))
+static inline
+size_t
+helm_fixed_bank_steady_avx2(struct helm_fixed_bank * const b,
+                            const size_t begin,
+                            const size_t end,
+                            const int32_t * const r,
+                            const int32_t * const u,
+                            const int32_t * const v,
+                            const int32_t * const y,
+                            int32_t * const dv)
+{
+    const __m256i none  = _mm256_set1_epi64x(HELM_FIXED_NONE);
+    const __m256i zero  = _mm256_setzero_si256();
+    const __m256i guard = _mm256_set1_epi64x(HELM_FIXED_GUARD);
+    const __m256i q31   = _mm256_set1_epi64x(31);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m256i Y  = helm_fixed_load_avx2(y + i);
+        const __m256i oy = helm_fixed_load_avx2(b->y + i);
+        const __m256i og = helm_fixed_load_avx2(b->g + i);
+        const __m256i oq = helm_fixed_load_avx2(b->q + i);
+        const __m256i S  = helm_fixed_load_avx2(b->shift + i);
+        const __m256i skip = _mm256_cmpeq_epi64(Y,  none);
+        const __m256i kick = _mm256_cmpeq_epi64(oy, none);
+        const __m256i hy = _mm256_blendv_epi8(oy, Y, kick);
+        const __m256i hg = _mm256_andnot_si256(kick, og);
+
+        const __m256i dy = _mm256_sub_epi64(Y, hy);
+        const __m256i t  = helm_fixed_saturate_avx2(_mm256_sub_epi64(
+                hg, _mm256_slli_epi64(dy, HELM_FIXED_GUARD)));
+        const __m256i gn = helm_fixed_srav_avx2(_mm256_mul_epi32(
+                t, helm_fixed_load_avx2(b->beta + i)), q31);
+        __m256i acc = oq;
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(
+                helm_fixed_load_avx2(b->ki + i),
+                _mm256_sub_epi64(helm_fixed_load_avx2(r + i), Y)));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(
+                helm_fixed_load_avx2(b->kt + i),
+                _mm256_sub_epi64(helm_fixed_load_avx2(u + i),
+                                 helm_fixed_load_avx2(v + i))));
+        acc = _mm256_sub_epi64(acc, _mm256_mul_epi32(
+                helm_fixed_load_avx2(b->kp + i), dy));
+        acc = _mm256_add_epi64(acc, helm_fixed_srav_avx2(_mm256_mul_epi32(
+                helm_fixed_load_avx2(b->kd + i),
+                _mm256_sub_epi64(gn, hg)), guard));
+        const __m256i d  = helm_fixed_srav_avx2(acc, S);
+        const __m256i qn = _mm256_sub_epi64(acc, _mm256_sllv_epi64(d, S));
+
+        helm_fixed_store_avx2(dv + i, _mm256_blendv_epi8(
+                helm_fixed_saturate_avx2(d), zero, skip));
+        helm_fixed_store_avx2(b->y + i, _mm256_blendv_epi8(Y,  oy, skip));
+        helm_fixed_store_avx2(b->g + i, _mm256_blendv_epi8(gn, og, skip));
+        helm_fixed_store_avx2(b->q + i, _mm256_blendv_epi8(qn, oq, skip));
+    }
+    return i;
+}
+
+/** \brief Sign-extend eight \c int32_t from \c p into 64-bit lanes. */
+__attribute__((target("avx512f")))
+static inline
+__m512i
+helm_fixed_load_avx512(const int32_t * const p)
+{
+    return _mm512_cvtepi32_epi64(_mm256_loadu_si256((const __m256i *) p));
+}
+
+/** \brief Narrow eight 64-bit lanes of \c x, each within range, into \c p. */
+__attribute__((target("avx512f")))
+static inline
+void
+helm_fixed_store_avx512(int32_t * const p, const __m512i x)
+{
+    _mm256_storeu_si256((__m256i *) p, _mm512_cvtepi64_epi32(x));
+}
+
+/** \brief Saturate 64-bit lanes of \c x as by helm_fixed_saturate(). */
+__attribute__((target("avx512f")))
+static inline
+__m512i
+helm_fixed_saturate_avx512(const __m512i x)
+{
+    return _mm512_max_epi64(_mm512_set1_epi64(-HELM_FIXED_MAX),
+           _mm512_min_epi64(_mm512_set1_epi64( HELM_FIXED_MAX), x));
+}
+
+/** \brief AVX-512 kernel advancing lanes <tt>[begin, end)</tt> of \c b. */
+__attribute__((target("avx512f")))
+static inline
+size_t
+helm_fixed_bank_steady_avx512(struct helm_fixed_bank * const b,
+                              const size_t begin,
+                              const size_t end,
+                              const int32_t * const r,
+                              const int32_t * const u,
+                              const int32_t * const v,
+                              const int32_t * const y,
+                              int32_t * const dv)
+{
+    const __m512i none = _mm512_set1_epi64(HELM_FIXED_NONE);
+    const __m512i zero = _mm512_setzero_si512();
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m512i Y  = helm_fixed_load_avx512(y + i);
+        const __m512i oy = helm_fixed_load_avx512(b->y + i);
+        const __m512i og = helm_fixed_load_avx512(b->g + i);
+        const __m512i oq = helm_fixed_load_avx512(b->q + i);
+        const __m512i S  = helm_fixed_load_avx512(b->shift + i);
+        const __mmask8 skip = _mm512_cmpeq_epi64_mask(Y,  none);
+        const __mmask8 kick = _mm512_cmpeq_epi64_mask(oy, none);
+        const __m512i hy = _mm512_mask_blend_epi64(kick, oy, Y);
+        const __m512i hg = _mm512_mask_blend_epi64(kick, og, zero);
+
+        const __m512i dy = _mm512_sub_epi64(Y, hy);
+        const __m512i t  = helm_fixed_saturate_avx512(_mm512_sub_epi64(
+                hg, _mm512_slli_epi64(dy, HELM_FIXED_GUARD)));
+        const __m512i gn = _mm512_srai_epi64(_mm512_mul_epi32(
+                t, helm_fixed_load_avx512(b->beta + i)), 31);
+        __m512i acc = oq;
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(
+                helm_fixed_load_avx512(b->ki + i),
+                _mm512_sub_epi64(helm_fixed_load_avx512(r + i), Y)));
+        acc = _mm512_add_epi64(acc, _mm512_mul_epi32(
+                helm_fixed_load_avx512(b->kt + i),
+                _mm512_sub_epi64(helm_fixed_load_avx512(u + i),
+                                 helm_fixed_load_avx512(v + i))));
+        acc = _mm512_sub_epi64(acc, _mm512_mul_epi32(
+                helm_fixed_load_avx512(b->kp + i), dy));
+        acc = _mm512_add_epi64(acc, _mm512_srai_epi64(_mm512_mul_epi32(
+                helm_fixed_load_avx512(b->kd + i),
+                _mm512_sub_epi64(gn, hg)), HELM_FIXED_GUARD));
+        const __m512i d  = _mm512_srav_epi64(acc, S);
+        const __m512i qn = _mm512_sub_epi64(acc, _mm512_sllv_epi64(d, S));
+
+        helm_fixed_store_avx512(dv + i, _mm512_mask_blend_epi64(
+                skip, helm_fixed_saturate_avx512(d), zero));
+        helm_fixed_store_avx512(b->y + i,
+                                _mm512_mask_blend_epi64(skip, Y,  oy));
+        helm_fixed_store_avx512(b->g + i,
+                                _mm512_mask_blend_epi64(skip, gn, og));
+        helm_fixed_store_avx512(b->q + i,
+                                _mm512_mask_blend_epi64(skip, qn, oq));
+    }
+    return i;
+}
+
+#endif /* HELM_FIXED_X86 */
+
+/**
+ * \brief Find the integer control increments steadying every process.
+ *
+ * Lane by lane, the result is bit-identical to invoking helm_fixed_steady()
+ * on each controller within the bank.  Arrays must not overlap those within
+ * \c b.
+ *
+ * \param[in,out] b  Coefficients and state maintained across invocations.
+ * \param[in]     r  Reference values in counts.
+ * \param[in]     u  Actuator positions currently observed in counts.
+ * \param[in]     v  Actuator positions currently requested in counts.
+ * \param[in]     y  Observed process outputs in counts or #HELM_FIXED_NONE.
+ * \param[out]    dv Incremental suggested changes to \c v in counts.
+ *                   May alias any one of \c r, \c u, \c v, or \c y.
+ *
+ * \return Argument \c b to permit call chaining.
+ */
+static inline
+struct helm_fixed_bank *
+helm_fixed_bank_steady(struct helm_fixed_bank * const b,
+                       const int32_t * const r,
+                       const int32_t * const u,
+                       const int32_t * const v,
+                       const int32_t * const y,
+                       int32_t * const dv)
+{
+    size_t i = 0;
+#if HELM_FIXED_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        i = helm_fixed_bank_steady_avx512(b, i, b->n, r, u, v, y, dv);
+    } else if (__builtin_cpu_supports("avx2")) {
+        i = helm_fixed_bank_steady_avx2(b, i, b->n, r, u, v, y, dv);
+    }
+#endif
+    helm_fixed_bank_steady_scalar(b, i, b->n, r, u, v, y, dv);
+    return b;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_FIXED_H */
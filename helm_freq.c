@@ -0,0 +1,61 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_freq.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_freq.h"
+
+extern
+size_t
+helm_freq_bytes(const size_t n);
+
+extern
+int
+helm_freq_init(struct helm_freq * const g,
+               const size_t n,
+               const double wlo,
+               double whi,
+               const struct helm_plant * const p,
+               const size_t delay,
+               const double Ta,
+               void * const mem);
+
+extern
+double *
+helm_freq_coeffs(const struct helm_freq * const g,
+                 const struct helm_state * const h,
+                 double c[HELM_FREQ_NCOEFF]);
+
+extern
+void
+helm_freq_loop_scalar(struct helm_freq * const g,
+                      const size_t begin,
+                      const size_t end,
+                      const double c[HELM_FREQ_NCOEFF]);
+
+extern
+struct helm_freq *
+helm_freq_loop(struct helm_freq * const g,
+               const struct helm_state * const h);
+
+extern
+struct helm_freq_margins *
+helm_freq_margins(const struct helm_freq * const g,
+                  struct helm_freq_margins * const m);
+
+extern
+struct helm_freq_margins *
+helm_freq_analyze(struct helm_freq * const g,
+                  const struct helm_state * const h,
+                  struct helm_freq_margins * const m);
@@ -0,0 +1,560 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_FREQ_H
+#define HELM_FREQ_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "helm.h"
+#include "helm_plant.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HELM_FREQ_X86 1  ///< AVX2/AVX-512 kernels with runtime dispatch
+#else
+#define HELM_FREQ_X86 0  ///< Portable scalar kernel only
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Frequency response and stability margins of a loop closed by
+ * helm_steady() around a helm_plant.
+ *
+ * Writing \f$q = z^{-1}\f$ for the unit delay, \f$\alpha = \Delta t / (T_f
+ * + \Delta t)\f$, and \f$\beta = 1 - \alpha\f$, the filter within
+ * helm_steady() obeys \f$f = \alpha y / (1 - \beta q)\f$ and so the
+ * derivative action \f$(T_d/T_f)(\Delta f - \Delta y)\f$ becomes
+ * \f$-(T_d/T_f)\,\beta\,(1-q)^2 y / (1 - \beta q)\f$.  Every call computes
+ * its increment from the current measurement while the requested signal
+ * \f$v\f$ and the observed actuator position \f$u\f$ are those of the
+ * previous step.  The actuator is modeled as the discrete lag \f$w_k = \rho
+ * w_{k-1} + (1 - \rho) v_k\f$ with \f$\rho = e^{-\Delta t / T_a}\f$, which
+ * is ideal when \f$T_a = 0\f$, so that the automatic reset term \f$(u -
+ * v)/T_t\f$ feeds back \f$q (w - v)\f$.  Eliminating \f$v\f$ and \f$w\f$,
+ * the loop transfer function from process output back to itself is
+ * \f{align}{
+ *     L(q) &= \frac{(1 - \rho)\,\left[
+ *                 \left(k_i + k_p (1 - q)\right) (1 - \beta q)
+ *               + k_d (1 - q)^2 \right]}
+ *              {(1 - q)\,(1 - \beta q)\,(1 - \gamma q)} \, P(q)
+ * \f}
+ * with \f$k_i = k_p \Delta t / T_i\f$, \f$k_d = k_p \beta T_d / T_f\f$,
+ * and \f$\gamma = \rho (1 - k_p \Delta t / T_t)\f$.  The reset time scale
+ * matters only through a lagging actuator.
+ *
+ * Process response \f$P(q)\f$ follows from the propagator \f$(\Phi,
+ * \Gamma)\f$ of a helm_plant at step size \f$\Delta t\f$ together with any
+ * whole-step dead time \f$d\f$.  Faddeev--LeVerrier recursion yields the
+ * characteristic polynomial of \f$\Phi\f$ and the adjugate of \f$zI -
+ * \Phi\f$ as polynomials, giving \f$P = q^d\, C \operatorname{adj}(zI -
+ * \Phi) \Gamma / \det(zI - \Phi)\f$ as a ratio of polynomials in \f$q\f$.
+ *
+ * Everything depending only upon the process, namely \f$q\f$ and \f$P\f$ at
+ * each frequency, is tabulated once by helm_freq_init().  Screening a
+ * candidate tuning by helm_freq_loop() then costs roughly thirty flops and
+ * one division per frequency across structure-of-arrays data, which on x86
+ * runs four or eight frequencies at a time using AVX2 or AVX-512 kernels
+ * selected at runtime.  From the tabulated \f$L\f$, helm_freq_margins()
+ * interpolates gain and phase crossovers and finds the sensitivity peak
+ * \f$M_s = \max \left|1 / (1 + L)\right|\f$.  Margins presume an
+ * open loop that is stable apart from the integrator.
+ *
+ * Sample usage screening candidate tunings against one process:
+ * \code
+ *   struct helm_freq g;
+ *   struct helm_freq_margins m;
+ *   helm_freq_init(&g, 2048, 1e-3, HELM_FREQ_PI/dt, &plant, 0, 0,
+ *                  malloc(helm_freq_bytes(2048)));
+ *   for (size_t k = 0; k < ncandidates; ++k) {
+ *       helm_freq_loop(&g, &candidate[k]);
+ *       helm_freq_margins(&g, &m);
+ *       // ...accept candidate k when m.gm, m.pm, and m.ms suffice...
+ *   }
+ * \endcode
+ */
+
+/** The ratio of a circle's circumference to its diameter. */
+#define HELM_FREQ_PI 3.14159265358979323846
+
+/** Alignment and padding, in bytes, applied to each array of a helm_freq. */
+#define HELM_FREQ_ALIGN 64
+
+/**
+ * Process response tabulated at \c n frequencies along with scratch for the
+ * loop response of one candidate tuning.
+ */
+struct helm_freq
+{
+    size_t  n;    /**< Number of frequencies.                          */
+    double  dt;   /**< Sampling interval.                              */
+    double  rho;  /**< Actuator pole \f$e^{-\Delta t/T_a}\f$.          */
+    double *w;    /**< Frequencies in radians per unit time.           */
+    double *qr;   /**< Real part of \f$q = e^{-i\omega\Delta t}\f$.    */
+    double *qi;   /**< Imaginary part of \f$q\f$.                      */
+    double *pr;   /**< Real part of process response \f$P\f$.          */
+    double *pi;   /**< Imaginary part of \f$P\f$.                      */
+    double *lr;   /**< Real part of loop response \f$L\f$.             */
+    double *li;   /**< Imaginary part of \f$L\f$.                      */
+};
+
+/** Stability margins found by helm_freq_margins(). */
+struct helm_freq_margins
+{
+    double gm;   /**< Gain margin as a factor, infinite absent crossover.  */
+    double wpc;  /**< Phase crossover frequency for #gm, or NaN.           */
+    double pm;   /**< Phase margin in degrees, infinite absent crossover.  */
+    double wgc;  /**< Gain crossover frequency for #pm, or NaN.            */
+    double ms;   /**< Sensitivity peak \f$\max |1/(1 + L)|\f$.             */
+    double wms;  /**< Frequency of #ms.                                    */
+};
+
+/**
+ * \brief Bytes of storage required by helm_freq_init() for \c n frequencies.
+ *
+ * Each of the seven arrays is padded to a multiple of #HELM_FREQ_ALIGN bytes.
+ */
+static inline
+size_t
+helm_freq_bytes(const size_t n)
+{
+    const size_t per = HELM_FREQ_ALIGN / sizeof(double);
+    return 7 * ((n + per - 1) / per) * per * sizeof(double);
+}
+
+/**
+ * \brief Tabulate the response of process \c p at \c n log-spaced
+ * frequencies within <tt>[wlo, whi]</tt>.
+ *
+ * The sampling interval is that of the propagator within \c p.  Frequencies
+ * beyond Nyquist, \f$\pi / \Delta t\f$, are clamped to it.
+ *
+ * \param[out] g     Table to be initialized.
+ * \param[in]  n     Number of frequencies, at least two.
+ * \param[in]  wlo   Least frequency in radians per unit time.
+ * \param[in]  whi   Greatest frequency in radians per unit time.
+ * \param[in]  p     Process and propagator, e.g. from helm_plant_init().
+ * \param[in]  delay Whole steps of dead time as applied by helm_delay.
+ * \param[in]  Ta    Actuator lag time scale, zero for an ideal actuator.
+ * \param[in]  mem   At least helm_freq_bytes(n) bytes of storage.
+ *
+ * \return Zero on success or nonzero on invalid arguments.
+ */
+static inline
+int
+helm_freq_init(struct helm_freq * const g,
+               const size_t n,
+               const double wlo,
+               double whi,
+               const struct helm_plant * const p,
+               const size_t delay,
+               const double Ta,
+               void * const mem)
+{
+    const double dt = p->h;
+    whi = fmin(whi, HELM_FREQ_PI / dt);
+    if (n < 2 || !(wlo > 0) || !(whi > wlo) || !(Ta >= 0)) {
+        return 1;
+    }
+
+    const size_t per    = HELM_FREQ_ALIGN / sizeof(double);
+    const size_t stride = ((n + per - 1) / per) * per;
+    double * const m    = (double *) mem;
+    g->n   = n;
+    g->dt  = dt;
+    g->rho = Ta > 0 ? exp(-dt / Ta) : 0;
+    g->w   = m + 0*stride;
+    g->qr  = m + 1*stride;
+    g->qi  = m + 2*stride;
+    g->pr  = m + 3*stride;
+    g->pi  = m + 4*stride;
+    g->lr  = m + 5*stride;
+    g->li  = m + 6*stride;
+
+    // Faddeev--LeVerrier: det(zI - Phi) = sum c[k] z^(n-k) and
+    // adj(zI - Phi) = sum M_k z^(n-k) so C adj Gamma = sum b[k] z^(n-k)
+    const size_t o = p->n;
+    double c[HELM_PLANT_MAX + 1], b[HELM_PLANT_MAX + 1];
+    double M[HELM_PLANT_MAX][HELM_PLANT_MAX], T[HELM_PLANT_MAX][HELM_PLANT_MAX];
+    c[0] = 1;
+    b[0] = 0;
+    for (size_t i = 0; i < o; ++i) {
+        for (size_t j = 0; j < o; ++j) {
+            M[i][j] = i == j;
+        }
+    }
+    for (size_t k = 1; k <= o; ++k) {
+        if (k > 1) {                                  // M_k = Phi M + c I
+            for (size_t i = 0; i < o; ++i) {
+                for (size_t j = 0; j < o; ++j) {
+                    M[i][j] = T[i][j] + (i == j ? c[k-1] : 0);
+                }
+            }
+        }
+        b[k] = 0;
+        for (size_t i = 0; i < o; ++i) {
+            for (size_t j = 0; j < o; ++j) {
+                b[k] += p->b[i] * M[i][j] * p->Gamma[j];
+            }
+        }
+        double trace = 0;
+        for (size_t i = 0; i < o; ++i) {              // T = Phi M_k
+            for (size_t j = 0; j < o; ++j) {
+                T[i][j] = 0;
+                for (size_t l = 0; l < o; ++l) {
+                    T[i][j] += p->Phi[i][l] * M[l][j];
+                }
+            }
+            trace += T[i][i];
+        }
+        c[k] = -trace / k;
+    }
+
+    // Evaluate P(q) = q^d sum b[k] q^k / sum c[k] q^k at each frequency
+    const double ratio = log(whi / wlo) / (n - 1);
+    for (size_t i = 0; i < n; ++i) {
+        const double w  = i + 1 < n ? wlo * exp(ratio * i) : whi;
+        const double qr = cos(w * dt), qi = -sin(w * dt);
+        double nr = b[o], ni = 0, dr = c[o], di = 0;
+        for (size_t k = o; k-- > 0;) {                // Horner in q
+            const double tr = nr*qr - ni*qi, ti = nr*qi + ni*qr;
+            nr = tr + b[k];
+            ni = ti;
+            const double sr = dr*qr - di*qi, si = dr*qi + di*qr;
+            dr = sr + c[k];
+            di = si;
+        }
+        const double er = cos(delay * w * dt), ei = -sin(delay * w * dt);
+        const double xr = nr*er - ni*ei, xi = nr*ei + ni*er;  // Dead time
+        const double s  = 1 / (dr*dr + di*di);
+        g->w [i] = w;
+        g->qr[i] = qr;
+        g->qi[i] = qi;
+        g->pr[i] = (xr*dr + xi*di) * s;
+        g->pi[i] = (xi*dr - xr*di) * s;
+        g->lr[i] = NAN;
+        g->li[i] = NAN;
+    }
+    return 0;
+}
+
+/** Indices of the coefficients produced by helm_freq_coeffs(). */
+enum helm_freq_coeff
+{
+    HELM_FREQ_KP,     /**< Proportional gain \f$k_p\f$.                  */
+    HELM_FREQ_KI,     /**< Integral gain \f$k_p \Delta t / T_i\f$.       */
+    HELM_FREQ_KD,     /**< Derivative gain \f$k_p \beta T_d / T_f\f$.    */
+    HELM_FREQ_BETA,   /**< Filter pole \f$\beta\f$.                      */
+    HELM_FREQ_GAMMA,  /**< Reset pole \f$\gamma\f$.                      */
+    HELM_FREQ_GAIN,   /**< Actuator gain \f$1 - \rho\f$.                 */
+    HELM_FREQ_NCOEFF  /**< Number of coefficients.                      */
+};
+
+/**
+ * \brief Compute the coefficients of \f$L(q)\f$ for tuning \c h.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+double *
+helm_freq_coeffs(const struct helm_freq * const g,
+                 const struct helm_state * const h,
+                 double c[HELM_FREQ_NCOEFF])
+{
+    const double dt = g->dt;
+    const double a  = dt / (h->Tf + dt);  // Identical to helm_steady()
+    c[HELM_FREQ_KP]    = h->kp;
+    c[HELM_FREQ_KI]    = h->kp * dt / h->Ti;
+    c[HELM_FREQ_KD]    = h->kp * (h->Td / h->Tf) * (1 - a);
+    c[HELM_FREQ_BETA]  = 1 - a;
+    c[HELM_FREQ_GAMMA] = g->rho * (1 - h->kp * dt / h->Tt);
+    c[HELM_FREQ_GAIN]  = 1 - g->rho;
+    return c;
+}
+
+/**
+ * \brief Scalar kernel computing \f$L\f$ at frequencies <tt>[begin,
+ * end)</tt> of \c g from coefficients \c c.
+ */
+static inline
+void
+helm_freq_loop_scalar(struct helm_freq * const g,
+                      const size_t begin,
+                      const size_t end,
+                      const double c[HELM_FREQ_NCOEFF])
+{
+    const double kp = c[HELM_FREQ_KP],   ki = c[HELM_FREQ_KI];
+    const double kd = c[HELM_FREQ_KD],   be = c[HELM_FREQ_BETA];
+    const double ga = c[HELM_FREQ_GAMMA], k = c[HELM_FREQ_GAIN];
+    for (size_t i = begin; i < end; ++i) {
+        const double qr = g->qr[i], qi = g->qi[i];
+        const double wr = 1 - qr,      wi = -qi;       // 1 - q
+        const double ar = ki + kp*wr,  ai = kp*wi;     // ki + kp (1 - q)
+        const double er = 1 - be*qr,   ei = -be*qi;    // 1 - beta q
+        const double fr = 1 - ga*qr,   fi = -ga*qi;    // 1 - gamma q
+        const double nr = ar*er - ai*ei + kd*(wr*wr - wi*wi);
+        const double ni = ar*ei + ai*er + kd*(2*wr*wi);
+        const double tr = nr*g->pr[i] - ni*g->pi[i];   // Numerator times P
+        const double ti = nr*g->pi[i] + ni*g->pr[i];
+        const double xr = wr*er - wi*ei, xi = wr*ei + wi*er;
+        const double dr = xr*fr - xi*fi, di = xr*fi + xi*fr;
+        const double s  = k / (dr*dr + di*di);
+        g->lr[i] = (tr*dr + ti*di) * s;
+        g->li[i] = (ti*dr - tr*di) * s;
+    }
+}
+
+#if HELM_FREQ_X86
+
+/**
+ * \brief AVX2 kernel computing \f$L\f$ at frequencies
+ * <tt>[begin, end)</tt>.
+ */
+__attribute__((target("avx2")))
+static inline
+size_t
+helm_freq_loop_avx2(struct helm_freq * const g,
+                    const size_t begin,
+                    const size_t end,
+                    const double c[HELM_FREQ_NCOEFF])
+{
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d kp  = _mm256_set1_pd(c[HELM_FREQ_KP]);
+    const __m256d ki  = _mm256_set1_pd(c[HELM_FREQ_KI]);
+    const __m256d kd  = _mm256_set1_pd(c[HELM_FREQ_KD]);
+    const __m256d be  = _mm256_set1_pd(c[HELM_FREQ_BETA]);
+    const __m256d ga  = _mm256_set1_pd(c[HELM_FREQ_GAMMA]);
+    const __m256d k   = _mm256_set1_pd(c[HELM_FREQ_GAIN]);
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        const __m256d qr = _mm256_loadu_pd(g->qr + i);
+        const __m256d qi = _mm256_loadu_pd(g->qi + i);
+        const __m256d pr = _mm256_loadu_pd(g->pr + i);
+        const __m256d pi = _mm256_loadu_pd(g->pi + i);
+        const __m256d wr = _mm256_sub_pd(one, qr);
+        const __m256d wi = _mm256_sub_pd(_mm256_setzero_pd(), qi);
+        const __m256d ar = _mm256_add_pd(ki, _mm256_mul_pd(kp, wr));
+        const __m256d ai = _mm256_mul_pd(kp, wi);
+        const __m256d er = _mm256_sub_pd(one, _mm256_mul_pd(be, qr));
+        const __m256d ei = _mm256_sub_pd(_mm256_setzero_pd(),
+                                         _mm256_mul_pd(be, qi));
+        const __m256d fr = _mm256_sub_pd(one, _mm256_mul_pd(ga, qr));
+        const __m256d fi = _mm256_sub_pd(_mm256_setzero_pd(),
+                                         _mm256_mul_pd(ga, qi));
+        const __m256d nr = _mm256_add_pd(
+            _mm256_sub_pd(_mm256_mul_pd(ar, er), _mm256_mul_pd(ai, ei)),
+            _mm256_mul_pd(kd, _mm256_sub_pd(_mm256_mul_pd(wr, wr),
+                                            _mm256_mul_pd(wi, wi))));
+        const __m256d ni = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(ar, ei), _mm256_mul_pd(ai, er)),
+            _mm256_mul_pd(kd, _mm256_mul_pd(_mm256_add_pd(wr, wr), wi)));
+        const __m256d tr = _mm256_sub_pd(_mm256_mul_pd(nr, pr),
+                                         _mm256_mul_pd(ni, pi));
+        const __m256d ti = _mm256_add_pd(_mm256_mul_pd(nr, pi),
+                                         _mm256_mul_pd(ni, pr));
+        const __m256d xr = _mm256_sub_pd(_mm256_mul_pd(wr, er),
+                                         _mm256_mul_pd(wi, ei));
+        const __m256d xi = _mm256_add_pd(_mm256_mul_pd(wr, ei),
+                                         _mm256_mul_pd(wi, er));
+        const __m256d dr = _mm256_sub_pd(_mm256_mul_pd(xr, fr),
+                                         _mm256_mul_pd(xi, fi));
+        const __m256d di = _mm256_add_pd(_mm256_mul_pd(xr, fi),
+                                         _mm256_mul_pd(xi, fr));
+        const __m256d s  = _mm256_div_pd(k, _mm256_add_pd(
+                                                _mm256_mul_pd(dr, dr),
+                                                _mm256_mul_pd(di, di)));
+        _mm256_storeu_pd(g->lr + i, _mm256_mul_pd(_mm256_add_pd(
+            _mm256_mul_pd(tr, dr), _mm256_mul_pd(ti, di)), s));
+        _mm256_storeu_pd(g->li + i, _mm256_mul_pd(_mm256_sub_pd(
+            _mm256_mul_pd(ti, dr), _mm256_mul_pd(tr, di)), s));
+    }
+    return i;
+}
+
+/**
+ * \brief AVX-512 kernel computing \f$L\f$ at frequencies
+ * <tt>[begin, end)</tt>.
+ */
+__attribute__((target("avx512f")))
+static inline
+size_t
+helm_freq_loop_avx512(struct helm_freq * const g,
+                      const size_t begin,
+                      const size_t end,
+                      const double c[HELM_FREQ_NCOEFF])
+{
+    const __m512d one = _mm512_set1_pd(1);
+    const __m512d kp  = _mm512_set1_pd(c[HELM_FREQ_KP]);
+    const __m512d ki  = _mm512_set1_pd(c[HELM_FREQ_KI]);
+    const __m512d kd  = _mm512_set1_pd(c[HELM_FREQ_KD]);
+    const __m512d be  = _mm512_set1_pd(c[HELM_FREQ_BETA]);
+    const __m512d ga  = _mm512_set1_pd(c[HELM_FREQ_GAMMA]);
+    const __m512d k   = _mm512_set1_pd(c[HELM_FREQ_GAIN]);
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m512d qr = _mm512_loadu_pd(g->qr + i);
+        const __m512d qi = _mm512_loadu_pd(g->qi + i);
+        const __m512d pr = _mm512_loadu_pd(g->pr + i);
+        const __m512d pi = _mm512_loadu_pd(g->pi + i);
+        const __m512d wr = _mm512_sub_pd(one, qr);
+        const __m512d wi = _mm512_sub_pd(_mm512_setzero_pd(), qi);
+        const __m512d ar = _mm512_add_pd(ki, _mm512_mul_pd(kp, wr));
+        const __m512d ai = _mm512_mul_pd(kp, wi);
+        const __m512d er = _mm512_sub_pd(one, _mm512_mul_pd(be, qr));
+        const __m512d ei = _mm512_sub_pd(_mm512_setzero_pd(),
+                                         _mm512_mul_pd(be, qi));
+        const __m512d fr = _mm512_sub_pd(one, _mm512_mul_pd(ga, qr));
+        const __m512d fi = _mm512_sub_pd(_mm512_setzero_pd(),
+                                         _mm512_mul_pd(ga, qi));
+        const __m512d nr = _mm512_add_pd(
+            _mm512_sub_pd(_mm512_mul_pd(ar, er), _mm512_mul_pd(ai, ei)),
+            _mm512_mul_pd(kd, _mm512_sub_pd(_mm512_mul_pd(wr, wr),
+                                            _mm512_mul_pd(wi, wi))));
+        const __m512d ni = _mm512_add_pd(
+            _mm512_add_pd(_mm512_mul_pd(ar, ei), _mm512_mul_pd(ai, er)),
+            _mm512_mul_pd(kd, _mm512_mul_pd(_mm512_add_pd(wr, wr), wi)));
+        const __m512d tr = _mm512_sub_pd(_mm512_mul_pd(nr, pr),
+                                         _mm512_mul_pd(ni, pi));
+        const __m512d ti = _mm512_add_pd(_mm512_mul_pd(nr, pi),
+                                         _mm512_mul_pd(ni, pr));
+        const __m512d xr = _mm512_sub_pd(_mm512_mul_pd(wr, er),
+                                         _mm512_mul_pd(wi, ei));
+        const __m512d xi = _mm512_add_pd(_mm512_mul_pd(wr, ei),
+                                         _mm512_mul_pd(wi, er));
+        const __m512d dr = _mm512_sub_pd(_mm512_mul_pd(xr, fr),
+                                         _mm512_mul_pd(xi, fi));
+        const __m512d di = _mm512_add_pd(_mm512_mul_pd(xr, fi),
+                                         _mm512_mul_pd(xi, fr));
+        const __m512d s  = _mm512_div_pd(k, _mm512_add_pd(
+                                                _mm512_mul_pd(dr, dr),
+                                                _mm512_mul_pd(di, di)));
+        _mm512_storeu_pd(g->lr + i, _mm512_mul_pd(_mm512_add_pd(
+            _mm512_mul_pd(tr, dr), _mm512_mul_pd(ti, di)), s));
+        _mm512_storeu_pd(g->li + i, _mm512_mul_pd(_mm512_sub_pd(
+            _mm512_mul_pd(ti, dr), _mm512_mul_pd(tr, di)), s));
+    }
+    return i;
+}
+
+#endif /* HELM_FREQ_X86 */
+
+/**
+ * \brief Tabulate loop response \f$L\f$ for tuning \c h into \c g->lr and
+ * \c g->li at every frequency.
+ *
+ * Transient state within \c h is ignored.  Every kernel evaluates the same
+ * operations in the same order so results do not depend on the kernel.
+ *
+ * \return Argument \c g to permit call chaining.
+ */
+static inline
+struct helm_freq *
+helm_freq_loop(struct helm_freq * const g,
+               const struct helm_state * const h)
+{
+    double c[HELM_FREQ_NCOEFF];
+    helm_freq_coeffs(g, h, c);
+    size_t i = 0;
+#if HELM_FREQ_X86
+    if (__builtin_cpu_supports("avx512f")) {
+        i = helm_freq_loop_avx512(g, i, g->n, c);
+    } else if (__builtin_cpu_supports("avx2")) {
+        i = helm_freq_loop_avx2(g, i, g->n, c);
+    }
+#endif
+    helm_freq_loop_scalar(g, i, g->n, c);
+    return g;
+}
+
+/**
+ * \brief Find stability margins from the loop response within \c g.
+ *
+ * Crossings between adjacent frequencies are located by linear
+ * interpolation of \f$L\f$.  Where several gain or phase crossovers exist,
+ * the least margin is reported.  A phase margin is the angle of \f$-L\f$ at
+ * gain crossover so that negative values indicate instability.
+ *
+ * \param[in]  g Table after helm_freq_loop().
+ * \param[out] m Margins found.
+ * \return Argument \c m to permit call chaining.
+ */
+static inline
+struct helm_freq_margins *
+helm_freq_margins(const struct helm_freq * const g,
+                  struct helm_freq_margins * const m)
+{
+    m->gm  = INFINITY;
+    m->wpc = NAN;
+    m->pm  = INFINITY;
+    m->wgc = NAN;
+    m->ms  = NAN;
+    m->wms = NAN;
+
+    double least = INFINITY;               // Least |1 + L|^2
+    for (size_t i = 0; i < g->n; ++i) {
+        const double lr = g->lr[i], li = g->li[i];
+        const double s  = (1 + lr)*(1 + lr) + li*li;
+        if (s < least) {
+            least  = s;
+            m->wms = g->w[i];
+        }
+        if (i == 0) {
+            continue;
+        }
+        const double pr = g->lr[i-1], pi = g->li[i-1];
+
+        // Gain crossover where |L| passes through one
+        const double a0 = pr*pr + pi*pi, a1 = lr*lr + li*li;
+        if ((a0 - 1) * (a1 - 1) <= 0 && a0 != a1) {
+            const double t  = (sqrt(a0) - 1) / (sqrt(a0) - sqrt(a1));
+            const double xr = pr + t*(lr - pr), xi = pi + t*(li - pi);
+            const double pm = atan2(-xi, -xr) * (180 / HELM_FREQ_PI);
+            if (pm < m->pm) {
+                m->pm  = pm;
+                m->wgc = g->w[i-1] + t*(g->w[i] - g->w[i-1]);
+            }
+        }
+
+        // Phase crossover where L passes through the negative real axis
+        if (pi * li <= 0 && pi != li) {
+            const double t  = pi / (pi - li);
+            const double xr = pr + t*(lr - pr);
+            if (xr < 0 && -1 / xr < m->gm) {
+                m->gm  = -1 / xr;
+                m->wpc = g->w[i-1] + t*(g->w[i] - g->w[i-1]);
+            }
+        }
+    }
+    m->ms = 1 / sqrt(least);
+    return m;
+}
+
+/**
+ * \brief Tabulate the loop response for \c h and find its margins.
+ * \return Argument \c m to permit call chaining.
+ */
+static inline
+struct helm_freq_margins *
+helm_freq_analyze(struct helm_freq * const g,
+                  const struct helm_state * const h,
+                  struct helm_freq_margins * const m)
+{
+    return helm_freq_margins(helm_freq_loop(g, h), m);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_FREQ_H */
@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_gain.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_gain.h"
+
+extern
+size_t
+helm_gain_bytes(const size_t nx,
+                const size_t ny);
+
+extern
+struct helm_gain *
+helm_gain_init(struct helm_gain * const g,
+               const size_t nx,
+               const size_t ny,
+               void * const mem);
+
+extern
+struct helm_gain *
+helm_gain_set(struct helm_gain * const g,
+              const size_t i,
+              const size_t j,
+              const struct helm_state * const h);
+
+extern
+struct helm_gain_cursor *
+helm_gain_cursor_init(struct helm_gain_cursor * const c);
+
+extern
+double
+helm_gain_bracket(const double * const x,
+                  const size_t n,
+                  const double s,
+                  size_t * const cache);
+
+extern
+int
+helm_gain_apply(const struct helm_gain * const g,
+                struct helm_gain_cursor * const c,
+                const double sx,
+                double sy,
+                struct helm_state * const h);
+
+extern
+double
+helm_steady_scheduled(struct helm_state * const h,
+                      const struct helm_gain * const g,
+                      struct helm_gain_cursor * const c,
+                      const double sx,
+                      const double sy,
+                      const double dt,
+                      const double r,
+                      const double u,
+                      const double v,
+                      const double y);
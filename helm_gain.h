@@ -0,0 +1,307 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_GAIN_H
+#define HELM_GAIN_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "helm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Gain scheduling from a compact 1-D or 2-D table of tuning parameters.
+ *
+ * Parameter sets are tabulated at sorted breakpoints of one or two
+ * scheduling variables, e.g. flow rate or flow rate and temperature.  Each
+ * step, helm_gain_apply() locates the bracketing breakpoints, interpolates
+ * linearly or bilinearly, and writes the result into a helm_state.  Because
+ * helm_steady() is incremental and only tuning parameters are written,
+ * transient state \c y and \c f carry across every change and scheduling is
+ * bumpless without any call to helm_approach().
+ *
+ * Each tabulated point stores \f$k_p\f$, \f$T_d\f$, \f$1/T_f\f$,
+ * \f$1/T_i\f$, and \f$1/T_t\f$ contiguously so a lookup touches at most four
+ * adjacent records.  Interpolating reciprocal time scales interpolates
+ * integral and reset gains, which is customary, and permits disabled terms
+ * having infinite time scales to blend with enabled ones.
+ *
+ * Tables are read-only once built and may be shared by many controllers
+ * and threads.  Each controller pairs with its own helm_gain_cursor caching
+ * the most recent bracket along each axis.  When the scheduling variable
+ * stays within it, as it does almost always, lookup costs two comparisons.
+ * The edge brackets extend beyond the table so that a variable pinned
+ * outside it, e.g. by a saturated plant, also costs two comparisons.
+ * Otherwise a branch-free bisection runs in \f$\log_2 n\f$ conditional
+ * moves.  When the scheduling variables are unchanged since the previous
+ * call nothing is written.  Scheduling variables outside the table are
+ * clamped to its edges while NaN scheduling variables leave the tuning
+ * untouched.
+ *
+ * Sample usage for a 1-D table with caller-provided storage:
+ * \code
+ *   struct helm_gain g;
+ *   struct helm_gain_cursor c;
+ *   helm_gain_init(&g, n, 1, malloc(helm_gain_bytes(n, 1)));
+ *   for (size_t i = 0; i < n; ++i) {
+ *       g.x[i] = flow[i];                 // Strictly increasing
+ *       helm_gain_set(&g, i, 0, &tuned[i]);
+ *   }
+ *   helm_gain_cursor_init(&c);
+ *   for (;;) {
+ *       y  = process(dt, u);
+ *       v += helm_steady_scheduled(&h, &g, &c, flow, 0, dt, r, u, v, y);
+ *       u  = actuate(dt, v);
+ *   }
+ * \endcode
+ */
+
+/** One tabulated parameter set, with time scales stored as reciprocals. */
+struct helm_gain_point
+{
+    double kp;   /**< Unified gain helm_state::kp.               */
+    double Td;   /**< Derivative time scale helm_state::Td.      */
+    double rTf;  /**< Reciprocal filter time scale 1/Tf.         */
+    double rTi;  /**< Reciprocal integral time scale 1/Ti.       */
+    double rTt;  /**< Reciprocal reset time scale 1/Tt.          */
+};
+
+/**
+ * A gain schedule tabulated on an \c nx by \c ny grid, where \c ny is one
+ * for a 1-D schedule.  Point <tt>(i, j)</tt> lies at <tt>p[i*ny + j]</tt>.
+ */
+struct helm_gain
+{
+    size_t                  nx;  /**< Breakpoints along the first axis.   */
+    size_t                  ny;  /**< Breakpoints along the second axis.  */
+    double                 *x;   /**< Strictly increasing, length #nx.     */
+    double                 *y;   /**< Strictly increasing, length #ny.     */
+    struct helm_gain_point *p;   /**< Tabulated parameter sets.            */
+};
+
+/**
+ * Per-controller lookup state for a helm_gain.  Reinitialize whenever the
+ * table is modified.
+ */
+struct helm_gain_cursor
+{
+    size_t ix;  /**< Cached bracket along the first axis.  */
+    size_t iy;  /**< Cached bracket along the second axis. */
+    double sx;  /**< Previously applied first variable.    */
+    double sy;  /**< Previously applied second variable.   */
+};
+
+/** \brief Bytes of storage required by helm_gain_init(). */
+static inline
+size_t
+helm_gain_bytes(const size_t nx,
+                const size_t ny)
+{
+    return (nx + ny) * sizeof(double)
+         + nx * ny * sizeof(struct helm_gain_point);
+}
+
+/**
+ * \brief Carve an \c nx by \c ny schedule from caller-provided storage.
+ *
+ * Breakpoints and points are left for the caller to set.
+ *
+ * \param[out] g   Schedule to be initialized.
+ * \param[in]  nx  Breakpoints along the first axis, at least one.
+ * \param[in]  ny  Breakpoints along the second axis, one for 1-D schedules.
+ * \param[in]  mem At least helm_gain_bytes(nx, ny) bytes of storage
+ *                 aligned suitably for \c double.
+ * \return Argument \c g to permit call chaining.
+ */
+static inline
+struct helm_gain *
+helm_gain_init(struct helm_gain * const g,
+               const size_t nx,
+               const size_t ny,
+               void * const mem)
+{
+    assert(nx >= 1 && ny >= 1);
+    g->nx = nx;
+    g->ny = ny;
+    g->p  = (struct helm_gain_point *) mem;
+    g->x  = (double *) (g->p + nx*ny);
+    g->y  = g->x + nx;
+    for (size_t j = 0; j < ny; ++j) {
+        g->y[j] = (double) j;             // Harmless default for 1-D
+    }
+    return g;
+}
+
+/**
+ * \brief Tabulate the tuning parameters of \c h at point <tt>(i, j)</tt>.
+ * Transient state within \c h is ignored.
+ * \return Argument \c g to permit call chaining.
+ */
+static inline
+struct helm_gain *
+helm_gain_set(struct helm_gain * const g,
+              const size_t i,
+              const size_t j,
+              const struct helm_state * const h)
+{
+    assert(i < g->nx && j < g->ny);
+    struct helm_gain_point * const q = &g->p[i*g->ny + j];
+    q->kp  = h->kp;
+    q->Td  = h->Td;
+    q->rTf = 1 / h->Tf;
+    q->rTi = 1 / h->Ti;
+    q->rTt = 1 / h->Tt;
+    return g;
+}
+
+/**
+ * \brief Initialize \c c so that the next helm_gain_apply() writes.
+ * \return Argument \c c to permit call chaining.
+ */
+static inline
+struct helm_gain_cursor *
+helm_gain_cursor_init(struct helm_gain_cursor * const c)
+{
+    c->ix = 0;
+    c->iy = 0;
+    c->sx = NAN;
+    c->sy = NAN;
+    return c;
+}
+
+/**
+ * \brief Locate \c i with <tt>x[i] <= s < x[i+1]</tt>, clamped to
+ * <tt>[0, n-2]</tt>, trying the cached bracket \c *cache first.
+ *
+ * The first bracket also holds every \c s below the table and the last
+ * every \c s at or above its end, so that a clamped variable revalidates
+ * its cached bracket rather than searching again.
+ *
+ * \return Interpolation weight of <tt>x[i+1]</tt> within <tt>[0, 1]</tt>.
+ */
+static inline
+double
+helm_gain_bracket(const double * const x,
+                  const size_t n,
+                  const double s,
+                  size_t * const cache)
+{
+    if (n < 2) {
+        *cache = 0;
+        return 0;
+    }
+    size_t i = *cache;
+    if (!((i == 0 || x[i] <= s) && (i + 2 == n || s < x[i+1]))) {
+        size_t len = n - 1;               // Branch-free lower bound search
+        i = 0;
+        while (len > 1) {
+            const size_t half = len / 2;
+            i   = x[i + half] <= s ? i + half : i;
+            len -= half;
+        }
+        *cache = i;
+    }
+    const double w = (s - x[i]) / (x[i+1] - x[i]);
+    return w < 0 ? 0 : w > 1 ? 1 : w;
+}
+
+/**
+ * \brief Interpolate tuning parameters at <tt>(sx, sy)</tt> into \c h.
+ *
+ * Transient state within \c h is untouched so the change is bumpless.
+ * For 1-D schedules \c sy is ignored.
+ *
+ * \param[in]     g  Schedule providing tuning parameters.
+ * \param[in,out] c  Lookup state dedicated to \c h.
+ * \param[in]     sx First scheduling variable.
+ * \param[in]     sy Second scheduling variable.
+ * \param[in,out] h  Controller whose tuning is written.
+ *
+ * \return Nonzero if and only if parameters were written.
+ */
+static inline
+int
+helm_gain_apply(const struct helm_gain * const g,
+                struct helm_gain_cursor * const c,
+                const double sx,
+                double sy,
+                struct helm_state * const h)
+{
+    if (g->ny < 2) {
+        sy = 0;
+    }
+    if ((sx == c->sx && sy == c->sy) || isnan(sx) || isnan(sy)) {
+        return 0;                         // Unchanged or unknown
+    }
+    c->sx = sx;
+    c->sy = sy;
+
+    const double wx = helm_gain_bracket(g->x, g->nx, sx, &c->ix);
+    const double wy = helm_gain_bracket(g->y, g->ny, sy, &c->iy);
+    const size_t ny = g->ny;
+    const size_t dx = g->nx > 1 ? ny : 0;
+    const size_t dy = ny    > 1 ? 1  : 0;
+    const struct helm_gain_point * const p00 = &g->p[c->ix*ny + c->iy];
+    const struct helm_gain_point * const p10 = p00 + dx;
+    const struct helm_gain_point * const p01 = p00 + dy;
+    const struct helm_gain_point * const p11 = p00 + dx + dy;
+    const double c00 = (1 - wx)*(1 - wy), c10 = wx*(1 - wy);
+    const double c01 = (1 - wx)*wy,       c11 = wx*wy;
+
+#define HELM_GAIN_LERP(m) \
+    (c00*p00->m + c10*p10->m + c01*p01->m + c11*p11->m)
+    h->kp = HELM_GAIN_LERP(kp);
+    h->Td = HELM_GAIN_LERP(Td);
+    h->Tf = 1 / HELM_GAIN_LERP(rTf);
+    h->Ti = 1 / HELM_GAIN_LERP(rTi);
+    h->Tt = 1 / HELM_GAIN_LERP(rTt);
+#undef HELM_GAIN_LERP
+
+    return 1;
+}
+
+/**
+ * \brief Apply the schedule at <tt>(sx, sy)</tt> and then invoke
+ * helm_steady().
+ *
+ * \param[in,out] h  Controller whose tuning is scheduled.
+ * \param[in]     g  Schedule providing tuning parameters.
+ * \param[in,out] c  Lookup state dedicated to \c h.
+ * \param[in]     sx First scheduling variable.
+ * \param[in]     sy Second scheduling variable, ignored for 1-D schedules.
+ * \copydetails helm_steady()
+ */
+static inline
+double
+helm_steady_scheduled(struct helm_state * const h,
+                      const struct helm_gain * const g,
+                      struct helm_gain_cursor * const c,
+                      const double sx,
+                      const double sy,
+                      const double dt,
+                      const double r,
+                      const double u,
+                      const double v,
+                      const double y)
+{
+    helm_gain_apply(g, c, sx, sy, h);
+    return helm_steady(h, dt, r, u, v, y);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_GAIN_H */
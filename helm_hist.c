@@ -0,0 +1,269 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Clocks and export for \ref helm_hist.h along with C99 extern declarations
+ * for its static inline functions.
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <time.h>
+
+#include "helm_hist.h"
+
+extern
+uint64_t
+helm_hist_ticks(void);
+
+extern
+size_t
+helm_hist_index(const uint64_t v);
+
+extern
+uint64_t
+helm_hist_lowest(const size_t k);
+
+extern
+uint64_t
+helm_hist_highest(const size_t k);
+
+extern
+struct helm_hist *
+helm_hist_init(struct helm_hist * const h,
+               const double unit);
+
+extern
+void
+helm_hist_record(struct helm_hist * const h,
+                 const uint64_t v);
+
+extern
+void
+helm_hist_record_shared(struct helm_hist * const h,
+                        const uint64_t v);
+
+extern
+struct helm_hist *
+helm_hist_snapshot(struct helm_hist * const dst,
+                   const struct helm_hist * const src);
+
+extern
+struct helm_hist *
+helm_hist_merge(struct helm_hist * const dst,
+                const struct helm_hist * const src);
+
+extern
+uint64_t
+helm_hist_total(const struct helm_hist * const h);
+
+extern
+double
+helm_hist_quantile(const struct helm_hist * const h,
+                   const double q);
+
+extern
+double
+helm_hist_mean(const struct helm_hist * const h);
+
+/** The bytes "helmhist" read as a little-endian integer. */
+#define MAGIC UINT64_C(0x747369686d6c6568)
+
+/** Layout version, incremented upon any incompatible change. */
+enum { VERSION = 1 };
+
+/** Nanoseconds spent calibrating helm_hist_tick_ns(). */
+enum { CALIBRATE = 10000000 };
+
+/** Bytes within the fixed binary header. */
+enum { HEADER = 48 };
+
+/** Quantiles within the text summary line. */
+static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999, 0.9999 };
+
+uint64_t
+helm_hist_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+double
+helm_hist_tick_ns(void)
+{
+    // Racing first calls each calibrate and store equally valid results
+    static uint64_t cached;
+    uint64_t bits = __atomic_load_n(&cached, __ATOMIC_RELAXED);
+    double ratio;
+    if (bits) {
+        memcpy(&ratio, &bits, sizeof(ratio));
+        return ratio;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    const uint64_t n0 = helm_hist_ns(), t0 = helm_hist_ticks();
+    uint64_t n1, t1;
+    do {
+        n1 = helm_hist_ns();
+        t1 = helm_hist_ticks();
+    } while (n1 - n0 < CALIBRATE);
+    ratio = t1 > t0 ? (double) (n1 - n0) / (double) (t1 - t0) : 1;
+#else
+    ratio = 1;
+#endif
+    memcpy(&bits, &ratio, sizeof(bits));
+    __atomic_store_n(&cached, bits, __ATOMIC_RELAXED);
+    return ratio;
+}
+
+int
+helm_hist_write_text(FILE *out,
+                     const char *label,
+                     const struct helm_hist *h)
+{
+    const uint64_t n = helm_hist_total(h);
+    fprintf(out, "# %s\tcount %llu\tmean %.6g", label,
+            (unsigned long long) n, helm_hist_mean(h));
+    for (size_t j = 0; j < sizeof(quantiles)/sizeof(quantiles[0]); ++j) {
+        fprintf(out, "\tp%g %.6g", 100*quantiles[j],
+                helm_hist_quantile(h, quantiles[j]));
+    }
+    fprintf(out, "\tmax %.6g\n", helm_hist_quantile(h, 1));
+
+    uint64_t seen = 0;
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        if (h->count[k]) {
+            seen += h->count[k];
+            fprintf(out, "%.6g\t%.6g\t%llu\t%.6f\n",
+                    h->unit * (double) helm_hist_lowest(k),
+                    h->unit * (double) helm_hist_highest(k),
+                    (unsigned long long) h->count[k],
+                    (double) seen / (double) n);
+        }
+    }
+    fputc('\n', out);
+    return ferror(out) ? EIO : 0;
+}
+
+/** Encode \c x into 8 little-endian bytes at \c p regardless of host. */
+static
+void
+put_le64(unsigned char * const p, const uint64_t x)
+{
+    for (int k = 0; k < 8; ++k) {
+        p[k] = (unsigned char) (x >> 8*k);
+    }
+}
+
+/** Decode 8 little-endian bytes at \c p regardless of host. */
+static
+uint64_t
+get_le64(const unsigned char * const p)
+{
+    uint64_t x = 0;
+    for (int k = 8; k-- > 0;) {
+        x = (x << 8) | p[k];
+    }
+    return x;
+}
+
+int
+helm_hist_write_binary(FILE *out,
+                       const char *label,
+                       const struct helm_hist *h)
+{
+    const size_t len = strlen(label), pad = (len + 7) / 8 * 8;
+    uint64_t nonempty = 0, unit;
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        nonempty += !!h->count[k];
+    }
+    memcpy(&unit, &h->unit, sizeof(unit));
+
+    unsigned char head[HEADER];
+    put_le64(head +  0, MAGIC);
+    put_le64(head +  8, VERSION | (uint64_t) HELM_HIST_BITS << 32);
+    put_le64(head + 16, HELM_HIST_RANGE | (uint64_t) len << 32);
+    put_le64(head + 24, nonempty);
+    put_le64(head + 32, unit);
+    put_le64(head + 40, h->sum);
+    fwrite(head, sizeof(head), 1, out);
+    fwrite(label, 1, len, out);
+    for (size_t k = len; k < pad; ++k) {
+        fputc(0, out);
+    }
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        if (h->count[k]) {
+            unsigned char pair[16];
+            put_le64(pair + 0, k);
+            put_le64(pair + 8, h->count[k]);
+            fwrite(pair, sizeof(pair), 1, out);
+        }
+    }
+    return ferror(out) ? EIO : 0;
+}
+
+int
+helm_hist_read_binary(FILE *in,
+                      struct helm_hist *h,
+                      char *label,
+                      size_t cap)
+{
+    unsigned char head[HEADER];
+    const size_t got = fread(head, 1, sizeof(head), in);
+    if (!got && feof(in)) {
+        return EOF;
+    }
+    if (got != sizeof(head)) {
+        return ferror(in) ? EIO : EINVAL;
+    }
+    const uint64_t a = get_le64(head + 8), b = get_le64(head + 16);
+    const uint64_t nonempty = get_le64(head + 24);
+    const uint64_t len = b >> 32;
+    if (   get_le64(head) != MAGIC
+        || (uint32_t) a != VERSION || a >> 32 != HELM_HIST_BITS
+        || (uint32_t) b != HELM_HIST_RANGE || nonempty > HELM_HIST_BUCKETS) {
+        return EINVAL;
+    }
+    const uint64_t unit = get_le64(head + 32);
+    double u;
+    memcpy(&u, &unit, sizeof(u));
+    helm_hist_init(h, u);
+    h->sum = get_le64(head + 40);
+
+    // Keep what fits of the label, consuming every padded byte
+    for (uint64_t k = 0; k < (len + 7) / 8 * 8; ++k) {
+        const int c = fgetc(in);
+        if (c == EOF) {
+            return EINVAL;
+        }
+        if (label && k + 1 < cap) {
+            label[k] = (char) c;
+        }
+    }
+    if (label && cap) {
+        label[len < cap ? len : cap - 1] = '\0';
+    }
+
+    for (uint64_t j = 0; j < nonempty; ++j) {
+        unsigned char pair[16];
+        if (fread(pair, sizeof(pair), 1, in) != 1) {
+            return EINVAL;
+        }
+        const uint64_t k = get_le64(pair);
+        if (k >= HELM_HIST_BUCKETS) {
+            return EINVAL;
+        }
+        h->count[k] = get_le64(pair + 8);
+    }
+    return 0;
+}
@@ -0,0 +1,330 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_HIST_H
+#define HELM_HIST_H
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * HDR-style latency histograms for instrumenting sense-compute-actuate
+ * cycles around helm_steady().
+ *
+ * Values are nonnegative integers, typically durations in ticks from
+ * helm_hist_ticks().  Values below <tt>2^HELM_HIST_BITS</tt> are counted
+ * exactly.  Larger values fall into log-linear buckets, each octave split
+ * into <tt>2^(HELM_HIST_BITS-1)</tt> equal pieces, so that any value is
+ * resolved within about 3% of itself.  Values of <tt>2^HELM_HIST_RANGE</tt>
+ * or more share the final bucket.  Each histogram is a fixed array and
+ * recording never allocates.
+ *
+ * Recording is wait-free.  Histograms with one writer, e.g. one per loop,
+ * use helm_hist_record() costing one relaxed load and store per counter.
+ * Histograms with many writers, e.g. one per group, use
+ * helm_hist_record_shared() costing one atomic addition per counter.
+ * Aggregation is lock-free.  Any thread may helm_hist_snapshot() or
+ * helm_hist_merge() while recording continues, in which case every counter
+ * is individually but not collectively consistent.
+ *
+ * Snapshots may be exported as text by helm_hist_write_text() or as a
+ * compact little-endian binary by helm_hist_write_binary(), which
+ * helm_hist_read_binary() reads back for offline aggregation.
+ *
+ * Sample timing each cycle of a loop and of its group:
+ * \code
+ *   helm_hist_init(&loop,  helm_hist_tick_ns());
+ *   helm_hist_init(&group, helm_hist_tick_ns());
+ *   for (;;) {
+ *       const uint64_t t0 = helm_hist_ticks();
+ *       // ...sense y, compute v += helm_steady(...), then actuate v...
+ *       const uint64_t dt = helm_hist_ticks() - t0;
+ *       helm_hist_record(&loop, dt);
+ *       helm_hist_record_shared(&group, dt);
+ *   }
+ *   // ...from any thread...
+ *   helm_hist_snapshot(&copy, &group);
+ *   helm_hist_write_text(stdout, "group", &copy);
+ * \endcode
+ */
+
+/** Significant bits resolved exactly within every bucket. */
+#define HELM_HIST_BITS 6
+
+/** Values of at least <tt>2^HELM_HIST_RANGE</tt> share the final bucket. */
+#define HELM_HIST_RANGE 40
+
+/** Buckets within each histogram. */
+#define HELM_HIST_BUCKETS \
+    ((HELM_HIST_RANGE - HELM_HIST_BITS + 2) << (HELM_HIST_BITS - 1))
+
+/** A histogram of recorded values, with counters indexed by bucket. */
+struct helm_hist
+{
+    double   unit;                       /**< Nanoseconds per unit value. */
+    uint64_t sum;                        /**< Sum of recorded values.     */
+    uint64_t count[HELM_HIST_BUCKETS];   /**< Values within each bucket.  */
+};
+
+/** \brief Read \c CLOCK_MONOTONIC in nanoseconds. */
+uint64_t
+helm_hist_ns(void);
+
+/**
+ * \brief Read a monotonic tick counter cheaply.
+ *
+ * On x86 this is the time stamp counter, assumed invariant as on any
+ * processor of the past decade, and otherwise helm_hist_ns().
+ */
+static inline
+uint64_t
+helm_hist_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return helm_hist_ns();
+#endif
+}
+
+/**
+ * \brief Nanoseconds per helm_hist_ticks() tick, calibrated against
+ * helm_hist_ns() for roughly ten milliseconds upon first call.
+ */
+double
+helm_hist_tick_ns(void);
+
+/** \brief Bucket counting value \c v. */
+static inline
+size_t
+helm_hist_index(const uint64_t v)
+{
+    if (v < (UINT64_C(1) << HELM_HIST_BITS)) {
+        return (size_t) v;
+    }
+    if (v >> HELM_HIST_RANGE) {
+        return HELM_HIST_BUCKETS - 1;
+    }
+    const int shift = 63 - __builtin_clzll(v) - HELM_HIST_BITS + 1;
+    return ((size_t) shift << (HELM_HIST_BITS - 1)) + (size_t) (v >> shift);
+}
+
+/** \brief Smallest value counted by bucket \c k. */
+static inline
+uint64_t
+helm_hist_lowest(const size_t k)
+{
+    if (k < ((size_t) 1 << HELM_HIST_BITS)) {
+        return k;
+    }
+    const size_t shift = (k >> (HELM_HIST_BITS - 1)) - 1;
+    return (uint64_t) (k - (shift << (HELM_HIST_BITS - 1))) << shift;
+}
+
+/**
+ * \brief Largest value counted by bucket \c k, treating the final bucket
+ * as ending at <tt>2^HELM_HIST_RANGE - 1</tt>.
+ */
+static inline
+uint64_t
+helm_hist_highest(const size_t k)
+{
+    if (k < ((size_t) 1 << HELM_HIST_BITS)) {
+        return k;
+    }
+    const size_t shift = (k >> (HELM_HIST_BITS - 1)) - 1;
+    return helm_hist_lowest(k) + (UINT64_C(1) << shift) - 1;
+}
+
+/**
+ * \brief Empty \c h, whose values are \c unit nanoseconds each.
+ * \return Argument \c h to permit call chaining.
+ */
+static inline
+struct helm_hist *
+helm_hist_init(struct helm_hist * const h,
+               const double unit)
+{
+    memset(h, 0, sizeof(*h));
+    h->unit = unit;
+    return h;
+}
+
+/** \brief Record \c v within \c h, which has no other writer. */
+static inline
+void
+helm_hist_record(struct helm_hist * const h,
+                 const uint64_t v)
+{
+    uint64_t * const c = &h->count[helm_hist_index(v)];
+    __atomic_store_n(c, *c + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&h->sum, h->sum + v, __ATOMIC_RELAXED);
+}
+
+/** \brief Record \c v within \c h from any number of concurrent writers. */
+static inline
+void
+helm_hist_record_shared(struct helm_hist * const h,
+                        const uint64_t v)
+{
+    __atomic_fetch_add(&h->count[helm_hist_index(v)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&h->sum, v, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Copy \c src into \c dst while \c src may be recording.
+ * \return Argument \c dst to permit call chaining.
+ */
+static inline
+struct helm_hist *
+helm_hist_snapshot(struct helm_hist * const dst,
+                   const struct helm_hist * const src)
+{
+    dst->unit = src->unit;
+    dst->sum  = __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        dst->count[k] = __atomic_load_n(&src->count[k], __ATOMIC_RELAXED);
+    }
+    return dst;
+}
+
+/**
+ * \brief Add \c src, which may be recording, into \c dst, which must not
+ * be.  Both must share one unit.
+ * \return Argument \c dst to permit call chaining.
+ */
+static inline
+struct helm_hist *
+helm_hist_merge(struct helm_hist * const dst,
+                const struct helm_hist * const src)
+{
+    assert(dst->unit == src->unit);
+    dst->sum += __atomic_load_n(&src->sum, __ATOMIC_RELAXED);
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        dst->count[k] += __atomic_load_n(&src->count[k], __ATOMIC_RELAXED);
+    }
+    return dst;
+}
+
+/** \brief Number of values recorded within \c h. */
+static inline
+uint64_t
+helm_hist_total(const struct helm_hist * const h)
+{
+    uint64_t n = 0;
+    for (size_t k = 0; k < HELM_HIST_BUCKETS; ++k) {
+        n += h->count[k];
+    }
+    return n;
+}
+
+/**
+ * \brief Nanoseconds at or below which fraction \c q of values lie,
+ * reported as the largest value of the bucket reaching that rank.
+ * \return Quantile or zero when \c h is empty.
+ */
+static inline
+double
+helm_hist_quantile(const struct helm_hist * const h,
+                   const double q)
+{
+    const uint64_t n = helm_hist_total(h);
+    if (!n) {
+        return 0;
+    }
+    const double want = ceil(q * (double) n);
+    const uint64_t rank = !(want >= 1)        ? 1
+                        : want >= (double) n ? n
+                        : (uint64_t) want;
+    uint64_t seen = 0;
+    size_t k = 0;
+    for (; k < HELM_HIST_BUCKETS - 1; ++k) {
+        if ((seen += h->count[k]) >= rank) {
+            break;
+        }
+    }
+    return h->unit * (double) helm_hist_highest(k);
+}
+
+/** \brief Mean nanoseconds across values within \c h or zero if empty. */
+static inline
+double
+helm_hist_mean(const struct helm_hist * const h)
+{
+    const uint64_t n = helm_hist_total(h);
+    return n ? h->unit * (double) h->sum / (double) n : 0;
+}
+
+/**
+ * \brief Write \c h as text preceded by a summary line naming \c label.
+ *
+ * The summary gives the count, mean, several quantiles, and the maximum,
+ * all in nanoseconds.  One line per nonempty bucket follows, giving its
+ * lowest and highest values in nanoseconds, its count, and the cumulative
+ * fraction of values through that bucket.  A blank line ends the output.
+ *
+ * \return Zero on success or an \c errno value.
+ */
+int
+helm_hist_write_text(FILE *out,
+                     const char *label,
+                     const struct helm_hist *h);
+
+/**
+ * \brief Write \c h and \c label in the little-endian binary format read by
+ * helm_hist_read_binary(), recording only nonempty buckets.
+ *
+ * The format is the 64-bit magic \c "helmhist", then the version, then
+ * #HELM_HIST_BITS, #HELM_HIST_RANGE, and label length each as 32 bits.
+ * Then come the nonempty bucket count, \c unit as binary64, and \c sum.
+ * The label follows zero padded to a multiple of 8 bytes, and then a
+ * 64-bit index and count for each nonempty bucket.  Histograms may be
+ * concatenated.
+ *
+ * \return Zero on success or an \c errno value.
+ */
+int
+helm_hist_write_binary(FILE *out,
+                       const char *label,
+                       const struct helm_hist *h);
+
+/**
+ * \brief Read one histogram written by helm_hist_write_binary().
+ *
+ * \param[in]  in    Stream positioned at a histogram.
+ * \param[out] h     Histogram read.
+ * \param[out] label If non-NULL, receives the label truncated to \c cap
+ *                   bytes including its terminating NUL.
+ * \param[in]  cap   Capacity of \c label.
+ *
+ * \return Zero on success, \c EOF at the end of \c in, \c EINVAL when
+ *         the data was written with a different layout or is malformed, or
+ *         another \c errno value.
+ */
+int
+helm_hist_read_binary(FILE *in,
+                      struct helm_hist *h,
+                      char *label,
+                      size_t cap);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_HIST_H */
@@ -0,0 +1,622 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Implementation of the parallel shard stepper within \ref helm_par.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "helm_bank.h"
+#include "helm_par.h"
+#include "helm_sparse.h"
+
+/** Polls of an unchanged word before sleeping upon a futex, given many CPUs. */
+enum { SPIN = 4096 };
+
+/** Nanoseconds any sleeper waits before rechecking. */
+enum { NAP = 100000000 };
+
+/** Sleeping lanes sensed at the cost of stepping one awake lane. */
+enum { SENSE = 8 };
+
+/** Consecutive skewed phases after which shard ranges are re-split. */
+enum { HOLD = 8 };
+
+/** Operations published alongside each epoch. */
+enum { STEP = 0, STOP = 1 };
+
+/** Most loaded worker over mean load beyond which load is skewed. */
+static const double skewed = 1.25;
+
+/** Consecutive lanes stepped as one helm_bank. */
+struct shard
+{
+    size_t             lo __attribute__((aligned(64)));  ///< First lane
+    size_t             m;        ///< Number of lanes
+    void              *mem;      ///< Storage first touched by #home
+    struct helm_bank   bank;     ///< Controllers within #mem
+    struct helm_sparse sparse;   ///< Sparse state when helm_par::band >= 0
+    size_t            *lanes;    ///< Lanes stepped sparsely
+    double            *dv;       ///< Increments for #lanes
+    double            *dt;       ///< Per-lane time step when dense
+    double             last;     ///< Value held within #dt or NaN
+    unsigned           home;     ///< Worker whose thread touched #mem
+    unsigned           owner;    ///< Worker assigned by the caller
+    size_t             stepped;  ///< Lanes stepped during the latest phase
+};
+
+/** One pinned worker. */
+struct worker
+{
+    uint32_t         done __attribute__((aligned(64)));  ///< Epoch finished
+    struct helm_par *p;        ///< Owning stepper
+    unsigned         id;       ///< Worker number
+    int              cpu;      ///< CPU to which the worker is pinned
+    size_t           first;    ///< First shard stepped
+    size_t           last;     ///< One past the last shard stepped
+    int              running;  ///< Whether #handle requires joining
+    pthread_t        handle;   ///< Thread handle
+};
+
+struct helm_par
+{
+    uint32_t       epoch __attribute__((aligned(64)));  ///< Latest phase
+    uint32_t       sleepers;  ///< Workers sleeping upon #epoch
+    uint32_t       waiting __attribute__((aligned(64)));  ///< Caller asleep
+    int            op;        ///< Operation for #epoch
+    double         dt;        ///< Argument of helm_par_steady()
+    const double  *r;         ///< Argument of helm_par_steady()
+    const double  *u;         ///< Argument of helm_par_steady()
+    const double  *v;         ///< Argument of helm_par_steady()
+    const double  *y;         ///< Argument of helm_par_steady()
+    double        *dv;        ///< Argument of helm_par_steady()
+    size_t         n;         ///< Number of lanes
+    double         band;      ///< Sparse deadband or negative when dense
+    unsigned       spin;      ///< Polls before sleeping
+    unsigned       nthreads;  ///< Number of workers
+    struct worker *workers;   ///< Every worker
+    size_t         nshards;   ///< Number of shards
+    struct shard  *shards;    ///< Every shard
+    size_t        *cut;       ///< Scratch shard ranges while re-splitting
+    unsigned       hold;      ///< Consecutive skewed phases observed
+    struct helm_par_stats stats;  ///< Counters
+};
+
+/** Sleep while \c *word equals \c val, for at most #NAP nanoseconds. */
+static
+void
+futex_wait(uint32_t * const word, const uint32_t val)
+{
+    const struct timespec nap = { 0, NAP };
+    syscall(SYS_futex, word, FUTEX_WAIT_PRIVATE, val, &nap, NULL, 0);
+}
+
+/** Wake every sleeper upon \c word. */
+static
+void
+futex_wake(uint32_t * const word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+/** Hint to the processor that the caller is spinning. */
+static inline
+void
+relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/** Round \c m up to a whole number of cache lines of doubles. */
+static
+size_t
+padded(const size_t m)
+{
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    return ((m + per - 1) / per) * per;
+}
+
+/** Bytes of storage for a shard of \c m lanes. */
+static
+size_t
+bytes(const struct helm_par * const p, const size_t m)
+{
+    return helm_bank_bytes(m)
+         + (p->band >= 0 ? helm_sparse_bytes(m) : 0)
+         + padded(m) * (sizeof(size_t) + 2 * sizeof(double));
+}
+
+/** Lay out shard \c sh within \c mem, writing every byte from this thread. */
+static
+void
+bind(const struct helm_par * const p,
+     struct shard * const sh,
+     void * const mem)
+{
+    const size_t pad = padded(sh->m);
+    char *q = (char *) mem;
+    helm_bank_init(&sh->bank, sh->m, q);
+    memset(q, 0, helm_bank_bytes(sh->m));
+    helm_bank_reset(&sh->bank);
+    helm_bank_approach(&sh->bank);
+    q += helm_bank_bytes(sh->m);
+    if (p->band >= 0) {
+        helm_sparse_init(&sh->sparse, &sh->bank, p->band, q);
+        q += helm_sparse_bytes(sh->m);
+    }
+    sh->lanes = (size_t *) q;
+    sh->dv    = (double *) (sh->lanes + pad);
+    sh->dt    = sh->dv + pad;
+    memset(sh->lanes, 0, pad * (sizeof(size_t) + 2 * sizeof(double)));
+    sh->last  = NAN;
+}
+
+/** Move shard \c sh into storage first touched by worker \c id. */
+static
+void
+migrate(const struct helm_par * const p,
+        struct shard * const sh,
+        const unsigned id)
+{
+    void *mem;
+    sh->home = id;  // Even upon failure, as remote storage remains usable
+    if (posix_memalign(&mem, HELM_BANK_ALIGN, bytes(p, sh->m))) {
+        return;
+    }
+    const struct helm_sparse old = sh->sparse;
+    bind(p, sh, mem);
+    memcpy(mem, sh->mem, bytes(p, sh->m));
+    sh->sparse.t       = old.t;
+    sh->sparse.nactive = old.nactive;
+    free(sh->mem);
+    sh->mem = mem;
+}
+
+/** Wake lane \c j of sparse shard \c sh without any catch-up step. */
+static
+void
+wake(struct shard * const sh, const size_t j)
+{
+    struct helm_sparse * const s = &sh->sparse;
+    if (!s->awake[j]) {
+        s->awake[j] = 1;
+        s->active[s->nactive++] = j;
+    }
+    s->last[j] = s->t;
+}
+
+/** Advance shard \c sh using the arguments published within \c p. */
+static
+void
+step(const struct helm_par * const p,
+     struct shard * const sh)
+{
+    const size_t lo = sh->lo;
+    if (p->band < 0) {
+        if (!(sh->last == p->dt)) {
+            for (size_t i = 0; i < sh->m; ++i) {
+                sh->dt[i] = p->dt;
+            }
+            sh->last = p->dt;
+        }
+        helm_bank_steady(&sh->bank, sh->dt, p->r + lo, p->u + lo,
+                         p->v + lo, p->y + lo, p->dv + lo);
+        sh->stepped = sh->m;
+        return;
+    }
+
+    for (size_t i = 0; i < sh->m; ++i) {
+        helm_sparse_sense(&sh->sparse, i, p->r[lo + i], p->u[lo + i],
+                          p->v[lo + i], p->y[lo + i]);
+    }
+    const size_t k = helm_sparse_steady(&sh->sparse, p->dt,
+                                        sh->lanes, sh->dv);
+    double * const dv = p->dv + lo;
+    for (size_t i = 0; i < sh->m; ++i) {
+        dv[i] = 0;
+    }
+    for (size_t j = 0; j < k; ++j) {
+        dv[sh->lanes[j]] = sh->dv[j];
+    }
+    sh->stepped = k;
+}
+
+/** Estimated cost of the latest phase of shard \c sh. */
+static
+double
+weight(const struct helm_par * const p,
+       const struct shard * const sh)
+{
+    return p->band < 0 ? (double) sh->m
+                       : sh->stepped + (double) sh->m / SENSE;
+}
+
+/** Wait until the caller publishes an epoch other than \c seen. */
+static
+uint32_t
+await(struct helm_par * const p, const uint32_t seen)
+{
+    for (unsigned spin = 0;; ++spin) {
+        const uint32_t e = __atomic_load_n(&p->epoch, __ATOMIC_ACQUIRE);
+        if (e != seen) {
+            return e;
+        }
+        if (spin < p->spin) {
+            relax();
+            continue;
+        }
+        __atomic_add_fetch(&p->sleepers, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&p->epoch, __ATOMIC_RELAXED) == seen) {
+            futex_wait(&p->epoch, seen);
+        }
+        __atomic_sub_fetch(&p->sleepers, 1, __ATOMIC_RELAXED);
+        spin = 0;
+    }
+}
+
+/** Record that worker \c w finished epoch \c e, waking any sleeping caller. */
+static
+void
+publish(struct helm_par * const p,
+        struct worker * const w,
+        const uint32_t e)
+{
+    __atomic_store_n(&w->done, e, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p->waiting, __ATOMIC_RELAXED)) {
+        futex_wake(&w->done);
+    }
+}
+
+/** Publish operation \c op as the next epoch, returning that epoch. */
+static
+uint32_t
+release(struct helm_par * const p, const int op)
+{
+    p->op = op;
+    const uint32_t e = p->epoch + 1;
+    __atomic_store_n(&p->epoch, e, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&p->sleepers, __ATOMIC_RELAXED)) {
+        futex_wake(&p->epoch);
+    }
+    return e;
+}
+
+/** Wait until every running worker has finished epoch \c e. */
+static
+void
+collect(struct helm_par * const p, const uint32_t e)
+{
+    for (unsigned k = 0; k < p->nthreads; ++k) {
+        struct worker * const w = &p->workers[k];
+        if (!w->running) {
+            continue;
+        }
+        for (unsigned spin = 0;; ++spin) {
+            const uint32_t d = __atomic_load_n(&w->done, __ATOMIC_ACQUIRE);
+            if (d == e) {
+                break;
+            }
+            if (spin < p->spin) {
+                relax();
+                continue;
+            }
+            __atomic_store_n(&p->waiting, 1, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&w->done, __ATOMIC_RELAXED) == d) {
+                futex_wait(&w->done, d);
+            }
+            __atomic_store_n(&p->waiting, 0, __ATOMIC_RELAXED);
+            spin = 0;
+        }
+    }
+}
+
+/** Worker body allocating its shards and then stepping them each phase. */
+static
+void *
+run(void * const arg)
+{
+    struct worker   * const w = (struct worker *) arg;
+    struct helm_par * const p = w->p;
+    for (size_t s = w->first; s < w->last; ++s) {
+        struct shard * const sh = &p->shards[s];
+        if (!posix_memalign(&sh->mem, HELM_BANK_ALIGN, bytes(p, sh->m))) {
+            bind(p, sh, sh->mem);
+        } else {
+            sh->mem = NULL;
+        }
+    }
+    uint32_t seen = 0;
+    publish(p, w, seen);
+    for (;;) {
+        seen = await(p, seen);
+        if (p->op == STOP) {
+            break;
+        }
+        for (size_t s = w->first; s < w->last; ++s) {
+            struct shard * const sh = &p->shards[s];
+            if (sh->home != w->id) {
+                migrate(p, sh, w->id);
+            }
+            step(p, sh);
+        }
+        publish(p, w, seen);
+    }
+    return NULL;
+}
+
+/**
+ * Update statistics after a phase and, once load has remained skewed for
+ * #HOLD phases, re-split shard ranges whenever doing so lowers the most
+ * loaded worker's load.
+ */
+static
+void
+rebalance(struct helm_par * const p)
+{
+    double total = 0, most = 0;
+    size_t active = 0;
+    for (unsigned k = 0; k < p->nthreads; ++k) {
+        const struct worker * const w = &p->workers[k];
+        double load = 0;
+        for (size_t s = w->first; s < w->last; ++s) {
+            load   += weight(p, &p->shards[s]);
+            active += p->shards[s].stepped;
+        }
+        total += load;
+        most   = load > most ? load : most;
+    }
+    const double mean = total / p->nthreads;
+    p->stats.active = active;
+    p->stats.skew   = mean > 0 ? most / mean : 1;
+    if (p->stats.skew <= skewed) {
+        p->hold = 0;
+        return;
+    }
+    if (++p->hold < HOLD) {
+        return;
+    }
+    p->hold = 0;
+
+    // Cut wherever cumulative load crosses a multiple of the mean,
+    // placing each shard with the worker holding its midpoint
+    double sum = 0, worst = 0;
+    size_t s = 0;
+    for (unsigned k = 0; k < p->nthreads; ++k) {
+        const double goal = (k + 1) * mean, start = sum;
+        p->cut[k] = s;
+        while (s < p->nshards
+               && (k + 1 == p->nthreads
+                   || sum + weight(p, &p->shards[s]) / 2 <= goal)) {
+            sum += weight(p, &p->shards[s++]);
+        }
+        worst = sum - start > worst ? sum - start : worst;
+    }
+    p->cut[p->nthreads] = p->nshards;
+    if (worst >= most) {
+        return;
+    }
+    for (unsigned k = 0; k < p->nthreads; ++k) {
+        struct worker * const w = &p->workers[k];
+        w->first = p->cut[k];
+        w->last  = p->cut[k + 1];
+        for (size_t t = w->first; t < w->last; ++t) {
+            if (p->shards[t].owner != k) {
+                p->shards[t].owner = k;
+                ++p->stats.migrations;
+            }
+        }
+    }
+    ++p->stats.rebalances;
+}
+
+struct helm_par *
+helm_par_create(size_t n,
+                unsigned nthreads,
+                const int *cpus,
+                double band)
+{
+    // Determine CPUs available to this process
+    cpu_set_t mask;
+    int avail[CPU_SETSIZE], navail = 0;
+    if (0 == sched_getaffinity(0, sizeof(mask), &mask)) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &mask)) {
+                avail[navail++] = c;
+            }
+        }
+    }
+    if (!navail) {
+        avail[navail++] = 0;
+    }
+    if (!nthreads) {
+        nthreads = (unsigned) navail;
+    }
+
+    struct helm_par *p;
+    if (posix_memalign((void **) &p, HELM_BANK_ALIGN, sizeof(*p))) {
+        return NULL;
+    }
+    memset(p, 0, sizeof(*p));
+    p->n        = n;
+    p->band     = band;
+    p->spin     = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN : 0;
+    p->nthreads = nthreads;
+    p->nshards  = (n + HELM_PAR_SHARD - 1) / HELM_PAR_SHARD;
+    p->cut      = malloc((nthreads + 1) * sizeof(*p->cut));
+    p->stats.skew = 1;
+    if (   !p->cut
+        || posix_memalign((void **) &p->workers, HELM_BANK_ALIGN,
+                          nthreads * sizeof(*p->workers))) {
+        p->workers = NULL;
+        helm_par_destroy(p);
+        return NULL;
+    }
+    memset(p->workers, 0, nthreads * sizeof(*p->workers));
+    if (posix_memalign((void **) &p->shards, HELM_BANK_ALIGN,
+                       (p->nshards ? p->nshards : 1) * sizeof(*p->shards))) {
+        p->shards = NULL;
+        helm_par_destroy(p);
+        return NULL;
+    }
+    memset(p->shards, 0, p->nshards * sizeof(*p->shards));
+
+    // Split shards evenly, each homed with the worker that will touch it
+    for (unsigned k = 0; k < nthreads; ++k) {
+        struct worker * const w = &p->workers[k];
+        w->p     = p;
+        w->id    = k;
+        w->cpu   = cpus ? cpus[k] : avail[k % navail];
+        w->done  = UINT32_MAX;
+        w->first = (size_t) ((unsigned long long) p->nshards * k / nthreads);
+        w->last  = (size_t) ((unsigned long long) p->nshards * (k + 1)
+                             / nthreads);
+        for (size_t s = w->first; s < w->last; ++s) {
+            struct shard * const sh = &p->shards[s];
+            sh->lo    = s * HELM_PAR_SHARD;
+            sh->m     = n - sh->lo < HELM_PAR_SHARD ? n - sh->lo
+                                                    : HELM_PAR_SHARD;
+            sh->home  = k;
+            sh->owner = k;
+        }
+    }
+
+    // Launch pinned workers and await their allocations
+    int err = 0;
+    for (unsigned k = 0; !err && k < nthreads; ++k) {
+        struct worker * const w = &p->workers[k];
+        cpu_set_t cpu;
+        CPU_ZERO(&cpu);
+        CPU_SET(w->cpu, &cpu);
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        err = pthread_attr_setaffinity_np(&attr, sizeof(cpu), &cpu);
+        if (!err) {
+            err = pthread_create(&w->handle, &attr, run, w);
+        }
+        pthread_attr_destroy(&attr);
+        w->running = !err;
+    }
+    collect(p, 0);
+    for (size_t s = 0; !err && s < p->nshards; ++s) {
+        err = !p->shards[s].mem;
+    }
+    if (err) {
+        helm_par_destroy(p);
+        return NULL;
+    }
+    return p;
+}
+
+unsigned
+helm_par_nthreads(const struct helm_par *p)
+{
+    return p->nthreads;
+}
+
+void
+helm_par_set(struct helm_par *p,
+             size_t i,
+             const struct helm_state *h)
+{
+    struct shard * const sh = &p->shards[i / HELM_PAR_SHARD];
+    helm_bank_set(&sh->bank, i % HELM_PAR_SHARD, h);
+    if (p->band >= 0) {
+        wake(sh, i % HELM_PAR_SHARD);
+    }
+}
+
+struct helm_state *
+helm_par_get(const struct helm_par *p,
+             size_t i,
+             struct helm_state *h)
+{
+    const struct shard * const sh = &p->shards[i / HELM_PAR_SHARD];
+    return helm_bank_get(&sh->bank, i % HELM_PAR_SHARD, h);
+}
+
+void
+helm_par_approach(struct helm_par *p)
+{
+    for (size_t s = 0; s < p->nshards; ++s) {
+        struct shard * const sh = &p->shards[s];
+        helm_bank_approach(&sh->bank);
+        for (size_t j = 0; p->band >= 0 && j < sh->m; ++j) {
+            wake(sh, j);
+        }
+    }
+}
+
+void
+helm_par_steady(struct helm_par *p,
+                double dt,
+                const double *r,
+                const double *u,
+                const double *v,
+                const double *y,
+                double *dv)
+{
+    p->dt = dt;
+    p->r  = r;
+    p->u  = u;
+    p->v  = v;
+    p->y  = y;
+    p->dv = dv;
+    collect(p, release(p, STEP));
+    ++p->stats.steps;
+    rebalance(p);
+}
+
+void
+helm_par_stats(const struct helm_par *p,
+               struct helm_par_stats *s)
+{
+    *s = p->stats;
+}
+
+void
+helm_par_destroy(struct helm_par *p)
+{
+    if (!p) {
+        return;
+    }
+    if (p->workers) {
+        release(p, STOP);
+        for (unsigned k = 0; k < p->nthreads; ++k) {
+            if (p->workers[k].running) {
+                pthread_join(p->workers[k].handle, NULL);
+            }
+        }
+    }
+    for (size_t s = 0; p->shards && s < p->nshards; ++s) {
+        free(p->shards[s].mem);
+    }
+    free(p->shards);
+    free(p->workers);
+    free(p->cut);
+    free(p);
+}
@@ -0,0 +1,160 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_PAR_H
+#define HELM_PAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Parallel stepping of very large controller banks by CPU-pinned workers
+ * owning NUMA-local shards.
+ *
+ * Lanes are partitioned into shards of #HELM_PAR_SHARD consecutive lanes,
+ * each a helm_bank whose storage is allocated and first touched by the
+ * worker stepping it.  Under the kernel's default first-touch policy, every
+ * shard therefore resides upon the memory node nearest its worker.  Shards
+ * begin on multiples of #HELM_PAR_SHARD lanes, so workers writing
+ * increments into a caller's 64-byte-aligned array never share a cache line.
+ *
+ * Each helm_par_steady() is one phase.  The caller publishes a new epoch
+ * and every worker, upon observing it, steps its contiguous range of shards
+ * and then publishes that epoch as its own completion word.  Workers never
+ * wait upon one another and no read-modify-write lies upon the step path,
+ * so a slow worker delays only the caller's return.  Idle parties spin
+ * briefly before sleeping upon a futex.
+ *
+ * With a nonnegative deadband, each shard steps sparsely as in \ref
+ * helm_sparse.h so that quiescent lanes cost only a comparison.  Work then
+ * follows the active lanes, which need not be spread evenly.  After every
+ * phase the load of each worker is estimated from its shards' active lanes.
+ * Once the most loaded worker exceeds the mean by a quarter for several
+ * consecutive phases, shard ranges are re-split into equal loads.  A shard
+ * changing hands is copied by its new worker into freshly touched storage
+ * upon that worker's next phase.  Partitioning never alters results.
+ *
+ * Sample stepping a million lanes by every available CPU:
+ * \code
+ *   struct helm_par * const p = helm_par_create(1 << 20, 0, NULL, 0.0);
+ *   for (size_t i = 0; i < 1 << 20; ++i) {
+ *       helm_par_set(p, i, &h[i]);
+ *   }
+ *   helm_par_approach(p);
+ *   for (;;) {
+ *       helm_par_steady(p, dt, r, u, v, y, dv);
+ *       // ...
+ *   }
+ *   helm_par_destroy(p);
+ * \endcode
+ */
+
+/** Lanes within each shard, a multiple of eight doubles per cache line. */
+#define HELM_PAR_SHARD 4096
+
+/** Counters accumulated by helm_par_steady(). */
+struct helm_par_stats
+{
+    uint64_t steps;       /**< Phases completed.                          */
+    uint64_t rebalances;  /**< Times shard ranges were re-split.          */
+    uint64_t migrations;  /**< Shards moved between workers.              */
+    size_t   active;      /**< Lanes stepped during the latest phase.     */
+    double   skew;        /**< Most loaded worker over mean, latest phase. */
+};
+
+/** Opaque parallel stepper. */
+struct helm_par;
+
+/**
+ * \brief Create a stepper of \c n lanes reset as by helm_reset() and
+ * helm_approach(), starting its workers.
+ *
+ * \param[in] n        Number of lanes.
+ * \param[in] nthreads Number of workers, where zero selects one per CPU.
+ * \param[in] cpus     CPU for each worker or NULL to pin worker \c k to the
+ *                     \c k-th CPU available to the process, modulo count.
+ * \param[in] band     Deadband as for helm_sparse_init() or negative to
+ *                     step every lane densely by helm_bank_steady().
+ * \return New stepper or NULL on failure.
+ */
+struct helm_par *
+helm_par_create(size_t n,
+                unsigned nthreads,
+                const int *cpus,
+                double band);
+
+/** \brief Number of workers within \c p. */
+unsigned
+helm_par_nthreads(const struct helm_par *p);
+
+/**
+ * \brief Copy controller \c h into lane \c i, waking the lane if asleep.
+ * Must not overlap helm_par_steady().
+ */
+void
+helm_par_set(struct helm_par *p,
+             size_t i,
+             const struct helm_state *h);
+
+/**
+ * \brief Copy lane \c i into \c h.  Must not overlap helm_par_steady().
+ * \return Argument \c h to permit call chaining.
+ */
+struct helm_state *
+helm_par_get(const struct helm_par *p,
+             size_t i,
+             struct helm_state *h);
+
+/**
+ * \brief Reset transient state of every lane as by helm_bank_approach().
+ * Must not overlap helm_par_steady().
+ */
+void
+helm_par_approach(struct helm_par *p);
+
+/**
+ * \brief Advance every lane by \c dt, returning once all workers finish.
+ *
+ * Arrays are indexed by lane and should be 64-byte aligned and first
+ * touched by the workers' nodes where NUMA placement matters.  Densely, \c
+ * dv is bit-identical to helm_bank_steady() with \c dt for every lane.
+ * Sparsely, \c dv is as from helm_sparse_steady() after helm_sparse_sense()
+ * of every lane and is zero for lanes not stepped.
+ */
+void
+helm_par_steady(struct helm_par *p,
+                double dt,
+                const double *r,
+                const double *u,
+                const double *v,
+                const double *y,
+                double *dv);
+
+/** \brief Copy the counters of \c p into \c s. */
+void
+helm_par_stats(const struct helm_par *p,
+               struct helm_par_stats *s);
+
+/** \brief Stop and join every worker, then release every resource. */
+void
+helm_par_destroy(struct helm_par *p);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_PAR_H */
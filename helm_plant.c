@@ -0,0 +1,84 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_plant.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_plant.h"
+
+extern
+int
+helm_plant_invert(const size_t n,
+                  double M[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1]);
+
+extern
+void
+helm_plant_expm(const size_t n,
+                double M[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1]);
+
+extern
+int
+helm_plant_retime(struct helm_plant * const p,
+                  const double h);
+
+extern
+int
+helm_plant_init(struct helm_plant * const p,
+                const size_t n,
+                const double * const a,
+                const double * const b,
+                const double h,
+                const enum helm_plant_method method);
+
+extern
+double
+helm_plant_advance(const struct helm_plant * const p,
+                   double * const x,
+                   const double u);
+
+extern
+struct helm_delay *
+helm_delay_init(struct helm_delay * const dl,
+                const size_t d,
+                const size_t w,
+                double * const buf,
+                const double u0);
+
+extern
+double *
+helm_delay_shift(struct helm_delay * const dl,
+                 double * const u);
+
+extern
+size_t
+helm_plant_bank_bytes(const size_t n,
+                      const size_t m);
+
+extern
+struct helm_plant_bank *
+helm_plant_bank_init(struct helm_plant_bank * const pb,
+                     const size_t n,
+                     const size_t m,
+                     void * const mem);
+
+extern
+struct helm_plant_bank *
+helm_plant_bank_set(struct helm_plant_bank * const pb,
+                    const size_t k,
+                    const struct helm_plant * const p);
+
+extern
+void
+helm_plant_bank_advance(struct helm_plant_bank * const pb,
+                        const double * const u,
+                        double * const y);
@@ -0,0 +1,549 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2014, 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_PLANT_H
+#define HELM_PLANT_H
+
+#include <assert.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Header-only simulation of linear, time-invariant processes for exercising
+ * controllers, using a propagator precomputed once per time step size.
+ *
+ * Given the strictly proper process transfer function of order \f$n\f$
+ * \f{align}{
+ *     \frac{y(s)}{u(s)} = \frac{b_{n-1} s^{n-1} + \dots + b_1 s + b_0}
+ *                              {s^n + a_{n-1} s^{n-1} + \dots + a_1 s + a_0}
+ * \f}
+ * a matching state space model consisting of 1st order differential equations
+ * <a
+ * href="http://lpsa.swarthmore.edu/Representations/SysRepTransformations/SysRepTransfAll.html">
+ * can be derived</a> in controllable canonical form
+ * \f{align}{
+ *     \frac{\mathrm{d}}{\mathrm{d}t} \vec{x}(t)
+ *     &=
+ *     \underbrace{
+ *     \begin{bmatrix}
+ *            0 &    1 &        &          \\
+ *              &      & \ddots &          \\
+ *              &      &        &        1 \\
+ *         -a_0 & -a_1 & \dots  & -a_{n-1}
+ *     \end{bmatrix}
+ *     }_{A}
+ *     \vec{x}(t)
+ *     +
+ *     \underbrace{
+ *     \begin{bmatrix} 0 \\ \vdots \\ 0 \\ 1 \end{bmatrix}
+ *     }_{B}
+ *     u(t)
+ *     ,
+ *     &
+ *     y(t) &= \underbrace{
+ *                 \begin{bmatrix} b_0 & b_1 & \dots & b_{n-1} \end{bmatrix}
+ *             }_{C} \vec{x}(t)
+ * \f}
+ * where, when only \f$b_0\f$ is nonzero, \f$b_0 x_k(t)\f$ is the \f$k\f$-th
+ * derivative of \f$y(t)\f$.  Holding \f$u(t_i)\f$ across each step of size
+ * \f$h\f$, every supported discretization takes the form
+ * \f{align}{
+ *     \vec{x}\left(t_{i+1}\right) &= \Phi \vec{x}\left(t_i\right)
+ *                                  + \Gamma u\left(t_i\right)
+ * \f}
+ * so precomputing propagator \f$\left(\Phi,\Gamma\right)\f$ once per step
+ * size reduces each step to a matrix-vector product.
+ *
+ * A semi-implicit Euler scheme,
+ * \f$\vec{x}_{i+1} = \vec{x}_i + h\left(A\vec{x}_{i+1} + B u_i\right)\f$,
+ * gives \f$\Phi = \left(I - hA\right)^{-1}\f$ and \f$\Gamma = h \Phi B\f$.
+ * It is unconditionally stable and first order accurate.  Alternatively,
+ * an exact zero-order hold gives \f$\Phi = e^{hA}\f$ and \f$\Gamma =
+ * \int_0^h e^{sA} B \,\mathrm{d}s\f$, both found as blocks of the matrix
+ * exponential
+ * \f{align}{
+ *     \exp\left(h \begin{bmatrix} A & B \\ 0 & 0 \end{bmatrix}\right)
+ *     &=
+ *     \begin{bmatrix} \Phi & \Gamma \\ 0 & 1 \end{bmatrix}
+ *     .
+ * \f}
+ *
+ * Dead time is modeled by helm_delay, which delays the input by a whole
+ * number of steps.  Many processes of one order may be advanced together
+ * using the structure-of-arrays helm_plant_bank.
+ */
+
+/** Maximum supported process order. */
+#define HELM_PLANT_MAX 16
+
+/** Discretizations supported by helm_plant_init(). */
+enum helm_plant_method
+{
+    HELM_PLANT_EULER = 0,  /**< Semi-implicit Euler.       */
+    HELM_PLANT_ZOH   = 1   /**< Exact zero-order hold.     */
+};
+
+/** A process transfer function and its propagator for one step size. */
+struct helm_plant
+{
+    size_t n;                                  /**< Order.                  */
+    enum helm_plant_method method;             /**< Discretization.         */
+    double h;                                  /**< Step size.              */
+    double a[HELM_PLANT_MAX];                  /**< Denominator a_0, ...    */
+    double b[HELM_PLANT_MAX];                  /**< Numerator b_0, ...      */
+    double Phi[HELM_PLANT_MAX][HELM_PLANT_MAX];/**< State propagator.      */
+    double Gamma[HELM_PLANT_MAX];              /**< Input propagator.       */
+};
+
+/**
+ * \brief Invert \c n by \c n matrix \c M in place by Gauss-Jordan elimination
+ * with partial pivoting.
+ *
+ * \return Zero on success or nonzero if \c M is numerically singular.
+ */
+static inline
+int
+helm_plant_invert(const size_t n,
+                  double M[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1])
+{
+    size_t swap[HELM_PLANT_MAX + 1];
+    for (size_t k = 0; k < n; ++k) {
+        size_t p = k;
+        for (size_t i = k + 1; i < n; ++i) {
+            if (fabs(M[i][k]) > fabs(M[p][k])) {
+                p = i;
+            }
+        }
+        if (!(fabs(M[p][k]) > 0)) {
+            return 1;
+        }
+        swap[k] = p;
+        for (size_t j = 0; j < n; ++j) {
+            const double t = M[k][j]; M[k][j] = M[p][j]; M[p][j] = t;
+        }
+        const double d = 1 / M[k][k];
+        M[k][k] = 1;
+        for (size_t j = 0; j < n; ++j) {
+            M[k][j] *= d;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (i != k) {
+                const double e = M[i][k];
+                M[i][k] = 0;
+                for (size_t j = 0; j < n; ++j) {
+                    M[i][j] -= e*M[k][j];
+                }
+            }
+        }
+    }
+    for (size_t k = n; k-- > 0;) {          // Undo interchanges by columns
+        const size_t p = swap[k];
+        for (size_t i = 0; i < n; ++i) {
+            const double t = M[i][k]; M[i][k] = M[i][p]; M[i][p] = t;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief Compute \f$e^M\f$ for \c n by \c n matrix \c M in place using
+ * scaling and squaring of a truncated Taylor series.
+ */
+static inline
+void
+helm_plant_expm(const size_t n,
+                double M[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1])
+{
+    double E[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1];
+    double T[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1];
+    double W[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1];
+
+    // Scale M by 2^-s so that its 1-norm is at most 1/2
+    double norm = 0;
+    for (size_t j = 0; j < n; ++j) {
+        double col = 0;
+        for (size_t i = 0; i < n; ++i) {
+            col += fabs(M[i][j]);
+        }
+        norm = fmax(norm, col);
+    }
+    int s = 0;
+    if (norm > 0.5) {
+        s = (int) ceil(log2(norm / 0.5));
+    }
+    const double scale = ldexp(1, -s);
+
+    // Sum Taylor terms until they no longer contribute
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            M[i][j] *= scale;
+            E[i][j]  = (i == j) + M[i][j];
+            T[i][j]  = M[i][j];
+        }
+    }
+    for (int k = 2; k <= 30; ++k) {
+        int small = 1;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double sum = 0;
+                for (size_t l = 0; l < n; ++l) {
+                    sum += T[i][l]*M[l][j];
+                }
+                W[i][j] = sum / k;
+            }
+        }
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                small   &= E[i][j] + W[i][j] == E[i][j];
+                T[i][j]  = W[i][j];
+                E[i][j] += W[i][j];
+            }
+        }
+        if (small) {
+            break;
+        }
+    }
+
+    // Undo the scaling by repeated squaring
+    for (; s > 0; --s) {
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                double sum = 0;
+                for (size_t l = 0; l < n; ++l) {
+                    sum += E[i][l]*E[l][j];
+                }
+                W[i][j] = sum;
+            }
+        }
+        memcpy(E, W, sizeof(E));
+    }
+    memcpy(M, E, sizeof(E));
+}
+
+/**
+ * \brief Recompute the propagator within \c p for step size \c h.
+ *
+ * \return Zero on success or nonzero if \c h is negative or not finite or
+ *         if the propagator cannot be formed, in which case \c p is
+ *         untouched.
+ */
+static inline
+int
+helm_plant_retime(struct helm_plant * const p,
+                  const double h)
+{
+    if (!(h >= 0 && isfinite(h))) {
+        return 1;
+    }
+    const size_t n = p->n;
+    double M[HELM_PLANT_MAX + 1][HELM_PLANT_MAX + 1];
+    memset(M, 0, sizeof(M));
+
+    // Form h [A B; 0 0] for either method
+    for (size_t i = 0; i + 1 < n; ++i) {
+        M[i][i+1] = h;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        M[n-1][j] = -h*p->a[j];
+    }
+    M[n-1][n] = h;
+
+    switch (p->method) {
+    case HELM_PLANT_EULER:
+        for (size_t i = 0; i < n; ++i) {      // I - hA
+            for (size_t j = 0; j < n; ++j) {
+                M[i][j] = (i == j) - M[i][j];
+            }
+        }
+        if (helm_plant_invert(n, M)) {
+            return 1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(p->Phi[i], M[i], n * sizeof(double));
+            p->Gamma[i] = h*M[i][n-1];       // h (I - hA)^{-1} B
+        }
+        break;
+    case HELM_PLANT_ZOH:
+        helm_plant_expm(n + 1, M);
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(p->Phi[i], M[i], n * sizeof(double));
+            p->Gamma[i] = M[i][n];
+        }
+        break;
+    default:
+        return 1;
+    }
+    p->h = h;
+    return 0;
+}
+
+/**
+ * \brief Initialize \c p from a transfer function and compute its propagator.
+ *
+ * \param[out] p      Plant to initialize.
+ * \param[in]  n      Order within <tt>[1, HELM_PLANT_MAX]</tt>.
+ * \param[in]  a      Denominator coefficients \f$a_0, \dots, a_{n-1}\f$.
+ * \param[in]  b      Numerator coefficients \f$b_0, \dots, b_{n-1}\f$.
+ * \param[in]  h      Step size.
+ * \param[in]  method Discretization to use.
+ *
+ * \return Zero on success or nonzero on invalid arguments.
+ */
+static inline
+int
+helm_plant_init(struct helm_plant * const p,
+                const size_t n,
+                const double * const a,
+                const double * const b,
+                const double h,
+                const enum helm_plant_method method)
+{
+    if (n < 1 || n > HELM_PLANT_MAX) {
+        return 1;
+    }
+    memset(p, 0, sizeof(*p));
+    p->n      = n;
+    p->method = method;
+    memcpy(p->a, a, n * sizeof(double));
+    memcpy(p->b, b, n * sizeof(double));
+    return helm_plant_retime(p, h);
+}
+
+/**
+ * \brief Advance state \c x by one step given held input \c u.
+ *
+ * \param[in]     p Plant providing the propagator.
+ * \param[in,out] x On input, state at time \f$t\f$.
+ *                  On output, state at time \f$t+h\f$.
+ * \param[in]     u Input held across the step.
+ *
+ * \return Output \f$y(t+h)\f$.
+ */
+static inline
+double
+helm_plant_advance(const struct helm_plant * const p,
+                   double * const x,
+                   const double u)
+{
+    double next[HELM_PLANT_MAX];
+    double y = 0;
+    for (size_t i = 0; i < p->n; ++i) {
+        double sum = p->Gamma[i]*u;
+        for (size_t j = 0; j < p->n; ++j) {
+            sum += p->Phi[i][j]*x[j];
+        }
+        next[i] = sum;
+    }
+    for (size_t i = 0; i < p->n; ++i) {
+        x[i] = next[i];
+        y   += p->b[i]*next[i];
+    }
+    return y;
+}
+
+/**
+ * A dead time of whole steps applied to \c w signals at once, backed by
+ * caller-provided storage for \c d times \c w values.
+ */
+struct helm_delay
+{
+    size_t  d;     /**< Dead time in steps.                    */
+    size_t  w;     /**< Number of signals delayed together.    */
+    size_t  head;  /**< Oldest entry within #buf.               */
+    double *buf;   /**< Storage for \c d times \c w values.     */
+};
+
+/**
+ * \brief Initialize \c dl delaying \c w signals by \c d steps, with every
+ * signal having held value \c u0 during the preceding \c d steps.
+ * \return Argument \c dl to permit call chaining.
+ */
+static inline
+struct helm_delay *
+helm_delay_init(struct helm_delay * const dl,
+                const size_t d,
+                const size_t w,
+                double * const buf,
+                const double u0)
+{
+    dl->d    = d;
+    dl->w    = w;
+    dl->head = 0;
+    dl->buf  = buf;
+    for (size_t k = 0; k < d*w; ++k) {
+        buf[k] = u0;
+    }
+    return dl;
+}
+
+/**
+ * \brief Replace \c u[0], ..., \c u[w-1] with their values \c d steps ago.
+ * \return Argument \c u to permit call chaining.
+ */
+static inline
+double *
+helm_delay_shift(struct helm_delay * const dl,
+                 double * const u)
+{
+    if (dl->d) {
+        double * const slot = dl->buf + dl->head*dl->w;
+        for (size_t k = 0; k < dl->w; ++k) {
+            const double t = slot[k];
+            slot[k] = u[k];
+            u[k]    = t;
+        }
+        dl->head = dl->head + 1 == dl->d ? 0 : dl->head + 1;
+    }
+    return u;
+}
+
+/** Lanes advanced together by helm_plant_bank_advance(). */
+#define HELM_PLANT_LANES 32
+
+/**
+ * Many processes of one order stored as parallel arrays.  Element \c i,
+ * \c j of lane \c k's \f$\Phi\f$ resides at <tt>Phi[(i*n + j)*stride +
+ * k]</tt> and likewise for the vectors #Gamma, #C, and #x.
+ */
+struct helm_plant_bank
+{
+    size_t  n;       /**< Order of every process.                       */
+    size_t  m;       /**< Number of processes.                          */
+    size_t  stride;  /**< \c m rounded up to #HELM_PLANT_LANES.         */
+    double *Phi;     /**< State propagators.                            */
+    double *Gamma;   /**< Input propagators.                            */
+    double *C;       /**< Output coefficients.                          */
+    double *x;       /**< States.                                       */
+};
+
+/** \brief Bytes of storage required by helm_plant_bank_init(). */
+static inline
+size_t
+helm_plant_bank_bytes(const size_t n,
+                      const size_t m)
+{
+    const size_t stride = (m + HELM_PLANT_LANES - 1)
+                        / HELM_PLANT_LANES * HELM_PLANT_LANES;
+    return (n*n + 3*n) * stride * sizeof(double);
+}
+
+/**
+ * \brief Carve the arrays of \c pb from caller-provided storage, zeroing
+ * every propagator and state.
+ * \return Argument \c pb to permit call chaining.
+ */
+static inline
+struct helm_plant_bank *
+helm_plant_bank_init(struct helm_plant_bank * const pb,
+                     const size_t n,
+                     const size_t m,
+                     void * const mem)
+{
+    assert(n >= 1 && n <= HELM_PLANT_MAX);
+    pb->n      = n;
+    pb->m      = m;
+    pb->stride = (m + HELM_PLANT_LANES - 1)
+               / HELM_PLANT_LANES * HELM_PLANT_LANES;
+    pb->Phi    = (double *) mem;
+    pb->Gamma  = pb->Phi   + n*n*pb->stride;
+    pb->C      = pb->Gamma + n*pb->stride;
+    pb->x      = pb->C     + n*pb->stride;
+    memset(mem, 0, helm_plant_bank_bytes(n, m));
+    return pb;
+}
+
+/**
+ * \brief Copy the propagator of \c p into lane \c k of \c pb.
+ * \return Argument \c pb to permit call chaining.
+ */
+static inline
+struct helm_plant_bank *
+helm_plant_bank_set(struct helm_plant_bank * const pb,
+                    const size_t k,
+                    const struct helm_plant * const p)
+{
+    assert(p->n == pb->n && k < pb->m);
+    const size_t n = pb->n, s = pb->stride;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            pb->Phi[(i*n + j)*s + k] = p->Phi[i][j];
+        }
+        pb->Gamma[i*s + k] = p->Gamma[i];
+        pb->C    [i*s + k] = p->b[i];
+    }
+    return pb;
+}
+
+/**
+ * \brief Advance every process within \c pb by one step.
+ *
+ * Lanes are processed #HELM_PLANT_LANES at a time so that each
+ * matrix-vector product becomes fixed-length loops over contiguous lanes
+ * which compilers vectorize.
+ *
+ * \param[in,out] pb Propagators and states.
+ * \param[in]     u  Inputs held across the step, one per process.
+ * \param[out]    y  Outputs after the step, one per process.
+ */
+static inline
+void
+helm_plant_bank_advance(struct helm_plant_bank * const pb,
+                        const double * const u,
+                        double * const y)
+{
+    enum { L = HELM_PLANT_LANES };
+    const size_t n = pb->n, s = pb->stride;
+    for (size_t k0 = 0; k0 < pb->m; k0 += L) {
+        double in[L], out[L], next[HELM_PLANT_MAX][L];
+        const size_t len = pb->m - k0 < L ? pb->m - k0 : L;
+        for (size_t k = 0; k < L; ++k) {
+            in[k] = k < len ? u[k0 + k] : 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const double * const G = pb->Gamma + i*s + k0;
+            for (size_t k = 0; k < L; ++k) {
+                next[i][k] = G[k]*in[k];
+            }
+            for (size_t j = 0; j < n; ++j) {
+                const double * const P = pb->Phi + (i*n + j)*s + k0;
+                const double * const X = pb->x   + j*s + k0;
+                for (size_t k = 0; k < L; ++k) {
+                    next[i][k] += P[k]*X[k];
+                }
+            }
+        }
+        for (size_t k = 0; k < L; ++k) {
+            out[k] = 0;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            double       * const X = pb->x + i*s + k0;
+            const double * const C = pb->C + i*s + k0;
+            for (size_t k = 0; k < L; ++k) {
+                X  [k]  = next[i][k];
+                out[k] += C[k]*next[i][k];
+            }
+        }
+        for (size_t k = 0; k < len; ++k) {
+            y[k0 + k] = out[k];
+        }
+    }
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_PLANT_H */
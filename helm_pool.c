@@ -0,0 +1,192 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Implementation of the work-stealing thread pool within \ref helm_pool.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "helm_pool.h"
+
+/** Remaining indices owned by one worker, padded to avoid false sharing. */
+struct range
+{
+    pthread_mutex_t lock;   ///< Guards #begin and #end
+    size_t          begin;  ///< First unclaimed index
+    size_t          end;    ///< One past the last unclaimed index
+    char pad[64];           ///< Separates neighboring locks
+};
+
+/** State shared by every worker within one helm_pool_run() invocation. */
+struct pool
+{
+    struct range *ranges;   ///< One range per worker
+    unsigned      nworkers; ///< Number of ranges
+    size_t        grain;    ///< Indices claimed at once
+    helm_pool_fn  fn;       ///< User callback
+    void         *ctx;      ///< User callback argument
+};
+
+/** Argument for each spawned worker. */
+struct worker
+{
+    struct pool *pool;      ///< Shared state
+    unsigned     id;        ///< Worker number
+};
+
+unsigned
+helm_pool_ncpu(void)
+{
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (unsigned) n : 1;
+}
+
+/** Claim up to \c grain indices from the front of range \c r. */
+static
+int
+claim(struct range * const r,
+      const size_t grain,
+      size_t * const begin,
+      size_t * const end)
+{
+    pthread_mutex_lock(&r->lock);
+    *begin = r->begin;
+    *end   = r->end - r->begin > grain ? r->begin + grain : r->end;
+    r->begin = *end;
+    pthread_mutex_unlock(&r->lock);
+    return *begin < *end;
+}
+
+/** Move the back half of the largest other range into range \c mine. */
+static
+int
+steal(struct pool * const p,
+      const unsigned mine)
+{
+    for (;;) {
+        // Find the victim with the most remaining work
+        unsigned victim = mine;
+        size_t   most   = 0;
+        for (unsigned k = 1; k < p->nworkers; ++k) {
+            const unsigned j = (mine + k) % p->nworkers;
+            pthread_mutex_lock(&p->ranges[j].lock);
+            const size_t left = p->ranges[j].end - p->ranges[j].begin;
+            pthread_mutex_unlock(&p->ranges[j].lock);
+            if (left > most) {
+                most   = left;
+                victim = j;
+            }
+        }
+        if (most == 0) {
+            return 0;  // All work has been claimed
+        }
+
+        // Take the back half, retrying should the victim have drained
+        struct range * const v = &p->ranges[victim];
+        size_t begin, end;
+        pthread_mutex_lock(&v->lock);
+        end      = v->end;
+        begin    = v->begin + (v->end - v->begin) / 2;
+        v->end   = begin;
+        pthread_mutex_unlock(&v->lock);
+        if (begin < end) {
+            struct range * const m = &p->ranges[mine];
+            pthread_mutex_lock(&m->lock);
+            m->begin = begin;
+            m->end   = end;
+            pthread_mutex_unlock(&m->lock);
+            return 1;
+        }
+    }
+}
+
+/** Process claimed indices until no work remains anywhere. */
+static
+void *
+work(void * const arg)
+{
+    struct worker * const w = (struct worker *) arg;
+    struct pool   * const p = w->pool;
+    size_t begin, end;
+    do {
+        while (claim(&p->ranges[w->id], p->grain, &begin, &end)) {
+            p->fn(p->ctx, begin, end, w->id);
+        }
+    } while (steal(p, w->id));
+    return NULL;
+}
+
+unsigned
+helm_pool_run(const size_t n,
+              size_t grain,
+              unsigned nworkers,
+              const helm_pool_fn fn,
+              void * const ctx)
+{
+    if (!nworkers) {
+        nworkers = helm_pool_ncpu();
+    }
+    if (nworkers > n) {
+        nworkers = n ? (unsigned) n : 1;
+    }
+    if (!grain) {
+        grain = n / (64 * (size_t) nworkers);
+        grain = grain < 1 ? 1 : grain > 1024 ? 1024 : grain;
+    }
+
+    struct range  *ranges  = malloc(nworkers * sizeof(*ranges));
+    struct worker *workers = malloc(nworkers * sizeof(*workers));
+    pthread_t     *threads = malloc(nworkers * sizeof(*threads));
+    if (!ranges || !workers || !threads) {
+        free(ranges);
+        free(workers);
+        free(threads);
+        fn(ctx, 0, n, 0);  // Degrade to serial execution
+        return 1;
+    }
+
+    struct pool pool = { ranges, nworkers, grain, fn, ctx };
+    const size_t q = n / nworkers, m = n % nworkers;
+    for (unsigned k = 0; k < nworkers; ++k) {
+        pthread_mutex_init(&ranges[k].lock, NULL);
+        ranges[k].begin = q*k + (k < m ? k : m);
+        ranges[k].end   = ranges[k].begin + q + (k < m);
+        workers[k].pool = &pool;
+        workers[k].id   = k;
+    }
+
+    unsigned started = 1;
+    for (unsigned k = 1; k < nworkers; ++k) {
+        if (0 == pthread_create(&threads[k], NULL, work, &workers[k])) {
+            ++started;
+        } else {
+            workers[k].pool = NULL;  // Marks no thread, range is stolen
+        }
+    }
+    work(&workers[0]);
+    for (unsigned k = 1; k < nworkers; ++k) {
+        if (workers[k].pool) {
+            pthread_join(threads[k], NULL);
+        }
+    }
+
+    for (unsigned k = 0; k < nworkers; ++k) {
+        pthread_mutex_destroy(&ranges[k].lock);
+    }
+    free(ranges);
+    free(workers);
+    free(threads);
+    return started;
+}
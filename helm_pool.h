@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_POOL_H
+#define HELM_POOL_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * A work-stealing thread pool for embarrassingly parallel index ranges.
+ *
+ * Index range <tt>[0, n)</tt> is initially split evenly across workers.
+ * Each worker repeatedly claims \c grain indices from the front of its own
+ * range.  A worker whose range is exhausted steals the back half of the
+ * largest remaining range.  Consequently, when per-index costs vary wildly,
+ * as they do when simulating stable versus unstable closed loops, no worker
+ * idles while work remains and per-claim synchronization is uncontended.
+ */
+
+/**
+ * Callback processing indices <tt>[begin, end)</tt> on worker \c worker.
+ * Worker numbers lie within <tt>[0, nworkers)</tt> so that callers may
+ * maintain per-worker scratch storage without synchronization.
+ */
+typedef void (*helm_pool_fn)(void *ctx,
+                             size_t begin,
+                             size_t end,
+                             unsigned worker);
+
+/** \brief Number of online processors, which is always at least one. */
+unsigned
+helm_pool_ncpu(void);
+
+/**
+ * \brief Invoke \c fn across <tt>[0, n)</tt> using \c nworkers threads.
+ *
+ * The calling thread participates as worker zero.  Returns once every index
+ * has been processed.  Should thread creation fail, ranges seeded for the
+ * missing workers are stolen by the others so that no work is lost.
+ *
+ * \param[in] n        Number of indices to process.
+ * \param[in] grain    Indices claimed at once, where zero selects a default.
+ * \param[in] nworkers Number of workers, where zero selects helm_pool_ncpu().
+ * \param[in] fn       Callback processing claimed indices.
+ * \param[in] ctx      Opaque argument provided to every \c fn invocation.
+ *
+ * \return Number of workers that participated, which is at least one.
+ */
+unsigned
+helm_pool_run(size_t n,
+              size_t grain,
+              unsigned nworkers,
+              helm_pool_fn fn,
+              void *ctx);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_POOL_H */
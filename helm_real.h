@@ -0,0 +1,362 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2014, 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/**
+ * \file
+ * Precision-generic definitions included by \ref helm.h once per type.
+ *
+ * Before inclusion, \c HELM_REAL must name a floating point type and \c
+ * HELM_NAME(x) must decorate identifier \c x with a suffix unique to that
+ * type.  Definitions for \c double carry no suffix, e.g. helm_steady(),
+ * while those for \c float carry suffix \c f, e.g. \c helm_steadyf().
+ * Because every precision shares this single definition, a change to the
+ * scalar update equations cannot drift between precisions.
+ *
+ * Deliberately lacks an include guard.  Include \ref helm.h instead.
+ */
+
+#if !defined(HELM_REAL) || !defined(HELM_NAME)
+#error "Define HELM_REAL and HELM_NAME(x) or include helm.h instead"
+#endif
+
+/**
+ * Tuning parameters and internal state for an incremental PID controller.
+ *
+ * Gain #kp has units of \f$u_0 / y_0\f$ where \f$u_0\f$ and \f$y_0\f$
+ * are the natural actuator and process observable signals, respectively.
+ * Parameter #Tt has units of time multiplied by \f$u_0 / y_0\f$.
+ * Parameters #Td, #Tf, and #Ti possess units of time.  Time units are
+ * fixed by the scaling provided in the \c dt argument to helm_steady().
+ */
+struct HELM_NAME(helm_state)
+{
+    HELM_REAL kp;  /**< Proportional gain modifying P, I, and D terms.    */
+    HELM_REAL Td;  /**< Time scale governing derivative action.
+                        Set to zero to disable derivative control.        */
+    HELM_REAL Tf;  /**< Time scale filtering process observable for D.
+                        Set to infinity to disable observable filtering.  */
+    HELM_REAL Ti;  /**< Time scale governing integral action.
+                        Set to infinity to disable integral control.      */
+    HELM_REAL Tt;  /**< Time scale governing automatic reset.
+                        Set to infinity to disable automatic reset.       */
+    HELM_REAL y;   /**< Internal tracking of the process observable.      */
+    HELM_REAL f;   /**< Internal tracking the filtered process.           */
+};
+
+/**
+ * \brief Reset all tuning parameters, but \e not transient state.
+ *
+ * Resets gain to one and disables filtering, integral action, and derivative
+ * action.  Enable those terms by setting their associated time scales.
+ *
+ * \param[in,out] h Houses tuning parameters to be reset.
+ * \return Argument \c h to permit call chaining.
+ */
+static inline
+struct HELM_NAME(helm_state) *
+HELM_NAME(helm_reset)(struct HELM_NAME(helm_state) * const h)
+{
+    h->kp = 1;        // Unit gain
+    h->Td = 0;        // No derivative action
+    h->Tf = INFINITY; // No filtering
+    h->Ti = INFINITY; // No integral action
+    h->Tt = INFINITY; // No automatic reset
+    return h;
+}
+
+/**
+ * \brief Reset any transient state, but \e not tuning parameters.
+ *
+ * Necessary to achieve bumpless manual-to-automatic transitions
+ * before calling to helm_steady() after a period of manual control,
+ * including \e before the first call to helm_steady().
+ *
+ * \param[in,out] h Houses transient state to be reset.
+ * \return Argument \c h to permit call chaining.
+ */
+static inline
+struct HELM_NAME(helm_state) *
+HELM_NAME(helm_approach)(struct HELM_NAME(helm_state) * const h)
+{
+    assert(h->Td >= 0);
+    assert(h->Tf >  0);
+    assert(h->Ti >  0);
+    assert(h->Tt >  0);
+    h->y = NAN;
+    h->f = NAN;
+    return h;
+}
+
+/**
+ * \brief Compute the increment of helm_steady() without updating \c h.
+ *
+ * This is the single definition of the update equations, shared by
+ * helm_steady() and by instrumented variants such as helm_steady_trace()
+ * so that their increments cannot drift apart.  Requires that \c y not be
+ * NaN and that the filter within \c h has been started.
+ *
+ * \param[in]  h  Tuning parameters and state from the previous call.
+ * \param[in]  dt Time since last samples collected.
+ * \param[in]  r  Reference value.
+ * \param[in]  u  Actuator signal currently observed.
+ * \param[in]  v  Actuator signal currently requested.
+ * \param[in]  y  Observed process output.
+ * \param[out] a  Convex combination parameter \f$\alpha\f$.
+ * \param[out] df Filtered difference for \c y, which advances \c h->f.
+ * \param[out] dy Backward difference for \c y.
+ *
+ * \return Incremental suggested change to control signal \c v.
+ */
+static inline
+HELM_REAL
+HELM_NAME(helm_steady_terms)(const struct HELM_NAME(helm_state) * const h,
+                             const HELM_REAL dt,
+                             const HELM_REAL r,
+                             const HELM_REAL u,
+                             const HELM_REAL v,
+                             const HELM_REAL y,
+                             HELM_REAL * const a,
+                             HELM_REAL * const df,
+                             HELM_REAL * const dy)
+{
+    HELM_REAL dv = 0;
+    *a  = dt / (h->Tf + dt);              // Convex combination parameter alpha
+    *df = *a*(y - h->f);                  // Filtered difference for y
+    *dy =     y - h->y ;                  // Backward difference for y
+    dv += (r - y) / h->Ti;                // Action from integral control
+    dv += (u - v) / h->Tt;                // Action from automatic reset
+    dv *= dt;                             // Scale integral actions by time step
+    dv += (h->Td / h->Tf)*(*df - *dy);    // Action from derivative control
+    dv += /*dr=0*/ - *dy;                 // Action from proporational control
+    dv *= h->kp;                          // Scale by unified gain parameter
+    return dv;
+}
+
+/**
+ * \brief Find the control signal necessary to steady unsteady process y(t).
+ *
+ * \param[in,out] h  Tuning parameters and state maintained across invocations.
+ * \param[in]     dt Time since last samples collected.
+ * \param[in]     r  Reference value, often called the "setpoint".
+ * \param[in]     u  Actuator signal currently observed.
+ * \param[in]     v  Actuator signal currently requested.
+ * \param[in]     y  Observed process output to drive to \c r.
+ *
+ * \return Incremental suggested change to control signal \c v.
+ * \see Overview of \ref helm.h for the discrete evolution equations.
+ */
+static inline
+HELM_REAL
+HELM_NAME(helm_steady)(struct HELM_NAME(helm_state) * const h,
+                       const HELM_REAL dt,
+                       const HELM_REAL r,
+                       const HELM_REAL u,
+                       const HELM_REAL v,
+                       const HELM_REAL y)
+{
+    HELM_REAL dv = 0;
+
+    if (!isnan(y)) {                      // Avoid driving blind
+
+        if (isnan(h->f)) {                // Avoid startup kick
+            h->y = y;
+            h->f = y;
+        }
+
+        HELM_REAL a, df, dy;
+        dv = HELM_NAME(helm_steady_terms)(h, dt, r, u, v, y, &a, &df, &dy);
+
+        h->y  = y;                        // Update observable for next call
+        h->f += df;                       // Update filter for next call
+    }
+
+    return dv;
+}
+
+/**
+ * \brief Replay helm_steady() across an entire time series.
+ *
+ * Transient state is held in locals across the loop and stored back into
+ * \c h only once, so each sample costs no more than the arithmetic within
+ * helm_steady().  Samples with a NaN observable are skipped exactly as
+ * helm_steady() skips them.  No memory is allocated.
+ *
+ * By default, on entry \c v[i] holds the actuator signal requested at sample
+ * \c i and on exit holds the increment helm_steady() suggests at sample \c i.
+ * Given #HELM_SERIES_ACCUMULATE, only \c v[0] is read on entry as the signal
+ * requested before the first sample and on exit \c v[i] holds the signal
+ * after accumulating the increments through sample \c i.  Given
+ * #HELM_SERIES_DT_CONSTANT, only \c dt[0] is read and used for every sample.
+ *
+ * \param[in,out] h     Tuning parameters and state maintained across samples.
+ * \param[in]     n     Number of samples within each array.
+ * \param[in]     dt    Times since previous samples were collected.
+ * \param[in]     r     Reference values, often called "setpoints".
+ * \param[in]     u     Actuator signals observed.
+ * \param[in,out] v     Actuator signals requested on entry and either
+ *                      increments or accumulated signals on exit.
+ * \param[in]     y     Observed process outputs to drive to \c r.
+ * \param[in]     flags Bitwise-or of #helm_series_flags values, or zero.
+ *
+ * \return Argument \c h to permit call chaining.
+ */
+static inline
+struct HELM_NAME(helm_state) *
+HELM_NAME(helm_steady_series)(struct HELM_NAME(helm_state) * const h,
+                              const size_t n,
+                              const HELM_REAL * const dt,
+                              const HELM_REAL * const r,
+                              const HELM_REAL * const u,
+                              HELM_REAL * const v,
+                              const HELM_REAL * const y,
+                              const unsigned flags)
+{
+    struct HELM_NAME(helm_state) s = *h;  // Promoted to registers
+    const size_t    ds  = (flags & HELM_SERIES_DT_CONSTANT) ? 0 : 1;
+    const int       acc = (flags & HELM_SERIES_ACCUMULATE) != 0;
+    HELM_REAL       w   = n ? v[0] : 0;   // Accumulated request
+
+    for (size_t i = 0; i < n; ++i) {
+        if (acc) {
+            w   += HELM_NAME(helm_steady)(&s, dt[i*ds], r[i], u[i], w, y[i]);
+            v[i] = w;
+        } else {
+            v[i] = HELM_NAME(helm_steady)(&s, dt[i*ds], r[i], u[i], v[i], y[i]);
+        }
+    }
+
+    *h = s;
+    return h;
+}
+
+/**
+ * Division-free coefficients equivalent to a helm_state at fixed \c dt.
+ *
+ * Produced by helm_compile() and consumed by helm_steady_compiled().  Members
+ * #dt, #kp, #Td, #Tf, #Ti, and #Tt record the tuning from which the record
+ * was compiled so that any change can be detected and the record rebuilt.
+ */
+struct HELM_NAME(helm_compiled)
+{
+    HELM_REAL dt;     /**< Time step for which the record was compiled.    */
+    HELM_REAL kp;     /**< Compiled from helm_state::kp.                    */
+    HELM_REAL Td;     /**< Compiled from helm_state::Td.                    */
+    HELM_REAL Tf;     /**< Compiled from helm_state::Tf.                    */
+    HELM_REAL Ti;     /**< Compiled from helm_state::Ti.                    */
+    HELM_REAL Tt;     /**< Compiled from helm_state::Tt.                    */
+    HELM_REAL alpha;  /**< Filter parameter \f$dt / (T_f + dt)\f$.          */
+    HELM_REAL ki;     /**< Integral coefficient \f$k_p\,dt / T_i\f$.        */
+    HELM_REAL kt;     /**< Automatic reset coefficient \f$k_p\,dt / T_t\f$. */
+    HELM_REAL kd;     /**< Derivative coefficient \f$k_p\,T_d / T_f\f$.     */
+};
+
+/**
+ * \brief Compile the tuning within \c h for repeated use at time step \c dt.
+ *
+ * \param[in] h  Tuning parameters to compile.  Transient state is ignored.
+ * \param[in] dt Time step to be provided to helm_steady_compiled().
+ *
+ * \return A record for use with helm_steady_compiled().
+ */
+static inline
+struct HELM_NAME(helm_compiled)
+HELM_NAME(helm_compile)(const struct HELM_NAME(helm_state) * const h,
+                        const HELM_REAL dt)
+{
+    struct HELM_NAME(helm_compiled) c;
+    c.dt    = dt;
+    c.kp    = h->kp;
+    c.Td    = h->Td;
+    c.Tf    = h->Tf;
+    c.Ti    = h->Ti;
+    c.Tt    = h->Tt;
+    c.alpha = dt / (h->Tf + dt);  // Identical to helm_steady()
+    c.ki    = h->kp * dt / h->Ti;
+    c.kt    = h->kp * dt / h->Tt;
+    c.kd    = h->kp * (h->Td / h->Tf);
+    return c;
+}
+
+/**
+ * \brief Division-free equivalent of helm_steady() for mostly-fixed \c dt.
+ *
+ * Record \c c is rebuilt via helm_compile() whenever \c dt or any tuning
+ * parameter within \c h differs from the values it was compiled from.  The
+ * comparisons are predictable branches, so a constant \c dt with occasional
+ * retuning pays the four divisions within helm_steady() only on change.
+ *
+ * Transient state evolves identically to helm_steady() because the filter
+ * parameter \f$\alpha\f$ is computed by the same expression.  The returned
+ * increment differs only by rounding from reassociating the four terms
+ * \f$T_I = k_p\,dt\,(r - y)/T_i\f$, \f$T_R = k_p\,dt\,(u - v)/T_t\f$,
+ * \f$T_D = k_p\,(T_d/T_f)\,(\mathrm{d}f - \mathrm{d}y)\f$, and
+ * \f$T_P = k_p\,\mathrm{d}y\f$.  Both evaluations incur at most seven
+ * roundings per term, so to first order in machine epsilon \f$\epsilon\f$
+ * \f{align}{
+ *     \left|
+ *         \text{helm\_steady\_compiled()} - \text{helm\_steady()}
+ *     \right|
+ *     \leq
+ *     7 \epsilon \left(|T_I| + |T_R| + |T_D| + |T_P|\right)
+ *     .
+ * \f}
+ * That is, the bound is relative to the magnitude of the individual terms and
+ * not to their sum, which may suffer cancellation.
+ *
+ * \param[in,out] h  Tuning parameters and state maintained across invocations.
+ * \param[in,out] c  Record from helm_compile(), rebuilt when stale.
+ * \param[in]     dt Time since last samples collected.
+ * \param[in]     r  Reference value, often called the "setpoint".
+ * \param[in]     u  Actuator signal currently observed.
+ * \param[in]     v  Actuator signal currently requested.
+ * \param[in]     y  Observed process output to drive to \c r.
+ *
+ * \return Incremental suggested change to control signal \c v.
+ * \see helm_steady() for the reference implementation.
+ */
+static inline
+HELM_REAL
+HELM_NAME(helm_steady_compiled)(struct HELM_NAME(helm_state) * const h,
+                                struct HELM_NAME(helm_compiled) * const c,
+                                const HELM_REAL dt,
+                                const HELM_REAL r,
+                                const HELM_REAL u,
+                                const HELM_REAL v,
+                                const HELM_REAL y)
+{
+    HELM_REAL dv = 0;
+
+    if (   c->dt != dt    || c->kp != h->kp
+        || c->Td != h->Td || c->Tf != h->Tf
+        || c->Ti != h->Ti || c->Tt != h->Tt) {
+        *c = HELM_NAME(helm_compile)(h, dt);  // Rebuild on retuning or dt
+    }
+
+    if (!isnan(y)) {                      // Avoid driving blind
+
+        if (isnan(h->f)) {                // Avoid startup kick
+            h->y = y;
+            h->f = y;
+        }
+
+        HELM_REAL df, dy;
+        df  = c->alpha*(y - h->f);        // Filtered difference for y
+        dy  =          y - h->y ;         // Backward difference for y
+        dv  = c->ki*(r - y)               // Action from integral control
+            + c->kt*(u - v)               // Action from automatic reset
+            + c->kd*(df - dy)             // Action from derivative control
+            - c->kp*dy;                   // Action from proporational control
+
+        h->y  = y;                        // Update observable for next call
+        h->f += df;                       // Update filter for next call
+    }
+
+    return dv;
+}
@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_retune.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_retune.h"
+
+extern
+unsigned
+helm_retune_init(struct helm_retune * const p,
+                 const struct helm_state * const h);
+
+extern
+struct helm_retune *
+helm_retune_publish(struct helm_retune * const p,
+                    const struct helm_state * const t);
+
+extern
+int
+helm_retune_apply(struct helm_retune * const p,
+                  unsigned * const seen,
+                  struct helm_state * const h);
+
+extern
+double
+helm_steady_retuned(struct helm_retune * const p,
+                    unsigned * const seen,
+                    struct helm_state * const h,
+                    const double dt,
+                    const double r,
+                    const double u,
+                    const double v,
+                    const double y);
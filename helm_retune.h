@@ -0,0 +1,193 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_RETUNE_H
+#define HELM_RETUNE_H
+
+#include "helm.h"
+
+#if !defined(__GNUC__)
+#error "helm_retune.h requires GNU-style __atomic builtins"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Lock-free retuning of a running controller by another thread.
+ *
+ * A control thread repeatedly invoking helm_steady() while an operator
+ * thread adjusts \c kp, \c Td, \c Tf, \c Ti, and \c Tt must never observe a
+ * torn parameter set.  Here the operator publishes complete parameter sets
+ * into a helm_retune block protected by a sequence lock.  At each step
+ * boundary, the control thread compares the block's sequence number against
+ * the one it last applied.  In the common case nothing changed, which costs
+ * one load from a cache line the operator has not written and so remains
+ * shared in the control thread's cache.  When something changed, the new
+ * parameters are copied into the helm_state and the sequence number rechecked.
+ * Should the operator be mid-update, the copy is discarded and the previous
+ * tuning retained for one more step.  Neither thread ever blocks.
+ *
+ * Retuning touches only tuning parameters and never the transient state
+ * \c y and \c f.  Because helm_steady() is incremental, the control signal
+ * therefore remains continuous across the change in the same way it does
+ * across helm_approach().  No call to helm_approach() is necessary.
+ *
+ * Sample with the control and operator threads sharing \c p:
+ * \code
+ *   // Control thread
+ *   unsigned seen = helm_retune_init(&p, &h);
+ *   helm_approach(&h);
+ *   for (;;) {
+ *      y  = process(dt, u);
+ *      v += helm_steady_retuned(&p, &seen, &h, dt, r, u, v, y);
+ *      u  = actuate(dt, v);
+ *   }
+ *
+ *   // Operator thread
+ *   struct helm_state t = h_proposed;
+ *   helm_retune_publish(&p, &t);
+ * \endcode
+ */
+
+/**
+ * A parameter block shared between one publishing thread and one or more
+ * controlling threads.  Aligned so that it occupies a single cache line.
+ * Members must only be accessed through the functions below.
+ */
+struct helm_retune
+{
+    unsigned seq;  /**< Sequence number, odd while an update is underway. */
+    double   kp;   /**< Published helm_state::kp.                         */
+    double   Td;   /**< Published helm_state::Td.                         */
+    double   Tf;   /**< Published helm_state::Tf.                         */
+    double   Ti;   /**< Published helm_state::Ti.                         */
+    double   Tt;   /**< Published helm_state::Tt.                         */
+} __attribute__((aligned(64)));
+
+/**
+ * \brief Initialize \c p with the tuning within \c h.
+ *
+ * Must complete before \c p is shared between threads.
+ *
+ * \return Sequence number to track as already applied to \c h.
+ */
+static inline
+unsigned
+helm_retune_init(struct helm_retune * const p,
+                 const struct helm_state * const h)
+{
+    p->seq = 0;
+    p->kp  = h->kp;
+    p->Td  = h->Td;
+    p->Tf  = h->Tf;
+    p->Ti  = h->Ti;
+    p->Tt  = h->Tt;
+    return 0;
+}
+
+/**
+ * \brief Publish the tuning parameters within \c t into \c p.
+ *
+ * Wait-free.  Publishers must be serialized by the caller, e.g. by only
+ * ever publishing from one operator thread.  Transient state within \c t is
+ * ignored.
+ *
+ * \return Argument \c p to permit call chaining.
+ */
+static inline
+struct helm_retune *
+helm_retune_publish(struct helm_retune * const p,
+                    const struct helm_state * const t)
+{
+    const unsigned s = __atomic_load_n(&p->seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->seq, s + 1, __ATOMIC_RELAXED);  // Begin update
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store(&p->kp, &t->kp, __ATOMIC_RELAXED);
+    __atomic_store(&p->Td, &t->Td, __ATOMIC_RELAXED);
+    __atomic_store(&p->Tf, &t->Tf, __ATOMIC_RELAXED);
+    __atomic_store(&p->Ti, &t->Ti, __ATOMIC_RELAXED);
+    __atomic_store(&p->Tt, &t->Tt, __ATOMIC_RELAXED);
+    __atomic_store_n(&p->seq, s + 2, __ATOMIC_RELEASE);  // End update
+    return p;
+}
+
+/**
+ * \brief Apply any newly published tuning from \c p into \c h.
+ *
+ * Wait-free.  Invoke only at step boundaries, i.e. between calls to
+ * helm_steady().  Transient state within \c h is untouched.
+ *
+ * \param[in]     p    Parameter block shared with the publisher.
+ * \param[in,out] seen Sequence number most recently applied to \c h.
+ * \param[in,out] h    Controller to retune.
+ *
+ * \return Nonzero if and only if a new tuning was applied.
+ */
+static inline
+int
+helm_retune_apply(struct helm_retune * const p,
+                  unsigned * const seen,
+                  struct helm_state * const h)
+{
+    const unsigned s = __atomic_load_n(&p->seq, __ATOMIC_ACQUIRE);
+    if (__builtin_expect(s == *seen, 1) || (s & 1)) {
+        return 0;                         // Unchanged or mid-update
+    }
+
+    double kp, Td, Tf, Ti, Tt;
+    __atomic_load(&p->kp, &kp, __ATOMIC_RELAXED);
+    __atomic_load(&p->Td, &Td, __ATOMIC_RELAXED);
+    __atomic_load(&p->Tf, &Tf, __ATOMIC_RELAXED);
+    __atomic_load(&p->Ti, &Ti, __ATOMIC_RELAXED);
+    __atomic_load(&p->Tt, &Tt, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&p->seq, __ATOMIC_RELAXED) != s) {
+        return 0;                         // Torn, so retry next step
+    }
+
+    h->kp = kp;
+    h->Td = Td;
+    h->Tf = Tf;
+    h->Ti = Ti;
+    h->Tt = Tt;
+    *seen = s;
+    return 1;
+}
+
+/**
+ * \brief Apply any newly published tuning and then invoke helm_steady().
+ *
+ * \param[in]     p    Parameter block shared with the publisher.
+ * \param[in,out] seen Sequence number most recently applied to \c h.
+ * \copydetails helm_steady()
+ */
+static inline
+double
+helm_steady_retuned(struct helm_retune * const p,
+                    unsigned * const seen,
+                    struct helm_state * const h,
+                    const double dt,
+                    const double r,
+                    const double u,
+                    const double v,
+                    const double y)
+{
+    helm_retune_apply(p, seen, h);
+    return helm_steady(h, dt, r, u, v, y);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_RETUNE_H */
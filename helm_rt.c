@@ -0,0 +1,481 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Implementation of the multi-rate scheduler within \ref helm_rt.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "helm_rt.h"
+
+/** Controllers sharing one period and callback. */
+struct group
+{
+    long               period;  ///< Nanoseconds between deadlines
+    helm_rt_fn         fn;      ///< User callback
+    void              *ctx;     ///< User callback argument
+    size_t             n;       ///< Controllers added
+    size_t             cap;     ///< Capacity of #init
+    struct helm_state *init;    ///< Controllers added prior to start
+    struct helm_bank   bank;    ///< Controllers stepped once started
+    void              *mem;     ///< Storage for #bank or NULL if not built
+    double            *arrays;  ///< Storage for #dt through #dv
+    double            *dt;      ///< Measured time step for every lane
+    double            *r;       ///< See helm_rt_io::r
+    double            *u;       ///< See helm_rt_io::u
+    double            *v;       ///< See helm_rt_io::v
+    double            *y;       ///< See helm_rt_io::y
+    double            *dv;      ///< See helm_rt_io::dv
+    int                fd;      ///< Armed timerfd or negative
+    unsigned           thread;  ///< Thread stepping this group
+    int64_t            next;    ///< Next deadline in nanoseconds
+    double             last;    ///< Previous wakeup in seconds or NaN
+    struct helm_rt_stats stats; ///< Counters updated by #thread
+};
+
+/** One stepping thread. */
+struct thread
+{
+    struct helm_rt *rt;       ///< Owning scheduler
+    int             cpu;      ///< CPU to which the thread is pinned
+    struct pollfd  *pfd;      ///< Timers for assigned groups then #stopfd
+    int            *gid;      ///< Group for each timer within #pfd
+    int             m;        ///< Number of assigned groups
+    int             running;  ///< Whether #handle requires joining
+    pthread_t       handle;   ///< Thread handle
+};
+
+struct helm_rt
+{
+    unsigned       nthreads;  ///< Number of threads
+    struct thread *threads;   ///< Every thread
+    int            ngroups;   ///< Number of groups
+    int            cap;       ///< Capacity of #groups
+    struct group  *groups;    ///< Every group
+    int            stopfd;    ///< Readable once stopping or negative
+    int            running;   ///< Whether started and not yet stopped
+};
+
+/** Current CLOCK_MONOTONIC time in nanoseconds. */
+static
+int64_t
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/** Convert nanoseconds into a timespec. */
+static
+struct timespec
+to_timespec(const int64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec  = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    return ts;
+}
+
+/** Single-writer increment of a counter read concurrently. */
+static
+void
+bump(uint64_t * const counter, const uint64_t by)
+{
+    __atomic_store_n(counter, *counter + by, __ATOMIC_RELAXED);
+}
+
+/** Take one step of group \c g whose timer has expired. */
+static
+void
+step(struct group * const g)
+{
+    uint64_t expired;
+    if (sizeof(expired) != read(g->fd, &expired, sizeof(expired))
+            || !expired) {
+        return;  // Spurious wakeup
+    }
+    const int64_t t        = now();
+    const int64_t deadline = g->next + (int64_t) (expired - 1) * g->period;
+    g->next = deadline + g->period;
+
+    // Account for misses and lateness of this wakeup
+    const uint64_t late = t > deadline ? (uint64_t) (t - deadline) : 0;
+    int bucket = late < 2 ? 0 : 63 - __builtin_clzll(late);
+    if (bucket >= HELM_RT_BUCKETS) {
+        bucket = HELM_RT_BUCKETS - 1;
+    }
+    bump(&g->stats.steps, 1);
+    bump(&g->stats.misses, expired - 1);
+    bump(&g->stats.late[bucket], 1);
+
+    // Measure the true time step and advance the bank
+    struct helm_rt_io io;
+    io.n    = g->n;
+    io.t    = 1e-9 * t;
+    io.dt   = isnan(g->last) ? 1e-9 * g->period : io.t - g->last;
+    io.r    = g->r;
+    io.u    = g->u;
+    io.v    = g->v;
+    io.y    = g->y;
+    io.dv   = g->dv;
+    io.bank = &g->bank;
+    g->last = io.t;
+    for (size_t k = 0; k < g->n; ++k) {
+        g->dt[k] = io.dt;
+    }
+    g->fn(g->ctx, HELM_RT_SENSE, &io);
+    helm_bank_steady(&g->bank, g->dt, g->r, g->u, g->v, g->y, g->dv);
+    g->fn(g->ctx, HELM_RT_ACTUATE, &io);
+}
+
+/** Thread body stepping assigned groups until #helm_rt::stopfd fires. */
+static
+void *
+run(void * const arg)
+{
+    struct thread  * const th = (struct thread *) arg;
+    struct helm_rt * const rt = th->rt;
+    for (;;) {
+        if (poll(th->pfd, th->m + 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (th->pfd[th->m].revents) {
+            break;  // Stopping
+        }
+        for (int j = 0; j < th->m; ++j) {
+            if (th->pfd[j].revents & POLLIN) {
+                step(&rt->groups[th->gid[j]]);
+            }
+        }
+    }
+    return NULL;
+}
+
+struct helm_rt *
+helm_rt_create(unsigned nthreads,
+               const int *cpus)
+{
+    // Determine CPUs available to this process
+    cpu_set_t mask;
+    int avail[CPU_SETSIZE], navail = 0;
+    if (0 == sched_getaffinity(0, sizeof(mask), &mask)) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &mask)) {
+                avail[navail++] = c;
+            }
+        }
+    }
+    if (!navail) {
+        avail[navail++] = 0;
+    }
+    if (!nthreads) {
+        nthreads = (unsigned) navail;
+    }
+
+    struct helm_rt * const rt = calloc(1, sizeof(*rt));
+    if (!rt || !(rt->threads = calloc(nthreads, sizeof(*rt->threads)))) {
+        free(rt);
+        return NULL;
+    }
+    rt->nthreads = nthreads;
+    rt->stopfd   = -1;
+    for (unsigned k = 0; k < nthreads; ++k) {
+        rt->threads[k].rt  = rt;
+        rt->threads[k].cpu = cpus ? cpus[k] : avail[k % navail];
+    }
+    return rt;
+}
+
+int
+helm_rt_group(struct helm_rt *rt,
+              long period,
+              helm_rt_fn fn,
+              void *ctx)
+{
+    if (rt->running || period <= 0 || !fn) {
+        return -1;
+    }
+    for (int i = 0; i < rt->ngroups; ++i) {
+        const struct group * const g = &rt->groups[i];
+        if (g->period == period && g->fn == fn && g->ctx == ctx) {
+            return i;
+        }
+    }
+    if (rt->ngroups == rt->cap) {
+        const int cap = rt->cap ? 2*rt->cap : 4;
+        struct group * const groups = realloc(rt->groups,
+                                              cap * sizeof(*groups));
+        if (!groups) {
+            return -1;
+        }
+        rt->groups = groups;
+        rt->cap    = cap;
+    }
+    struct group * const g = &rt->groups[rt->ngroups];
+    memset(g, 0, sizeof(*g));
+    g->period = period;
+    g->fn     = fn;
+    g->ctx    = ctx;
+    g->fd     = -1;
+    return rt->ngroups++;
+}
+
+long
+helm_rt_add(struct helm_rt *rt,
+            int group,
+            const struct helm_state *h)
+{
+    if (rt->running || group < 0 || group >= rt->ngroups) {
+        return -1;
+    }
+    struct group * const g = &rt->groups[group];
+    if (g->mem) {
+        return -1;  // Bank already built by an earlier start
+    }
+    if (g->n == g->cap) {
+        const size_t cap = g->cap ? 2*g->cap : 16;
+        struct helm_state * const init = realloc(g->init,
+                                                 cap * sizeof(*init));
+        if (!init) {
+            return -1;
+        }
+        g->init = init;
+        g->cap  = cap;
+    }
+    g->init[g->n] = *h;
+    return (long) g->n++;
+}
+
+/** Build the bank and arrays for group \c g when not already built. */
+static
+int
+build(struct group * const g)
+{
+    if (g->mem) {
+        return 0;
+    }
+    const size_t n = g->n ? g->n : 1;
+    if (posix_memalign(&g->mem, HELM_BANK_ALIGN, helm_bank_bytes(n))) {
+        g->mem = NULL;
+        return ENOMEM;
+    }
+    if (posix_memalign((void **) &g->arrays, HELM_BANK_ALIGN,
+                       6 * n * sizeof(double))) {
+        free(g->mem);
+        g->mem = NULL;
+        return ENOMEM;
+    }
+    memset(g->arrays, 0, 6 * n * sizeof(double));
+    g->dt = g->arrays + 0*n;
+    g->r  = g->arrays + 1*n;
+    g->u  = g->arrays + 2*n;
+    g->v  = g->arrays + 3*n;
+    g->y  = g->arrays + 4*n;
+    g->dv = g->arrays + 5*n;
+    helm_bank_init(&g->bank, g->n, g->mem);
+    for (size_t k = 0; k < g->n; ++k) {
+        helm_bank_set(&g->bank, k, &g->init[k]);
+    }
+    return 0;
+}
+
+/** Assign each group to the least loaded thread, heaviest groups first. */
+static
+void
+assign(struct helm_rt * const rt)
+{
+    double * const load = calloc(rt->nthreads, sizeof(*load));
+    for (int i = 0; i < rt->ngroups; ++i) {
+        rt->groups[i].thread = UINT_MAX;
+    }
+    for (int a = 0; a < rt->ngroups; ++a) {
+        int    heaviest = 0;
+        double most     = -1;
+        for (int i = 0; i < rt->ngroups; ++i) {
+            const double w = (rt->groups[i].n + 1.0) / rt->groups[i].period;
+            if (rt->groups[i].thread == UINT_MAX && w > most) {
+                most     = w;
+                heaviest = i;
+            }
+        }
+        unsigned least = a % rt->nthreads;  // Round-robin absent load
+        for (unsigned k = 0; load && k < rt->nthreads; ++k) {
+            if (load[k] < load[least]) {
+                least = k;
+            }
+        }
+        if (load) {
+            load[least] += most;
+        }
+        rt->groups[heaviest].thread = least;
+    }
+    free(load);
+}
+
+int
+helm_rt_start(struct helm_rt *rt)
+{
+    if (rt->running) {
+        return EBUSY;
+    }
+    int err = 0;
+    for (int i = 0; !err && i < rt->ngroups; ++i) {
+        err = build(&rt->groups[i]);
+    }
+    if (err) {
+        return err;
+    }
+    assign(rt);
+
+    // Prepare per-thread poll sets
+    rt->stopfd = eventfd(0, EFD_CLOEXEC);
+    if (rt->stopfd < 0) {
+        return errno;
+    }
+    for (unsigned k = 0; !err && k < rt->nthreads; ++k) {
+        struct thread * const th = &rt->threads[k];
+        th->m   = 0;
+        th->pfd = malloc((rt->ngroups + 1) * sizeof(*th->pfd));
+        th->gid = malloc((rt->ngroups + 1) * sizeof(*th->gid));
+        err = th->pfd && th->gid ? 0 : ENOMEM;
+    }
+
+    // Arm every timer against one common epoch
+    const int64_t epoch = now();
+    for (int i = 0; !err && i < rt->ngroups; ++i) {
+        struct group * const g = &rt->groups[i];
+        g->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (g->fd < 0) {
+            err = errno;
+            break;
+        }
+        struct itimerspec its;
+        g->next         = epoch + g->period;
+        g->last         = NAN;
+        its.it_value    = to_timespec(g->next);
+        its.it_interval = to_timespec(g->period);
+        if (timerfd_settime(g->fd, TFD_TIMER_ABSTIME, &its, NULL)) {
+            err = errno;
+            break;
+        }
+        struct thread * const th = &rt->threads[g->thread];
+        th->pfd[th->m].fd     = g->fd;
+        th->pfd[th->m].events = POLLIN;
+        th->gid[th->m++]      = i;
+    }
+
+    // Launch pinned threads
+    for (unsigned k = 0; !err && k < rt->nthreads; ++k) {
+        struct thread * const th = &rt->threads[k];
+        th->pfd[th->m].fd     = rt->stopfd;
+        th->pfd[th->m].events = POLLIN;
+        cpu_set_t cpu;
+        CPU_ZERO(&cpu);
+        CPU_SET(th->cpu, &cpu);
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        err = pthread_attr_setaffinity_np(&attr, sizeof(cpu), &cpu);
+        if (!err) {
+            err = pthread_create(&th->handle, &attr, run, th);
+        }
+        pthread_attr_destroy(&attr);
+        th->running = !err;
+    }
+
+    rt->running = 1;
+    if (err) {
+        helm_rt_stop(rt);
+    }
+    return err;
+}
+
+void
+helm_rt_stop(struct helm_rt *rt)
+{
+    if (!rt->running) {
+        return;
+    }
+    const uint64_t one = 1;
+    if (sizeof(one) != write(rt->stopfd, &one, sizeof(one))) {
+        abort();  // Threads could never be joined
+    }
+    for (unsigned k = 0; k < rt->nthreads; ++k) {
+        struct thread * const th = &rt->threads[k];
+        if (th->running) {
+            pthread_join(th->handle, NULL);
+            th->running = 0;
+        }
+        free(th->pfd);
+        free(th->gid);
+        th->pfd = NULL;
+        th->gid = NULL;
+    }
+    for (int i = 0; i < rt->ngroups; ++i) {
+        if (rt->groups[i].fd >= 0) {
+            close(rt->groups[i].fd);
+            rt->groups[i].fd = -1;
+        }
+    }
+    close(rt->stopfd);
+    rt->stopfd  = -1;
+    rt->running = 0;
+}
+
+int
+helm_rt_stats(const struct helm_rt *rt,
+              int group,
+              struct helm_rt_stats *s)
+{
+    if (group < 0 || group >= rt->ngroups) {
+        return EINVAL;
+    }
+    const struct helm_rt_stats * const src = &rt->groups[group].stats;
+    s->steps  = __atomic_load_n(&src->steps,  __ATOMIC_RELAXED);
+    s->misses = __atomic_load_n(&src->misses, __ATOMIC_RELAXED);
+    for (int b = 0; b < HELM_RT_BUCKETS; ++b) {
+        s->late[b] = __atomic_load_n(&src->late[b], __ATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+void
+helm_rt_destroy(struct helm_rt *rt)
+{
+    if (!rt) {
+        return;
+    }
+    helm_rt_stop(rt);
+    for (int i = 0; i < rt->ngroups; ++i) {
+        free(rt->groups[i].init);
+        free(rt->groups[i].mem);
+        free(rt->groups[i].arrays);
+    }
+    free(rt->groups);
+    free(rt->threads);
+    free(rt);
+}
@@ -0,0 +1,179 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_RT_H
+#define HELM_RT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helm.h"
+#include "helm_bank.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * A multi-rate, real-time scheduler driving many controllers from a few
+ * CPU-pinned threads on Linux.
+ *
+ * Controllers sharing a period form a group advanced as one helm_bank by
+ * helm_bank_steady().  Each group owns a \c timerfd armed with absolute
+ * \c CLOCK_MONOTONIC deadlines so that periods never drift.  Groups are
+ * assigned to threads greedily by load, namely controllers per second, and
+ * each thread sleeps in \c poll() until one of its groups falls due.  On
+ * every wakeup, the time elapsed since the group's previous wakeup is
+ * measured and passed to helm_bank_steady() as \c dt, so jitter shifts
+ * discretization rather than being ignored.
+ *
+ * Every step invokes the group's callback twice.  During #HELM_RT_SENSE the
+ * callback fills the reference, actuator, request, and observable arrays.
+ * During #HELM_RT_ACTUATE it consumes the suggested increments.  Arrays
+ * persist across steps so a callback need only refresh what changed.
+ *
+ * Per group, helm_rt_stats() reports steps taken, deadlines missed as
+ * counted by timer expirations that elapsed without a step, and a log2
+ * histogram of wakeup lateness.
+ *
+ * Sample:
+ * \code
+ *   struct helm_rt * const rt = helm_rt_create(2, NULL);
+ *   const int fast = helm_rt_group(rt, 1000000, io, &plant);   // 1 kHz
+ *   for (size_t i = 0; i < n; ++i) {
+ *       helm_rt_add(rt, fast, &h[i]);
+ *   }
+ *   helm_rt_start(rt);
+ *   // ...
+ *   helm_rt_stop(rt);
+ *   helm_rt_destroy(rt);
+ * \endcode
+ */
+
+/** Phases within one group step at which the group callback is invoked. */
+enum helm_rt_phase
+{
+    HELM_RT_SENSE   = 0,  /**< Fill \c r, \c u, \c v, and \c y.  */
+    HELM_RT_ACTUATE = 1   /**< Consume \c dv.                    */
+};
+
+/** Arrays and timing exchanged with a group callback on each step. */
+struct helm_rt_io
+{
+    size_t            n;     /**< Number of controllers within the group.  */
+    double            t;     /**< Wakeup time in seconds, CLOCK_MONOTONIC. */
+    double            dt;    /**< Measured seconds since previous wakeup.  */
+    double           *r;     /**< References, indexed by lane.             */
+    double           *u;     /**< Actuator signals observed.               */
+    double           *v;     /**< Actuator signals requested.              */
+    double           *y;     /**< Observed process outputs.                */
+    const double     *dv;    /**< Suggested increments from this step.     */
+    struct helm_bank *bank;  /**< Controllers, owned by the stepping thread. */
+};
+
+/** Callback invoked on the group's thread during each \c phase. */
+typedef void (*helm_rt_fn)(void *ctx,
+                           enum helm_rt_phase phase,
+                           struct helm_rt_io *io);
+
+/** Buckets within helm_rt_stats::late. */
+#define HELM_RT_BUCKETS 32
+
+/** Counters accumulated by one group. */
+struct helm_rt_stats
+{
+    uint64_t steps;   /**< Steps taken.                                    */
+    uint64_t misses;  /**< Deadlines that passed without a step.           */
+    /**
+     * Wakeups by lateness past deadline, where bucket \c k counts lateness
+     * within <tt>[2^k, 2^(k+1))</tt> nanoseconds.  Bucket zero additionally
+     * counts on-time wakeups and the final bucket counts all longer delays.
+     */
+    uint64_t late[HELM_RT_BUCKETS];
+};
+
+/** Opaque scheduler. */
+struct helm_rt;
+
+/**
+ * \brief Create a scheduler with \c nthreads threads, none yet started.
+ *
+ * \param[in] nthreads Number of threads, where zero selects one per CPU.
+ * \param[in] cpus     CPU for each thread or NULL to pin thread \c k to the
+ *                     \c k-th CPU available to the process, modulo count.
+ * \return New scheduler or NULL on allocation failure.
+ */
+struct helm_rt *
+helm_rt_create(unsigned nthreads,
+               const int *cpus);
+
+/**
+ * \brief Obtain the group stepping every \c period nanoseconds through \c
+ * fn and \c ctx, creating the group if no such group yet exists.
+ *
+ * Must precede helm_rt_start().
+ *
+ * \return Group number or negative on invalid arguments or allocation
+ *         failure.
+ */
+int
+helm_rt_group(struct helm_rt *rt,
+              long period,
+              helm_rt_fn fn,
+              void *ctx);
+
+/**
+ * \brief Add a copy of controller \c h to \c group.
+ *
+ * Must precede helm_rt_start().  The copy is stepped in place of \c h.
+ *
+ * \return Lane within the group's arrays or negative on failure.
+ */
+long
+helm_rt_add(struct helm_rt *rt,
+            int group,
+            const struct helm_state *h);
+
+/**
+ * \brief Assign groups to threads, arm timers, and begin stepping.
+ *
+ * \return Zero on success or an \c errno value on failure, in which case
+ *         no thread remains running.
+ */
+int
+helm_rt_start(struct helm_rt *rt);
+
+/** \brief Stop and join every thread.  Timers are disarmed. */
+void
+helm_rt_stop(struct helm_rt *rt);
+
+/**
+ * \brief Copy the counters of \c group into \c s.  Safe from any thread
+ * while running, in which case counters are individually but not
+ * collectively consistent.
+ *
+ * \return Zero on success or \c EINVAL when no such group exists, in which
+ *         case \c s is untouched.
+ */
+int
+helm_rt_stats(const struct helm_rt *rt,
+              int group,
+              struct helm_rt_stats *s);
+
+/** \brief Release every resource, stopping first if necessary. */
+void
+helm_rt_destroy(struct helm_rt *rt);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_RT_H */
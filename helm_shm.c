@@ -0,0 +1,691 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Implementation of the shared-memory controller service within \ref
+ * helm_shm.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#include "helm_bank.h"
+#include "helm_shm.h"
+
+/** Identifies a segment created by helm_shm_create(). */
+#define MAGIC UINT64_C(0x314d48536d6c6568)
+
+/** Layout version, incremented upon any incompatible change. */
+enum { VERSION = 1 };
+
+/** Polls of an empty ring before sleeping upon a futex, given many CPUs. */
+enum { SPIN = 4096 };
+
+/**
+ * Nanoseconds any sleeper waits before rechecking liveness, which is also
+ * the period at which the server reaps slots of exited clients.
+ */
+enum { NAP = 100000000 };
+
+/**
+ * States of a client slot.  A slot is CLAIMING from winning it until its
+ * owner is recorded so that no reaper mistakes the owner for exited.
+ */
+enum { FREE = 0, USED = 1, CLOSING = 2, CLAIMING = 3 };
+
+/**
+ * Free-running indices of one single-producer, single-consumer ring.  Each
+ * counter is written by one side only and sits on its own cache line.
+ */
+struct ring
+{
+    uint32_t head __attribute__((aligned(64)));  ///< Published by producer
+    uint32_t tail __attribute__((aligned(64)));  ///< Published by consumer
+    uint32_t sleeping;  ///< Consumer sleeps upon #head when nonzero
+};
+
+/** One client's rings and ownership. */
+struct slot
+{
+    uint32_t    state;  ///< One of FREE, USED, CLOSING, or CLAIMING
+    int32_t     pid;    ///< Owning process while USED
+    struct ring req;    ///< Requests from client to server
+    struct ring rep;    ///< Replies from server to client
+};
+
+/** Start of every segment.  Offsets are in bytes from the segment start. */
+struct header
+{
+    uint64_t magic;     ///< Equal to MAGIC once initialized
+    uint32_t version;   ///< Equal to VERSION
+    uint32_t nclients;  ///< Number of slots
+    uint32_t capacity;  ///< Entries per ring, a power of two
+    int32_t  server;    ///< Serving process or zero
+    uint64_t nlanes;    ///< Number of lanes
+    uint64_t bytes;     ///< Total segment size
+    uint64_t bank;      ///< Offset of helm_bank arrays
+    uint64_t v;         ///< Offset of per-lane requests
+    uint64_t slots;     ///< Offset of slots
+    uint64_t req;       ///< Offset of every slot's request entries
+    uint64_t rep;       ///< Offset of every slot's reply entries
+    uint32_t stop;      ///< Nonzero once serving should cease
+    uint32_t bell __attribute__((aligned(64)));  ///< Server futex word
+    uint32_t sleeping;  ///< Server sleeps upon #bell when nonzero
+};
+
+struct helm_shm
+{
+    struct header           *h;      ///< Mapped segment
+    int                      owner;  ///< Created, so unlink upon close?
+    char                    *name;   ///< Segment name
+    struct helm_bank         bank;   ///< View of the lanes' controllers
+    double                  *v;      ///< View of the lanes' requests
+    struct slot             *slots;  ///< View of every slot
+    struct helm_shm_request *req;    ///< View of every request entry
+    struct helm_shm_reply   *rep;    ///< View of every reply entry
+    unsigned                 spin;   ///< Polls before sleeping
+};
+
+struct helm_shm_client
+{
+    struct helm_shm         *s;     ///< Segment
+    struct slot             *slot;  ///< Claimed slot
+    struct helm_shm_request *req;   ///< Slot's request entries
+    struct helm_shm_reply   *rep;   ///< Slot's reply entries
+};
+
+/** Sleep while \c *word equals \c val, for at most #NAP nanoseconds. */
+static
+void
+futex_wait(uint32_t * const word, const uint32_t val)
+{
+    const struct timespec nap = { 0, NAP };
+    syscall(SYS_futex, word, FUTEX_WAIT, val, &nap, NULL, 0);
+}
+
+/** Wake every sleeper upon \c word. */
+static
+void
+futex_wake(uint32_t * const word)
+{
+    syscall(SYS_futex, word, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+}
+
+/** Hint to the processor that the caller is spinning. */
+static inline
+void
+relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+/** Is process \c pid known to have exited? */
+static
+int
+gone(const int32_t pid)
+{
+    return pid <= 0 || (kill(pid, 0) && errno == ESRCH);
+}
+
+/** Nanoseconds elapsed upon a monotonic clock. */
+static
+uint64_t
+monotonic(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+/** Round \c n up to a multiple of 64. */
+static
+uint64_t
+pad(const uint64_t n)
+{
+    return (n + 63) & ~(uint64_t) 63;
+}
+
+/** Populate the process-local views within \c s from its header. */
+static
+void
+views(struct helm_shm * const s)
+{
+    char * const base = (char *) s->h;
+    helm_bank_init(&s->bank, s->h->nlanes, base + s->h->bank);
+    s->v     = (double *) (base + s->h->v);
+    s->slots = (struct slot *) (base + s->h->slots);
+    s->req   = (struct helm_shm_request *) (base + s->h->req);
+    s->rep   = (struct helm_shm_reply *) (base + s->h->rep);
+}
+
+/** Allocate a struct helm_shm retaining a copy of \c name. */
+static
+struct helm_shm *
+alloc(const char * const name)
+{
+    struct helm_shm * const s = calloc(1, sizeof(*s));
+    if (s && !(s->name = strdup(name))) {
+        free(s);
+        return NULL;
+    }
+    if (s) {
+        // Spinning upon a lone CPU only delays the peer being awaited
+        s->spin = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SPIN : 0;
+    }
+    return s;
+}
+
+struct helm_shm *
+helm_shm_create(const char *name,
+                size_t nlanes,
+                unsigned nclients,
+                unsigned capacity,
+                const struct helm_state *h)
+{
+    if (!nlanes || !nclients || !capacity || capacity > (1u << 30)) {
+        errno = EINVAL;
+        return NULL;
+    }
+    uint32_t cap = 1;
+    while (cap < capacity) {
+        cap <<= 1;
+    }
+
+    // Lay out the segment
+    struct header l;
+    memset(&l, 0, sizeof(l));
+    l.nclients = nclients;
+    l.capacity = cap;
+    l.nlanes   = nlanes;
+    l.bank     = pad(sizeof(struct header));
+    l.v        = l.bank  + pad(helm_bank_bytes(nlanes));
+    l.slots    = l.v     + pad(nlanes * sizeof(double));
+    l.req      = l.slots + pad((uint64_t) nclients * sizeof(struct slot));
+    l.rep      = l.req   + pad((uint64_t) nclients * cap
+                               * sizeof(struct helm_shm_request));
+    l.bytes    = l.rep   + pad((uint64_t) nclients * cap
+                               * sizeof(struct helm_shm_reply));
+
+    // Replace any stale segment and map a fresh one
+    struct helm_shm * const s = alloc(name);
+    if (!s) {
+        return NULL;
+    }
+    shm_unlink(name);
+    const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+        goto fail;
+    }
+    if (ftruncate(fd, (off_t) l.bytes)) {
+        const int err = errno;
+        close(fd);
+        shm_unlink(name);
+        errno = err;
+        goto fail;
+    }
+    s->h = mmap(NULL, l.bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (s->h == MAP_FAILED) {
+        const int err = errno;
+        shm_unlink(name);
+        errno = err;
+        goto fail;
+    }
+    s->owner = 1;
+
+    // Initialize everything but the magic, which is published last
+    memcpy(s->h, &l, sizeof(l));  // Pages are zeroed so slots are FREE
+    s->h->version = VERSION;
+    views(s);
+    for (size_t i = 0; i < nlanes; ++i) {
+        helm_bank_set(&s->bank, i, h);
+        s->v[i] = 0;
+    }
+    helm_bank_approach(&s->bank);
+    __atomic_store_n(&s->h->magic, MAGIC, __ATOMIC_RELEASE);
+    return s;
+
+fail:
+    free(s->name);
+    free(s);
+    return NULL;
+}
+
+struct helm_shm *
+helm_shm_open(const char *name)
+{
+    struct helm_shm * const s = alloc(name);
+    if (!s) {
+        return NULL;
+    }
+    const int fd = shm_open(name, O_RDWR, 0);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) || (size_t) st.st_size < sizeof(*s->h)) {
+        const int err = fd < 0 ? errno : EPROTO;
+        if (fd >= 0) {
+            close(fd);
+        }
+        free(s->name);
+        free(s);
+        errno = err;
+        return NULL;
+    }
+    s->h = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED, fd, 0);
+    close(fd);
+    if (s->h == MAP_FAILED) {
+        free(s->name);
+        free(s);
+        return NULL;
+    }
+    if (   __atomic_load_n(&s->h->magic, __ATOMIC_ACQUIRE) != MAGIC
+        || s->h->version != VERSION
+        || s->h->bytes   != (uint64_t) st.st_size) {
+        munmap(s->h, (size_t) st.st_size);
+        free(s->name);
+        free(s);
+        errno = EPROTO;
+        return NULL;
+    }
+    views(s);
+    return s;
+}
+
+void
+helm_shm_close(struct helm_shm *s)
+{
+    if (s) {
+        if (s->owner) {
+            shm_unlink(s->name);
+        }
+        munmap(s->h, s->h->bytes);
+        free(s->name);
+        free(s);
+    }
+}
+
+size_t
+helm_shm_lanes(const struct helm_shm *s)
+{
+    return s->h->nlanes;
+}
+
+int
+helm_shm_get(const struct helm_shm *s,
+             size_t lane,
+             struct helm_state *h,
+             double *v)
+{
+    if (lane >= s->h->nlanes) {
+        return EINVAL;
+    }
+    if (h) {
+        helm_bank_get(&s->bank, lane, h);
+    }
+    if (v) {
+        *v = s->v[lane];
+    }
+    return 0;
+}
+
+/** Return slot \c k to FREE, discarding anything within its rings. */
+static
+void
+reclaim(struct slot * const k)
+{
+    k->req.head = k->req.tail = k->req.sleeping = 0;
+    k->rep.head = k->rep.tail = k->rep.sleeping = 0;
+    k->pid = 0;
+    __atomic_store_n(&k->state, FREE, __ATOMIC_RELEASE);
+}
+
+/** Reclaim every USED slot of clients that exited without detaching. */
+static
+void
+reap(struct helm_shm * const s)
+{
+    for (size_t n = 0; n < s->h->nclients; ++n) {
+        struct slot * const k = &s->slots[n];
+        if (   __atomic_load_n(&k->state, __ATOMIC_ACQUIRE) == USED
+            && gone(__atomic_load_n(&k->pid, __ATOMIC_RELAXED))) {
+            reclaim(k);
+        }
+    }
+}
+
+/** Apply request \c q to the served bank producing reply \c p. */
+static
+void
+apply(struct helm_shm * const s,
+      const struct helm_shm_request * const q,
+      struct helm_shm_reply * const p)
+{
+    const size_t i = q->lane;
+    p->lane   = q->lane;
+    p->status = 0;
+    if (i >= s->h->nlanes) {
+        p->status = EINVAL;
+        p->v      = NAN;
+        return;
+    }
+    struct helm_bank * const b = &s->bank;
+    struct helm_state h;
+    switch (q->op) {
+    case HELM_SHM_STEP:
+        helm_bank_get(b, i, &h);
+        s->v[i] += helm_steady(&h, q->arg.step.dt, q->arg.step.r,
+                               q->arg.step.u, s->v[i], q->arg.step.y);
+        b->y[i]  = h.y;
+        b->f[i]  = h.f;
+        break;
+    case HELM_SHM_TUNE:
+        b->kp[i] = q->arg.tune.kp;
+        b->Td[i] = q->arg.tune.Td;
+        b->Tf[i] = q->arg.tune.Tf;
+        b->Ti[i] = q->arg.tune.Ti;
+        b->Tt[i] = q->arg.tune.Tt;
+        break;
+    case HELM_SHM_APPROACH:
+        b->y[i]  = NAN;
+        b->f[i]  = NAN;
+        s->v[i]  = q->arg.step.u;
+        break;
+    default:
+        p->status = EINVAL;
+        break;
+    }
+    p->v = s->v[i];
+}
+
+/**
+ * Serve every pending request of slot \c n that fits within its reply ring.
+ * Returns the number of requests served.
+ */
+static
+uint32_t
+drain(struct helm_shm * const s, const size_t n)
+{
+    struct slot * const k = &s->slots[n];
+    const uint32_t mask = s->h->capacity - 1;
+    struct helm_shm_request * const req = s->req + n * s->h->capacity;
+    struct helm_shm_reply   * const rep = s->rep + n * s->h->capacity;
+
+    const uint32_t qt = k->req.tail;
+    const uint32_t qh = __atomic_load_n(&k->req.head, __ATOMIC_ACQUIRE);
+    const uint32_t ph = k->rep.head;
+    const uint32_t pt = __atomic_load_n(&k->rep.tail, __ATOMIC_ACQUIRE);
+    uint32_t m = qh - qt;
+    if (m > s->h->capacity - (ph - pt)) {
+        m = s->h->capacity - (ph - pt);  // Await space for replies
+    }
+    for (uint32_t j = 0; j < m; ++j) {
+        apply(s, &req[(qt + j) & mask], &rep[(ph + j) & mask]);
+    }
+    if (m) {
+        __atomic_store_n(&k->req.tail, qt + m, __ATOMIC_RELEASE);
+        __atomic_store_n(&k->rep.head, ph + m, __ATOMIC_RELEASE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&k->rep.sleeping, __ATOMIC_RELAXED)) {
+            futex_wake(&k->rep.head);
+        }
+    }
+    return m;
+}
+
+/** Is any request pending within any USED slot? */
+static
+int
+pending(const struct helm_shm * const s)
+{
+    for (size_t n = 0; n < s->h->nclients; ++n) {
+        const struct slot * const k = &s->slots[n];
+        if (   __atomic_load_n(&k->state, __ATOMIC_ACQUIRE) == USED
+            && __atomic_load_n(&k->req.head, __ATOMIC_ACQUIRE)
+               != k->req.tail) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int
+helm_shm_serve(struct helm_shm *s)
+{
+    struct header * const H = s->h;
+    __atomic_store_n(&H->server, (int32_t) getpid(), __ATOMIC_RELEASE);
+    uint64_t reaped = monotonic();
+    for (unsigned idle = 0;;) {
+        if (__atomic_load_n(&H->stop, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        // Periodically reap exited clients, whether busy or idle
+        const uint64_t now = monotonic();
+        if (now - reaped >= NAP) {
+            reap(s);
+            reaped = now;
+        }
+
+        // Serve every client, reclaiming any that detached
+        uint32_t work = 0;
+        for (size_t n = 0; n < H->nclients; ++n) {
+            struct slot * const k = &s->slots[n];
+            switch (__atomic_load_n(&k->state, __ATOMIC_ACQUIRE)) {
+            case USED:
+                work += drain(s, n);
+                break;
+            case CLOSING:
+                reclaim(k);
+                break;
+            }
+        }
+        if (work) {
+            idle = 0;
+            continue;
+        }
+        if (++idle < s->spin) {
+            relax();
+            continue;
+        }
+
+        // Advertise sleeping, recheck, and only then sleep
+        const uint32_t bell = __atomic_load_n(&H->bell, __ATOMIC_ACQUIRE);
+        __atomic_store_n(&H->sleeping, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (!pending(s) && !__atomic_load_n(&H->stop, __ATOMIC_ACQUIRE)) {
+            futex_wait(&H->bell, bell);
+        }
+        __atomic_store_n(&H->sleeping, 0, __ATOMIC_RELAXED);
+        idle = 0;
+    }
+    __atomic_store_n(&H->server, 0, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void
+helm_shm_stop(struct helm_shm *s)
+{
+    __atomic_store_n(&s->h->stop, 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&s->h->bell, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&s->h->bell);
+}
+
+struct helm_shm_client *
+helm_shm_attach(struct helm_shm *s)
+{
+    struct helm_shm_client * const c = malloc(sizeof(*c));
+    if (!c) {
+        return NULL;
+    }
+    for (size_t n = 0; n < s->h->nclients; ++n) {
+        struct slot * const k = &s->slots[n];
+        uint32_t expected = FREE;
+        if (__atomic_compare_exchange_n(&k->state, &expected, CLAIMING, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            // Record the owner before any reaper may observe USED
+            __atomic_store_n(&k->pid, (int32_t) getpid(), __ATOMIC_RELAXED);
+            __atomic_store_n(&k->state, USED, __ATOMIC_RELEASE);
+            c->s    = s;
+            c->slot = k;
+            c->req  = s->req + n * s->h->capacity;
+            c->rep  = s->rep + n * s->h->capacity;
+            return c;
+        }
+    }
+    free(c);
+    errno = EBUSY;
+    return NULL;
+}
+
+void
+helm_shm_detach(struct helm_shm_client *c)
+{
+    if (c) {
+        struct header * const H = c->s->h;
+        if (__atomic_load_n(&H->server, __ATOMIC_ACQUIRE)) {
+            __atomic_store_n(&c->slot->state, CLOSING, __ATOMIC_RELEASE);
+            __atomic_add_fetch(&H->bell, 1, __ATOMIC_SEQ_CST);
+            futex_wake(&H->bell);
+        } else {
+            reclaim(c->slot);  // No server to race against
+        }
+        free(c);
+    }
+}
+
+int
+helm_shm_send(struct helm_shm_client *c,
+              const struct helm_shm_request *q)
+{
+    struct header * const H = c->s->h;
+    struct ring   * const r = &c->slot->req;
+    const uint32_t head = r->head;
+    if (head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE) >= H->capacity) {
+        return EAGAIN;
+    }
+    c->req[head & (H->capacity - 1)] = *q;
+    __atomic_store_n(&r->head, head + 1, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&H->sleeping, __ATOMIC_RELAXED)) {
+        __atomic_add_fetch(&H->bell, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&H->bell);
+    }
+    return 0;
+}
+
+int
+helm_shm_recv(struct helm_shm_client *c,
+              struct helm_shm_reply *p,
+              int wait)
+{
+    struct header * const H = c->s->h;
+    struct ring   * const r = &c->slot->rep;
+    const uint32_t tail = r->tail;
+    for (unsigned spin = 0;; ++spin) {
+        if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) != tail) {
+            *p = c->rep[tail & (H->capacity - 1)];
+            __atomic_store_n(&r->tail, tail + 1, __ATOMIC_RELEASE);
+            return 0;
+        }
+        if (!wait) {
+            return EAGAIN;
+        }
+        if (spin < c->s->spin) {
+            relax();
+            continue;
+        }
+
+        // Advertise sleeping, recheck, and only then sleep
+        __atomic_store_n(&r->sleeping, 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail) {
+            futex_wait(&r->head, tail);
+        }
+        __atomic_store_n(&r->sleeping, 0, __ATOMIC_RELAXED);
+        if (   __atomic_load_n(&r->head, __ATOMIC_ACQUIRE) == tail
+            && gone(__atomic_load_n(&H->server, __ATOMIC_ACQUIRE))) {
+            return EPIPE;
+        }
+        spin = 0;
+    }
+}
+
+/** Send \c q and await its reply, assuming nothing else is outstanding. */
+static
+int
+roundtrip(struct helm_shm_client * const c,
+          const struct helm_shm_request * const q,
+          struct helm_shm_reply * const p)
+{
+    int err;
+    while (EAGAIN == (err = helm_shm_send(c, q))) {
+        relax();
+    }
+    if (!err) {
+        err = helm_shm_recv(c, p, 1);
+    }
+    return err ? err : p->status;
+}
+
+int
+helm_shm_step(struct helm_shm_client *c,
+              size_t lane,
+              double dt,
+              double r,
+              double u,
+              double y,
+              double *v)
+{
+    struct helm_shm_request q;
+    struct helm_shm_reply   p;
+    q.op          = HELM_SHM_STEP;
+    q.lane        = (uint32_t) lane;
+    q.arg.step.dt = dt;
+    q.arg.step.r  = r;
+    q.arg.step.u  = u;
+    q.arg.step.y  = y;
+    const int err = roundtrip(c, &q, &p);
+    if (!err) {
+        *v = p.v;
+    }
+    return err;
+}
+
+int
+helm_shm_tune(struct helm_shm_client *c,
+              size_t lane,
+              const struct helm_state *h)
+{
+    struct helm_shm_request q;
+    struct helm_shm_reply   p;
+    q.op          = HELM_SHM_TUNE;
+    q.lane        = (uint32_t) lane;
+    q.arg.tune.kp = h->kp;
+    q.arg.tune.Td = h->Td;
+    q.arg.tune.Tf = h->Tf;
+    q.arg.tune.Ti = h->Ti;
+    q.arg.tune.Tt = h->Tt;
+    return roundtrip(c, &q, &p);
+}
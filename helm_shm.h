@@ -0,0 +1,242 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_SHM_H
+#define HELM_SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "helm.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * A bank of controllers living in a POSIX shared-memory segment, served by
+ * one daemon to many local client processes on Linux.
+ *
+ * The segment holds a helm_bank, the current request \c v of every lane,
+ * and a fixed number of client slots.  Each slot carries a pair of
+ * single-producer, single-consumer rings: requests from client to server
+ * and replies from server to client.  A client claims a free slot, posts
+ * (dt, r, u, y) for some lane, and receives the lane's updated \c v, which
+ * the server advances by helm_steady() and retains.  Tuning may be changed
+ * through the same rings so that loops may be observed and retuned
+ * centrally, e.g. by helmd or any process calling helm_shm_get().
+ *
+ * Rings are indexed by free-running 32-bit counters published with
+ * release-acquire atomics, so the fast path is a handful of loads and
+ * stores without system calls.  Only a side about to sleep pays for a
+ * futex.  The server sleeps on one doorbell shared by every slot after
+ * spinning briefly across all request rings.  A client sleeps on its reply
+ * ring's head after spinning briefly.  Each sleeper first advertises itself
+ * and rechecks its ring, and each producer checks for an advertised sleeper
+ * after publishing, so no wakeup is lost while an awake peer sees no system
+ * call at all.
+ *
+ * Slots of clients that exit without helm_shm_detach() are reclaimed by the
+ * server, and clients waiting upon a server that has exited fail with \c
+ * EPIPE rather than hanging.  Any one lane should be stepped by only one
+ * client at a time.
+ *
+ * Client sample:
+ * \code
+ *   struct helm_shm        * const s = helm_shm_open("/helm");
+ *   struct helm_shm_client * const c = helm_shm_attach(s);
+ *   for (;;) {
+ *       double v;
+ *       helm_shm_step(c, lane, dt, r, u, y, &v);
+ *       // ...actuate v...
+ *   }
+ *   helm_shm_detach(c);
+ *   helm_shm_close(s);
+ * \endcode
+ */
+
+/** Operations carried by a helm_shm_request. */
+enum helm_shm_op
+{
+    HELM_SHM_STEP     = 0,  /**< Advance the lane by helm_steady().          */
+    HELM_SHM_TUNE     = 1,  /**< Replace the lane's tuning parameters.       */
+    HELM_SHM_APPROACH = 2   /**< Apply helm_approach() and set \c v to \c u. */
+};
+
+/** One request from client to server. */
+struct helm_shm_request
+{
+    uint32_t op;    /**< One of #helm_shm_op.                             */
+    uint32_t lane;  /**< Lane within the served bank.                     */
+    union {
+        struct {
+            double dt;  /**< Time since the lane's previous step.          */
+            double r;   /**< Reference value.                               */
+            double u;   /**< Actuator signal observed.                      */
+            double y;   /**< Process output observed.                       */
+        } step;         /**< Arguments for #HELM_SHM_STEP and, through \c
+                             u alone, #HELM_SHM_APPROACH.                   */
+        struct {
+            double kp;  /**< See helm_state::kp. */
+            double Td;  /**< See helm_state::Td. */
+            double Tf;  /**< See helm_state::Tf. */
+            double Ti;  /**< See helm_state::Ti. */
+            double Tt;  /**< See helm_state::Tt. */
+        } tune;         /**< Arguments for #HELM_SHM_TUNE.                  */
+    } arg;          /**< Operation-specific arguments.                    */
+};
+
+/** One reply from server to client, in request order. */
+struct helm_shm_reply
+{
+    uint32_t lane;    /**< Lane from the request.                          */
+    int32_t  status;  /**< Zero on success or an \c errno value.           */
+    double   v;       /**< Lane's actuator request after the operation.    */
+};
+
+/** Opaque mapping of a served segment. */
+struct helm_shm;
+
+/** Opaque client slot within a served segment. */
+struct helm_shm_client;
+
+/**
+ * \brief Create and map segment \c name serving \c nlanes controllers.
+ *
+ * Any stale segment of the same name is replaced.  Every lane receives the
+ * tuning parameters of \c h, has its state reset by helm_approach(), and
+ * has \c v zero.
+ *
+ * \param[in] name     Segment name per \c shm_open(), e.g. "/helm".
+ * \param[in] nlanes   Number of controllers.
+ * \param[in] nclients Number of client slots.
+ * \param[in] capacity Entries per ring, rounded up to a power of two.
+ * \param[in] h        Initial tuning for every lane.
+ *
+ * \return New mapping or NULL with \c errno set.
+ */
+struct helm_shm *
+helm_shm_create(const char *name,
+                size_t nlanes,
+                unsigned nclients,
+                unsigned capacity,
+                const struct helm_state *h);
+
+/**
+ * \brief Serve requests on the calling thread until helm_shm_stop().
+ * \return Zero on success or an \c errno value.
+ */
+int
+helm_shm_serve(struct helm_shm *s);
+
+/**
+ * \brief Ask helm_shm_serve() to return.  Async-signal-safe.
+ */
+void
+helm_shm_stop(struct helm_shm *s);
+
+/**
+ * \brief Map an existing segment \c name created by helm_shm_create().
+ * \return New mapping or NULL with \c errno set.
+ */
+struct helm_shm *
+helm_shm_open(const char *name);
+
+/**
+ * \brief Unmap \c s, additionally unlinking the segment if \c s came from
+ * helm_shm_create().  Any attached clients must be detached beforehand.
+ */
+void
+helm_shm_close(struct helm_shm *s);
+
+/** \brief Number of lanes served within \c s. */
+size_t
+helm_shm_lanes(const struct helm_shm *s);
+
+/**
+ * \brief Observe the tuning, state, and request \c v of \c lane.
+ *
+ * Fields are individually, not collectively, consistent while serving.
+ *
+ * \return Zero on success or \c EINVAL for an invalid lane.
+ */
+int
+helm_shm_get(const struct helm_shm *s,
+             size_t lane,
+             struct helm_state *h,
+             double *v);
+
+/**
+ * \brief Claim a free client slot within \c s.
+ * \return New client or NULL with \c errno set, e.g. \c EBUSY if none free.
+ */
+struct helm_shm_client *
+helm_shm_attach(struct helm_shm *s);
+
+/** \brief Release the slot of \c c, discarding unreceived replies. */
+void
+helm_shm_detach(struct helm_shm_client *c);
+
+/**
+ * \brief Enqueue \c q without blocking.
+ * \return Zero on success or \c EAGAIN when the request ring is full.
+ */
+int
+helm_shm_send(struct helm_shm_client *c,
+              const struct helm_shm_request *q);
+
+/**
+ * \brief Dequeue the oldest reply into \c p.
+ *
+ * \param[in]  c    Client.
+ * \param[out] p    Reply received.
+ * \param[in]  wait Spin and then sleep until a reply arrives if nonzero.
+ *
+ * \return Zero on success, \c EAGAIN when not waiting and no reply is
+ *         ready, or \c EPIPE once the server has exited.
+ */
+int
+helm_shm_recv(struct helm_shm_client *c,
+              struct helm_shm_reply *p,
+              int wait);
+
+/**
+ * \brief Round trip one #HELM_SHM_STEP request for \c lane.
+ *
+ * Must not be interleaved with outstanding helm_shm_send() requests.
+ *
+ * \return Zero on success with the lane's new request in \c v or an \c
+ *         errno value.
+ */
+int
+helm_shm_step(struct helm_shm_client *c,
+              size_t lane,
+              double dt,
+              double r,
+              double u,
+              double y,
+              double *v);
+
+/**
+ * \brief Round trip one #HELM_SHM_TUNE request adopting the tuning
+ * parameters of \c h for \c lane.  Transient state is preserved.
+ * \return Zero on success or an \c errno value.
+ */
+int
+helm_shm_tune(struct helm_shm_client *c,
+              size_t lane,
+              const struct helm_state *h);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_SHM_H */
@@ -0,0 +1,54 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * C99 extern declarations for static inline functions within \ref helm_sparse.h
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#include "helm_sparse.h"
+
+extern
+size_t
+helm_sparse_bytes(const size_t n);
+
+extern
+struct helm_sparse *
+helm_sparse_init(struct helm_sparse * const s,
+                 struct helm_bank * const b,
+                 const double band,
+                 void * const mem);
+
+extern
+double
+helm_sparse_lane(struct helm_bank * const b,
+                 const size_t i,
+                 const double dt,
+                 const double r,
+                 const double u,
+                 const double v,
+                 const double y);
+
+extern
+int
+helm_sparse_sense(struct helm_sparse * const s,
+                  const size_t i,
+                  const double r,
+                  const double u,
+                  const double v,
+                  const double y);
+
+extern
+size_t
+helm_sparse_steady(struct helm_sparse * const s,
+                   const double dt,
+                   size_t * const lanes,
+                   double * const dv);
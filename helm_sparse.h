@@ -0,0 +1,267 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_SPARSE_H
+#define HELM_SPARSE_H
+
+#include <math.h>
+#include <stddef.h>
+
+#include "helm.h"
+#include "helm_bank.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Event-driven stepping of a helm_bank in which quiescent loops sleep.
+ *
+ * A loop sitting at setpoint with a flat observable, a settled filter, and
+ * an actuator matching its request receives a zero increment from
+ * helm_steady() period after period.  Here such loops are put to sleep and
+ * only the remaining active loops are stepped, so each period costs time
+ * proportional to the number of active loops rather than the bank size.
+ *
+ * Each loop stores its most recent inputs along with the time at which it
+ * was last stepped.  Callers report new samples via helm_sparse_sense(),
+ * which may be skipped entirely for loops whose inputs have not changed.  A
+ * sleeping loop wakes when any input departs from its stored value by more
+ * than the deadband.  Upon waking, one catch-up step applies the stored
+ * inputs across the whole slept interval as an accumulated \c dt.  The
+ * ordinary step with the new inputs then follows at the next
+ * helm_sparse_steady().  After each step, a loop falls asleep when its
+ * error \c r-y, reset error \c u-v, filter lag \c y-f, and increment are
+ * all within the deadband.
+ *
+ * With a zero deadband loops sleep only when helm_steady() would return
+ * exactly zero without changing state, so results are bit-identical to
+ * dense stepping.  With a positive deadband, integral and reset action
+ * accrued while asleep are reproduced by the catch-up step because they are
+ * linear in \c dt for fixed inputs, while derivative action and filter
+ * evolution within the deadband are approximated.
+ *
+ * Sample usage with caller-provided storage:
+ * \code
+ *   struct helm_sparse s;
+ *   helm_sparse_init(&s, &b, band, malloc(helm_sparse_bytes(b.n)));
+ *   for (;;) {
+ *       for (...each loop i with a new sample...) {
+ *           helm_sparse_sense(&s, i, r[i], u[i], v[i], y[i]);
+ *       }
+ *       const size_t m = helm_sparse_steady(&s, dt, lanes, dv);
+ *       for (size_t k = 0; k < m; ++k) {
+ *           v[lanes[k]] += dv[k];
+ *       }
+ *   }
+ * \endcode
+ */
+
+/**
+ * Sparse stepping state layered atop a helm_bank.  Arrays are indexed by
+ * lane except #active, which lists the lanes currently awake.
+ */
+struct helm_sparse
+{
+    struct helm_bank *b;       /**< Controllers being stepped.               */
+    double            band;    /**< Deadband for waking and sleeping.        */
+    double            t;       /**< Time elapsed across every step taken.    */
+    size_t            nactive; /**< Number of lanes within #active.          */
+    size_t           *active;  /**< Lanes currently awake, in no order.      */
+    unsigned char    *awake;   /**< Nonzero when the lane is within #active. */
+    double           *r;       /**< Stored references.                       */
+    double           *u;       /**< Stored actuator signals.                 */
+    double           *v;       /**< Stored requests, advanced by each step.  */
+    double           *y;       /**< Stored process observables.              */
+    double           *last;    /**< Value of #t when the lane last stepped.  */
+    double           *owed;    /**< Catch-up increments not yet reported.    */
+};
+
+/** \brief Bytes of storage required by helm_sparse_init() for \c n lanes. */
+static inline
+size_t
+helm_sparse_bytes(const size_t n)
+{
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    const size_t pad = ((n + per - 1) / per) * per;
+    return 6 * pad * sizeof(double)
+         + pad * sizeof(size_t)
+         + pad * sizeof(unsigned char);
+}
+
+/**
+ * \brief Layer sparse stepping atop bank \c b with every lane awake.
+ *
+ * Stored inputs are zero until first sensed.  The bank's tuning and state
+ * must already be established, e.g. by helm_bank_approach().
+ *
+ * \param[out] s    Sparse state to be initialized.
+ * \param[in]  b    Bank to be stepped.
+ * \param[in]  band Nonnegative deadband.
+ * \param[in]  mem  At least helm_sparse_bytes(b->n) bytes of storage.
+ * \return Argument \c s to permit call chaining.
+ */
+static inline
+struct helm_sparse *
+helm_sparse_init(struct helm_sparse * const s,
+                 struct helm_bank * const b,
+                 const double band,
+                 void * const mem)
+{
+    assert(band >= 0);
+    const size_t per = HELM_BANK_ALIGN / sizeof(double);
+    const size_t pad = ((b->n + per - 1) / per) * per;
+    double * const p = (double *) mem;
+    s->b       = b;
+    s->band    = band;
+    s->t       = 0;
+    s->nactive = b->n;
+    s->r       = p + 0*pad;
+    s->u       = p + 1*pad;
+    s->v       = p + 2*pad;
+    s->y       = p + 3*pad;
+    s->last    = p + 4*pad;
+    s->owed    = p + 5*pad;
+    s->active  = (size_t *) (p + 6*pad);
+    s->awake   = (unsigned char *) (s->active + pad);
+    for (size_t i = 0; i < b->n; ++i) {
+        s->r[i]      = 0;
+        s->u[i]      = 0;
+        s->v[i]      = 0;
+        s->y[i]      = 0;
+        s->last[i]   = 0;
+        s->owed[i]   = 0;
+        s->active[i] = i;
+        s->awake[i]  = 1;
+    }
+    return s;
+}
+
+/**
+ * \brief Advance lane \c i by helm_steady() with the given inputs.
+ * \return Increment from helm_steady(), which is bit-identical to that
+ *         from helm_bank_steady() for the same lane.
+ */
+static inline
+double
+helm_sparse_lane(struct helm_bank * const b,
+                 const size_t i,
+                 const double dt,
+                 const double r,
+                 const double u,
+                 const double v,
+                 const double y)
+{
+    struct helm_state h;
+    helm_bank_get(b, i, &h);
+    const double dv = helm_steady(&h, dt, r, u, v, y);
+    b->y[i] = h.y;
+    b->f[i] = h.f;
+    return dv;
+}
+
+/**
+ * \brief Record new inputs for lane \c i, waking it if asleep and any input
+ * moved by more than the deadband.
+ *
+ * Inputs within the deadband of a sleeping lane are discarded so that slow
+ * drift accumulates against the stored values until it wakes the lane.
+ *
+ * \return Nonzero if and only if the lane is awake upon return.
+ */
+static inline
+int
+helm_sparse_sense(struct helm_sparse * const s,
+                  const size_t i,
+                  const double r,
+                  const double u,
+                  const double v,
+                  const double y)
+{
+    if (!s->awake[i]) {
+        const double band = s->band;
+        if (   fabs(r - s->r[i]) <= band && fabs(u - s->u[i]) <= band
+            && fabs(v - s->v[i]) <= band && fabs(y - s->y[i]) <= band) {
+            return 0;
+        }
+
+        // Catch up across the slept interval using the stored inputs
+        const double idle = s->t - s->last[i];
+        if (idle > 0) {
+            s->owed[i] += helm_sparse_lane(s->b, i, idle, s->r[i], s->u[i],
+                                           s->v[i], s->y[i]);
+        }
+        s->awake[i] = 1;
+        s->active[s->nactive++] = i;
+    }
+    s->r[i] = r;
+    s->u[i] = u;
+    s->v[i] = v;
+    s->y[i] = y;
+    return 1;
+}
+
+/**
+ * \brief Step every awake lane by \c dt and put quiescent lanes to sleep.
+ *
+ * Increments are reported compactly as \c dv[k] for lane \c lanes[k] and
+ * include any catch-up increment owed since waking.  Each stored request is
+ * advanced by its increment, mirroring the customary <tt>v += dv</tt>, so
+ * that lanes whose request is unchanged otherwise need not be re-sensed.
+ *
+ * \param[in,out] s     Sparse state.
+ * \param[in]     dt    Time since the previous helm_sparse_steady().
+ * \param[out]    lanes At least \c s->b->n entries receiving stepped lanes.
+ * \param[out]    dv    At least \c s->b->n entries receiving increments.
+ *
+ * \return Number of lanes stepped.
+ */
+static inline
+size_t
+helm_sparse_steady(struct helm_sparse * const s,
+                   const double dt,
+                   size_t * const lanes,
+                   double * const dv)
+{
+    const double band = s->band;
+    const struct helm_bank * const b = s->b;
+    s->t += dt;
+
+    size_t m = 0;
+    for (size_t k = 0; k < s->nactive;) {
+        const size_t i = s->active[k];
+        const double d = helm_sparse_lane(s->b, i, dt, s->r[i], s->u[i],
+                                          s->v[i], s->y[i])
+                       + s->owed[i];
+        s->owed[i] = 0;
+        s->last[i] = s->t;
+        s->v[i]   += d;
+        lanes[m]   = i;
+        dv[m++]    = d;
+
+        if (   fabs(s->r[i] - s->y[i]) <= band   // Pending integral action
+            && fabs(s->u[i] - s->v[i]) <= band   // Pending reset action
+            && fabs(s->y[i] - b->f[i]) <= band   // Filter still settling
+            && fabs(d)                 <= band) {  // Quiescent, so sleep
+            s->awake[i]  = 0;
+            s->active[k] = s->active[--s->nactive];
+        } else {
+            ++k;
+        }
+    }
+    return m;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_SPARSE_H */
@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Background writer for \ref helm_trace.h along with C99 extern declarations
+ * for its static inline functions.
+ *
+ * \see \ref helm.c for the rationale behind these declarations.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h>
+
+#include "helm_trace.h"
+
+extern
+size_t
+helm_trace_bytes(const size_t capacity);
+
+extern
+struct helm_trace *
+helm_trace_init(struct helm_trace * const t,
+                const size_t capacity,
+                void * const mem);
+
+extern
+int
+helm_trace_push(struct helm_trace * const t,
+                const struct helm_trace_record * const rec);
+
+extern
+size_t
+helm_trace_pop(struct helm_trace * const t,
+               struct helm_trace_record * const out,
+               const size_t max);
+
+extern
+size_t
+helm_trace_dropped(const struct helm_trace * const t);
+
+extern
+double
+helm_steady_trace(struct helm_state * const h,
+                  struct helm_trace * const t,
+                  const double dt,
+                  const double r,
+                  const double u,
+                  const double v,
+                  const double y);
+
+/** Records popped from the ring at once by the writer. */
+enum { BATCH = 256 };
+
+/** Format every record currently within the ring, returning how many. */
+static
+size_t
+drain(struct helm_trace_writer * const w)
+{
+    struct helm_trace_record batch[BATCH];
+    size_t total = 0, n;
+    while ((n = helm_trace_pop(w->trace, batch, BATCH))) {
+        for (size_t i = 0; i < n; ++i) {
+            const struct helm_trace_record * const q = batch + i;
+            fprintf(w->out, "%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\t"
+                            "%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\n",
+                    q->I, q->R, q->D, q->P, q->alpha, q->df, q->dy, q->dv);
+        }
+        total += n;
+    }
+    return total;
+}
+
+/** Thread body for helm_trace_writer_start(). */
+static
+void *
+run(void *arg)
+{
+    struct helm_trace_writer * const w = (struct helm_trace_writer *) arg;
+    const struct timespec idle = { w->period / 1000000u,
+                                   (w->period % 1000000u) * 1000l };
+    while (!__atomic_load_n(&w->stop, __ATOMIC_ACQUIRE)) {
+        const size_t n = drain(w);
+        w->written += n;
+        if (!n) {
+            nanosleep(&idle, NULL);
+        }
+    }
+    w->written += drain(w);   // Records pushed before the stop request
+    return NULL;
+}
+
+int
+helm_trace_writer_start(struct helm_trace_writer *w,
+                        struct helm_trace *t,
+                        FILE *out,
+                        unsigned period)
+{
+    w->trace   = t;
+    w->out     = out;
+    w->period  = period;
+    w->stop    = 0;
+    w->written = 0;
+    fprintf(out, "# I\tR\tD\tP\talpha\tdf\tdy\tdv\n");
+    return pthread_create(&w->thread, NULL, run, w);
+}
+
+size_t
+helm_trace_writer_stop(struct helm_trace_writer *w)
+{
+    __atomic_store_n(&w->stop, 1, __ATOMIC_RELEASE);
+    pthread_join(w->thread, NULL);
+    fflush(w->out);
+    return w->written;
+}
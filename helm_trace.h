@@ -0,0 +1,289 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_TRACE_H
+#define HELM_TRACE_H
+
+#include <pthread.h>
+#include <stdio.h>
+
+#include "helm.h"
+
+#if !defined(__GNUC__)
+#error "helm_trace.h requires GNU-style __atomic builtins"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Per-term telemetry from helm_steady() through a lock-free ring.
+ *
+ * Function helm_steady_trace() shares helm_steady_terms() with
+ * helm_steady(), returning a bit-identical increment, but additionally
+ * pushes a helm_trace_record holding the separate integral, reset,
+ * derivative, and proportional contributions alongside \f$\alpha\f$,
+ * \f${\mathrm{d}f}\f$, and \f${\mathrm{d}y}\f$.  Records travel through a
+ * single-producer, single-consumer ring whose producer never blocks.  When
+ * the ring is full the record is dropped and counted.  A helm_trace_writer
+ * thread drains the ring to a \c FILE in the background.
+ *
+ * Macro HELM_TRACE_STEADY() invokes helm_steady_trace() only when \c
+ * HELM_TRACE is defined at compile time and otherwise expands to a plain
+ * helm_steady() call without evaluating the ring argument.  Instrumentation
+ * compiled out therefore costs nothing.
+ *
+ * Sample:
+ * \code
+ *   struct helm_trace t;
+ *   struct helm_trace_writer w;
+ *   helm_trace_init(&t, 4096, malloc(helm_trace_bytes(4096)));
+ *   helm_trace_writer_start(&w, &t, stderr, 1000);
+ *   for (int i = 0; i < N; ++i) {
+ *      y  = process(dt, u);
+ *      v += HELM_TRACE_STEADY(&h, &t, dt, r, u, v, y);
+ *      u  = actuate(dt, v);
+ *   }
+ *   helm_trace_writer_stop(&w);
+ * \endcode
+ */
+
+/**
+ * Contributions to one helm_steady() increment, occupying one cache line.
+ * The four contributions sum to #dv up to rounding.  When helm_steady()
+ * skips a NaN observable, contributions are zero while #alpha, #df, and #dy
+ * are NaN.
+ */
+struct helm_trace_record
+{
+    double I;      /**< Integral action \f$k_p\,dt\,(r - y)/T_i\f$.        */
+    double R;      /**< Automatic reset \f$k_p\,dt\,(u - v)/T_t\f$.        */
+    double D;      /**< Derivative action \f$k_p (T_d/T_f)(df - dy)\f$.    */
+    double P;      /**< Proportional action \f$-k_p\,dy\f$.                */
+    double alpha;  /**< Filter parameter \f$dt / (T_f + dt)\f$.            */
+    double df;     /**< Filtered difference for \f$y\f$.                   */
+    double dy;     /**< Backward difference for \f$y\f$.                   */
+    double dv;     /**< Increment returned by helm_steady().               */
+};
+
+/**
+ * A single-producer, single-consumer ring of helm_trace_record.  Producer
+ * and consumer indices reside on separate cache lines to avoid false
+ * sharing.  Members must only be accessed through the functions below.
+ */
+struct helm_trace
+{
+    struct helm_trace_record *buf;  /**< Storage for #mask + 1 records.     */
+    size_t mask;                    /**< Capacity less one.                 */
+    size_t head __attribute__((aligned(64)));  /**< Producer's next slot.  */
+    size_t tail_cache;              /**< Producer's stale copy of #tail.    */
+    size_t dropped;                 /**< Records discarded when full.       */
+    size_t tail __attribute__((aligned(64)));  /**< Consumer's next slot.  */
+};
+
+/**
+ * \brief Bytes of storage required by helm_trace_init() for \c capacity
+ * records, which must be a power of two.
+ */
+static inline
+size_t
+helm_trace_bytes(const size_t capacity)
+{
+    return capacity * sizeof(struct helm_trace_record);
+}
+
+/**
+ * \brief Initialize an empty ring atop caller-provided storage.
+ *
+ * \param[out] t        Ring to be initialized.
+ * \param[in]  capacity Number of records, which must be a power of two.
+ * \param[in]  mem      At least helm_trace_bytes(capacity) bytes of storage.
+ * \return Argument \c t to permit call chaining.
+ */
+static inline
+struct helm_trace *
+helm_trace_init(struct helm_trace * const t,
+                const size_t capacity,
+                void * const mem)
+{
+    assert(capacity && !(capacity & (capacity - 1)));
+    t->buf        = (struct helm_trace_record *) mem;
+    t->mask       = capacity - 1;
+    t->head       = 0;
+    t->tail_cache = 0;
+    t->dropped    = 0;
+    t->tail       = 0;
+    return t;
+}
+
+/**
+ * \brief Push one record from the producing thread.  Wait-free.
+ *
+ * The consumer's index is reloaded only when the ring appears full, so
+ * in the common case a push touches only producer-owned cache lines.
+ *
+ * \return Nonzero if and only if the record was enqueued rather than dropped.
+ */
+static inline
+int
+helm_trace_push(struct helm_trace * const t,
+                const struct helm_trace_record * const rec)
+{
+    const size_t head = t->head;
+    if (__builtin_expect(head - t->tail_cache > t->mask, 0)) {
+        t->tail_cache = __atomic_load_n(&t->tail, __ATOMIC_ACQUIRE);
+        if (head - t->tail_cache > t->mask) {
+            __atomic_store_n(&t->dropped, t->dropped + 1, __ATOMIC_RELAXED);
+            return 0;
+        }
+    }
+    t->buf[head & t->mask] = *rec;
+    __atomic_store_n(&t->head, head + 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * \brief Pop up to \c max records from the consuming thread.  Wait-free.
+ *
+ * \return Number of records copied into \c out.
+ */
+static inline
+size_t
+helm_trace_pop(struct helm_trace * const t,
+               struct helm_trace_record * const out,
+               const size_t max)
+{
+    const size_t tail  = t->tail;
+    const size_t avail = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE) - tail;
+    const size_t n     = avail < max ? avail : max;
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = t->buf[(tail + i) & t->mask];
+    }
+    __atomic_store_n(&t->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+/** \brief Number of records dropped so far.  Safe from any thread. */
+static inline
+size_t
+helm_trace_dropped(const struct helm_trace * const t)
+{
+    return __atomic_load_n(&t->dropped, __ATOMIC_RELAXED);
+}
+
+/**
+ * \brief Invoke helm_steady() while pushing its per-term contributions
+ * into \c t.
+ *
+ * The returned increment and the updates to \c h are bit-identical to those
+ * of helm_steady().  Contributions are computed alongside rather than
+ * instead, so they may differ from the summed \c dv in the last bit.
+ *
+ * \param[in,out] t Ring receiving one record per invocation.
+ * \copydetails helm_steady()
+ */
+static inline
+double
+helm_steady_trace(struct helm_state * const h,
+                  struct helm_trace * const t,
+                  const double dt,
+                  const double r,
+                  const double u,
+                  const double v,
+                  const double y)
+{
+    struct helm_trace_record rec = { 0, 0, 0, 0, NAN, NAN, NAN, 0 };
+
+    if (!isnan(y)) {                      // As within helm_steady()
+
+        if (isnan(h->f)) {
+            h->y = y;
+            h->f = y;
+        }
+
+        double a, df, dy;
+        const double dv = helm_steady_terms(h, dt, r, u, v, y, &a, &df, &dy);
+
+        rec.I     = h->kp*(dt*((r - y) / h->Ti));
+        rec.R     = h->kp*(dt*((u - v) / h->Tt));
+        rec.D     = h->kp*((h->Td / h->Tf)*(df - dy));
+        rec.P     = h->kp*(-dy);
+        rec.alpha = a;
+        rec.df    = df;
+        rec.dy    = dy;
+        rec.dv    = dv;
+
+        h->y  = y;
+        h->f += df;
+    }
+
+    helm_trace_push(t, &rec);
+    return rec.dv;
+}
+
+/**
+ * \def HELM_TRACE_STEADY(h, t, dt, r, u, v, y)
+ * Expands to helm_steady_trace() when \c HELM_TRACE is defined and to
+ * helm_steady(), ignoring \c t entirely, otherwise.
+ */
+#ifdef HELM_TRACE
+#define HELM_TRACE_STEADY(h, t, dt, r, u, v, y) \
+        helm_steady_trace((h), (t), (dt), (r), (u), (v), (y))
+#else
+#define HELM_TRACE_STEADY(h, t, dt, r, u, v, y) \
+        helm_steady((h), (dt), (r), (u), (v), (y))
+#endif
+
+/**
+ * A background thread draining a helm_trace into a \c FILE as one
+ * whitespace-delimited line per record preceded by a commented header.
+ * Members are private to helm_trace_writer_start() and
+ * helm_trace_writer_stop().
+ */
+struct helm_trace_writer
+{
+    struct helm_trace *trace;   /**< Ring being drained.                    */
+    FILE              *out;     /**< Destination for formatted records.     */
+    unsigned           period;  /**< Microseconds to sleep when idle.       */
+    int                stop;    /**< Set to request a final drain and exit. */
+    size_t             written; /**< Records written so far.                */
+    pthread_t          thread;  /**< Draining thread.                       */
+};
+
+/**
+ * \brief Start a thread draining \c t into \c out.
+ *
+ * \param[out] w      Writer to be started.
+ * \param[in]  t      Ring to be drained, which \c w consumes exclusively.
+ * \param[in]  out    Destination for formatted records.
+ * \param[in]  period Microseconds to sleep whenever the ring is empty.
+ * \return Zero on success or an \c errno value on failure.
+ */
+int
+helm_trace_writer_start(struct helm_trace_writer *w,
+                        struct helm_trace *t,
+                        FILE *out,
+                        unsigned period);
+
+/**
+ * \brief Drain every record remaining, stop the thread, and flush.
+ *
+ * \return Number of records written across the writer's lifetime.
+ */
+size_t
+helm_trace_writer_stop(struct helm_trace_writer *w);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_TRACE_H */
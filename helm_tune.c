@@ -0,0 +1,571 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Implementation of the relay-feedback autotuner within \ref helm_tune.h.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "helm_freq.h"
+#include "helm_pool.h"
+#include "helm_tune.h"
+
+/** Consecutive consistent relay cycles averaged into \c Ku and \c Pu. */
+enum { CYCLES = 4 };
+
+/**
+ * Relative change between consecutive relay cycles deemed consistent.
+ * Periods may additionally differ by one step due to sampling.
+ */
+static const double consistent = 0.02;
+
+/** Steps after which a relay experiment is abandoned. */
+enum { RELAY_STEPS = 1 << 22 };
+
+/** Frequencies at which candidates are screened by sensitivity peak. */
+enum { FREQS = 512 };
+
+/** Searched coordinates, namely the logarithms of kp, Ti, Td, and Td/Tf. */
+enum { LKP, LTI, LTD, LN, DIMS };
+
+/** Customary bounds on the derivative filter ratio Td/Tf. */
+static const double nlo = 2, nhi = 20;
+
+/**
+ * Relative reduction in mean square residual required before a longer dead
+ * time is preferred, so that noise-level differences favor shorter ones.
+ */
+static const double parsimony = 0.01;
+
+/** Halvings of kp attempted while seeding. */
+enum { DETUNE = 30 };
+
+/** Process output magnitude deemed divergent. */
+static const double diverged = 1e12;
+
+/** A model being simulated from rest using caller-provided history. */
+struct sim
+{
+    const struct helm_tune_model *m;  ///< Model simulated
+    size_t  lu;                       ///< Length of #uh
+    size_t  hu;                       ///< Newest entry within #uh
+    double *uh;                       ///< Recent inputs, newest at #hu
+    size_t  hy;                       ///< Newest entry within #yh
+    double  yh[HELM_TUNE_ARX_MAX];    ///< Recent ARX outputs
+    double  x[HELM_PLANT_MAX];        ///< Plant state
+};
+
+/** Length of the input history required to simulate \c m. */
+static
+size_t
+history(const struct helm_tune_model * const m)
+{
+    return m->delay + (m->kind == HELM_TUNE_ARX && m->nb ? m->nb : 1);
+}
+
+/** Begin simulating \c m from rest using \c buf of history(m) values. */
+static
+void
+sim_init(struct sim * const s,
+         const struct helm_tune_model * const m,
+         double * const buf)
+{
+    memset(s, 0, sizeof(*s));
+    s->m  = m;
+    s->lu = history(m);
+    s->uh = buf;
+    memset(buf, 0, s->lu * sizeof(double));
+}
+
+/** Input applied \c lag steps before the newest. */
+static inline
+double
+sim_u(const struct sim * const s, const size_t lag)
+{
+    return s->uh[(s->hu + s->lu - lag) % s->lu];
+}
+
+/** Hold input \c u across one step and return the subsequent output. */
+static
+double
+sim_step(struct sim * const s, const double u)
+{
+    const struct helm_tune_model * const m = s->m;
+    s->hu = s->hu + 1 == s->lu ? 0 : s->hu + 1;
+    s->uh[s->hu] = u;
+    if (m->kind == HELM_TUNE_PLANT) {
+        return helm_plant_advance(&m->plant, s->x, sim_u(s, m->delay));
+    }
+    double y = 0;
+    for (size_t j = 1; j <= m->nb; ++j) {
+        y += m->b[j-1] * sim_u(s, m->delay + j - 1);
+    }
+    for (size_t i = 1; i <= m->na; ++i) {
+        y -= m->a[i-1] * s->yh[(s->hy + m->na + 1 - i) % m->na];
+    }
+    if (m->na) {
+        s->hy = s->hy + 1 == m->na ? 0 : s->hy + 1;
+        s->yh[s->hy] = y;
+    }
+    return y;
+}
+
+struct helm_tune_model *
+helm_tune_model_plant(struct helm_tune_model *m,
+                      const struct helm_plant *p,
+                      size_t delay)
+{
+    memset(m, 0, sizeof(*m));
+    m->kind  = HELM_TUNE_PLANT;
+    m->dt    = p->h;
+    m->delay = delay;
+    m->plant = *p;
+    return m;
+}
+
+/** Most unknowns fitted, namely ARX coefficients and one offset. */
+enum { UNKNOWNS = 2*HELM_TUNE_ARX_MAX + 1 };
+
+/** Rotate row \c w of length <tt>p+1</tt> into triangular \c R. */
+static
+void
+givens(double R[UNKNOWNS][UNKNOWNS + 1],
+       const size_t p,
+       double * const w,
+       double * const rss)
+{
+    for (size_t j = 0; j < p; ++j) {
+        if (w[j] == 0) {
+            continue;
+        }
+        const double r = hypot(R[j][j], w[j]);
+        const double c = R[j][j] / r, s = w[j] / r;
+        R[j][j] = r;
+        for (size_t k = j + 1; k <= p; ++k) {
+            const double t = R[j][k];
+            R[j][k] = c*t + s*w[k];
+            w[k]    = c*w[k] - s*t;
+        }
+    }
+    *rss += w[p]*w[p];
+}
+
+int
+helm_tune_fit(struct helm_tune_model *m,
+              size_t n,
+              const double *u,
+              const double *y,
+              double dt,
+              size_t na,
+              size_t nb,
+              size_t dmax,
+              double *rms)
+{
+    if (!(dt > 0) || na > HELM_TUNE_ARX_MAX
+            || nb < 1 || nb > HELM_TUNE_ARX_MAX) {
+        return EINVAL;
+    }
+    const size_t p = na + nb + 1;
+    if (n <= p + (na > nb ? na : nb)) {
+        return EINVAL;
+    }
+
+    // Work in deviations from the mean operating point for conditioning,
+    // fitting an offset as the means need not be an equilibrium
+    double um = 0, ym = 0;
+    for (size_t k = 0; k < n; ++k) {
+        um += (u[k] - um) / (double) (k + 1);
+        ym += (y[k] - ym) / (double) (k + 1);
+    }
+
+    // Fit each dead time retaining whichever leaves the least residual
+    // per sample, favoring shorter dead times absent clear improvement
+    double best = INFINITY;
+    for (size_t d = 0; d <= dmax; ++d) {
+        const size_t k0 = na > d + nb ? na : d + nb;
+        if (n <= k0 + p) {
+            break;
+        }
+        double R[UNKNOWNS][UNKNOWNS + 1];
+        memset(R, 0, sizeof(R));
+        double rss = 0;
+        for (size_t k = k0; k < n; ++k) {
+            double w[UNKNOWNS + 1];
+            for (size_t i = 1; i <= na; ++i) {
+                w[i-1] = ym - y[k-i];
+            }
+            for (size_t j = 1; j <= nb; ++j) {
+                w[na+j-1] = u[k-d-j] - um;
+            }
+            w[p-1] = 1;
+            w[p]   = y[k] - ym;
+            givens(R, p, w, &rss);
+        }
+
+        // Back substitute unless the data leaves the model undetermined
+        double big = 0;
+        for (size_t j = 0; j < p; ++j) {
+            big = fmax(big, fabs(R[j][j]));
+        }
+        int singular = !(big > 0);
+        double theta[UNKNOWNS];
+        for (size_t j = p; j-- > 0 && !singular;) {
+            if (!(fabs(R[j][j]) > 1e-12 * big)) {
+                singular = 1;
+                break;
+            }
+            double t = R[j][p];
+            for (size_t k = j + 1; k < p; ++k) {
+                t -= R[j][k] * theta[k];
+            }
+            theta[j] = t / R[j][j];
+        }
+        const double mss = rss / (double) (n - k0);
+        if (singular || !(mss < (1 - parsimony) * best)) {
+            continue;
+        }
+        best = mss;
+        memset(m, 0, sizeof(*m));
+        m->kind  = HELM_TUNE_ARX;
+        m->dt    = dt;
+        m->delay = d;
+        m->na    = na;
+        m->nb    = nb;
+        memcpy(m->a, theta,      na * sizeof(double));
+        memcpy(m->b, theta + na, nb * sizeof(double));
+        if (rms) {
+            *rms = sqrt(mss);
+        }
+    }
+    return isinf(best) ? EDOM : 0;
+}
+
+int
+helm_tune_relay(const struct helm_tune_model *m,
+                double relay,
+                double hysteresis,
+                double *Ku,
+                double *Pu)
+{
+    double * const buf = malloc(history(m) * sizeof(double));
+    if (!buf) {
+        return ENOMEM;
+    }
+    struct sim s;
+    sim_init(&s, m, buf);
+
+    // Switch the relay about zero error, delimiting cycles by each upward
+    // switch, until the limit cycle has grown from rest and settled
+    double u = relay, hi = -INFINITY, lo = INFINITY;
+    double P = NAN, A = NAN, period = 0, amp = 0;
+    size_t ups = 0, last = 0, cycles = 0;
+    for (size_t k = 1; k <= RELAY_STEPS && cycles < CYCLES; ++k) {
+        const double y = sim_step(&s, u);
+        const double e = -y;
+        const double next = e > hysteresis ? relay
+                          : e < -hysteresis ? -relay : u;
+        hi = fmax(hi, y);
+        lo = fmin(lo, y);
+        if (next > u) {
+            const double p = (double) (k - last), a = (hi - lo) / 2;
+            if (++ups > 1 && fabs(p - P) <= fmax(consistent * P, 1)
+                          && fabs(a - A) <= consistent * A) {
+                period += p;
+                amp    += a;
+                ++cycles;
+            } else {
+                period = amp = 0;
+                cycles = 0;
+            }
+            P    = p;
+            A    = a;
+            last = k;
+            hi   = -INFINITY;
+            lo   = INFINITY;
+        }
+        u = next;
+    }
+    free(buf);
+    if (cycles < CYCLES || !(amp > 0) || !isfinite(amp)) {
+        return EDOM;
+    }
+    *Pu = period / CYCLES * m->dt;
+    *Ku = 4 * relay / (HELM_FREQ_PI * (amp / CYCLES));
+    return 0;
+}
+
+struct helm_tune_options *
+helm_tune_options_init(struct helm_tune_options *o)
+{
+    o->relay      = 1;
+    o->hysteresis = 0;
+    o->ms         = 1.7;
+    o->horizon    = 20;
+    o->tol        = 0.01;
+    o->iters      = 100;
+    o->nworkers   = 0;
+    return o;
+}
+
+/** Outcomes of evaluating one candidate. */
+enum outcome { SIMULATED, REJECTED, TERMINATED };
+
+/** One point of the compass search. */
+struct candidate
+{
+    double       x[DIMS];  ///< Logarithms of kp, Ti, Td, and Td/Tf
+    double       cost;     ///< Cost or infinity if not fully simulated
+    double       ms;       ///< Sensitivity peak
+    enum outcome outcome;  ///< How #cost was found
+};
+
+/** Scratch owned by one worker. */
+struct worker
+{
+    struct helm_freq g;    ///< Process response and loop scratch
+    void            *mem;  ///< Storage for #g
+    double          *buf;  ///< Input history for simulation
+};
+
+/** State shared by every worker evaluating one poll. */
+struct search
+{
+    const struct helm_tune_model   *m;       ///< Process model
+    const struct helm_tune_options *o;       ///< Options
+    size_t                          steps;   ///< Simulated steps
+    double                          bound;   ///< Cost of the current center
+    struct worker                  *w;       ///< Per-worker scratch
+    struct candidate               *c;       ///< Candidates to evaluate
+};
+
+/** Set the tuning of \c h from the coordinates \c x. */
+static
+void
+decode(const double x[DIMS], struct helm_state * const h)
+{
+    helm_reset(h);
+    h->kp = exp(x[LKP]);
+    h->Ti = exp(x[LTI]);
+    h->Td = exp(x[LTD]);
+    h->Tf = h->Td / exp(x[LN]);
+}
+
+/**
+ * Integrated absolute error of the loop closed by \c t around \c m across
+ * a unit setpoint step and, midway, a unit input load disturbance.
+ * Returns infinity once the accumulated cost exceeds \c bound.
+ */
+static
+double
+simulate(const struct helm_tune_model * const m,
+         const struct helm_state * const t,
+         const size_t steps,
+         const double bound,
+         double * const buf)
+{
+    struct sim s;
+    sim_init(&s, m, buf);
+    struct helm_state h = *t;
+    helm_approach(&h);
+    const double dt = m->dt;
+    double u = 0, v = 0, cost = 0;
+    for (size_t k = 0; k < steps; ++k) {
+        const double y = sim_step(&s, u + (k >= steps/2));
+        cost += dt * fabs(1 - y);
+        if (!(cost <= bound) || !(fabs(y) < diverged)) {
+            return INFINITY;
+        }
+        v += helm_steady(&h, dt, 1, u, v, y);
+        u  = v;
+    }
+    return cost;
+}
+
+/**
+ * Screen and then simulate candidate \c c using scratch \c w.  Candidates
+ * outside the bounds on Td/Tf are rejected like those lacking robustness.
+ */
+static
+void
+evaluate(const struct search * const s,
+         struct worker * const w,
+         struct candidate * const c)
+{
+    struct helm_state h;
+    struct helm_freq_margins g;
+    decode(c->x, &h);
+    c->ms = helm_freq_analyze(&w->g, &h, &g)->ms;
+    if (!(c->ms <= s->o->ms) || !(h.Tf > 0)
+            || c->x[LN] < log(nlo) || c->x[LN] > log(nhi)) {
+        c->cost    = INFINITY;
+        c->outcome = REJECTED;
+        return;
+    }
+    c->cost    = simulate(s->m, &h, s->steps, s->bound, w->buf);
+    c->outcome = isinf(c->cost) ? TERMINATED : SIMULATED;
+}
+
+/** Callback for helm_pool_run() evaluating candidates. */
+static
+void
+search_range(void *ctx, size_t begin, size_t end, unsigned worker)
+{
+    struct search * const s = ctx;
+    for (size_t i = begin; i < end; ++i) {
+        evaluate(s, &s->w[worker], &s->c[i]);
+    }
+}
+
+/**
+ * Tabulate the response of \c m at #FREQS frequencies spanning two decades
+ * below \c wu through Nyquist into \c g backed by \c mem.
+ */
+static
+int
+respond(const struct helm_tune_model * const m,
+        const double wu,
+        struct helm_freq * const g,
+        void * const mem)
+{
+    const double wlo = fmin(wu / 100, 1e-3 * HELM_FREQ_PI / m->dt);
+    if (m->kind == HELM_TUNE_PLANT) {
+        return helm_freq_init(g, FREQS, wlo, HELM_FREQ_PI / m->dt,
+                              &m->plant, m->delay, 0, mem);
+    }
+
+    // Tabulate a placeholder and then replace its response by the ARX model
+    static const double one[1] = { 1 };
+    struct helm_plant p;
+    if (helm_plant_init(&p, 1, one, one, m->dt, HELM_PLANT_EULER)
+            || helm_freq_init(g, FREQS, wlo, HELM_FREQ_PI / m->dt,
+                              &p, 0, 0, mem)) {
+        return 1;
+    }
+    for (size_t k = 0; k < g->n; ++k) {
+        const double qr = g->qr[k], qi = g->qi[k];
+        double nr = 0, ni = 0, dr = 1, di = 0;  // Numerator, denominator
+        double pr = 1, pi = 0;                  // Powers of q
+        const size_t top = m->na > m->delay + m->nb ? m->na
+                                                    : m->delay + m->nb;
+        for (size_t j = 1; j <= top; ++j) {
+            const double t = pr*qr - pi*qi;
+            pi = pr*qi + pi*qr;
+            pr = t;
+            if (j <= m->na) {
+                dr += m->a[j-1] * pr;
+                di += m->a[j-1] * pi;
+            }
+            if (j > m->delay && j - m->delay <= m->nb) {
+                nr += m->b[j - m->delay - 1] * pr;
+                ni += m->b[j - m->delay - 1] * pi;
+            }
+        }
+        const double dd = dr*dr + di*di;
+        g->pr[k] = (nr*dr + ni*di) / dd;
+        g->pi[k] = (ni*dr - nr*di) / dd;
+    }
+    return 0;
+}
+
+int
+helm_tune(const struct helm_tune_model *m,
+          const struct helm_tune_options *o,
+          struct helm_tune_result *r)
+{
+    memset(r, 0, sizeof(*r));
+    int err = helm_tune_relay(m, o->relay, o->hysteresis, &r->Ku, &r->Pu);
+    if (err) {
+        return err;
+    }
+
+    // Allocate per-worker scratch
+    const unsigned nworkers = o->nworkers ? o->nworkers : helm_pool_ncpu();
+    struct candidate c[2*DIMS];
+    struct search s = {
+        m, o, (size_t) ceil(o->horizon * r->Pu / m->dt), INFINITY,
+        calloc(nworkers, sizeof(struct worker)), c
+    };
+    if (!s.w) {
+        return ENOMEM;
+    }
+    for (unsigned k = 0; k < nworkers; ++k) {
+        s.w[k].buf = malloc(history(m) * sizeof(double));
+        if (!s.w[k].buf || posix_memalign(&s.w[k].mem, HELM_FREQ_ALIGN,
+                                          helm_freq_bytes(FREQS))) {
+            s.w[k].mem = NULL;
+            err = ENOMEM;
+            goto done;
+        }
+        if (respond(m, 2*HELM_FREQ_PI / r->Pu, &s.w[k].g, s.w[k].mem)) {
+            err = EDOM;
+            goto done;
+        }
+    }
+
+    // Seed by Ziegler--Nichols, detuning until robust
+    struct candidate center;
+    center.x[LKP] = log(0.6 * r->Ku);
+    center.x[LTI] = log(r->Pu / 2);
+    center.x[LTD] = log(r->Pu / 8);
+    center.x[LN]  = log(10);
+    for (int k = 0; k < DETUNE; ++k, center.x[LKP] -= log(2)) {
+        evaluate(&s, &s.w[0], &center);
+        if (center.outcome == SIMULATED) {
+            break;
+        }
+    }
+    if (center.outcome != SIMULATED) {
+        err = EDOM;
+        goto done;
+    }
+    ++r->simulated;
+    decode(center.x, &r->seed);
+    r->seed_cost = center.cost;
+
+    // Compass search polling every coordinate direction concurrently
+    double delta = log(2);
+    for (; r->iters < o->iters && delta >= o->tol; ++r->iters) {
+        for (size_t k = 0; k < 2*DIMS; ++k) {
+            memcpy(c[k].x, center.x, sizeof(center.x));
+            c[k].x[k/2] += k % 2 ? -delta : delta;
+        }
+        s.bound = center.cost;
+        helm_pool_run(2*DIMS, 1, nworkers, search_range, &s);
+        size_t best = 0;
+        for (size_t k = 0; k < 2*DIMS; ++k) {
+            r->simulated  += c[k].outcome != REJECTED;
+            r->rejected   += c[k].outcome == REJECTED;
+            r->terminated += c[k].outcome == TERMINATED;
+            best = c[k].cost < c[best].cost ? k : best;
+        }
+        if (c[best].cost < center.cost) {
+            center = c[best];
+        } else {
+            delta /= 2;
+        }
+    }
+    decode(center.x, &r->tuned);
+    r->cost = center.cost;
+    r->ms   = center.ms;
+
+done:
+    for (unsigned k = 0; k < nworkers; ++k) {
+        free(s.w[k].buf);
+        free(s.w[k].mem);
+    }
+    free(s.w);
+    return err;
+}
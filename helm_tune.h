@@ -0,0 +1,217 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+#ifndef HELM_TUNE_H
+#define HELM_TUNE_H
+
+#include <stddef.h>
+
+#include "helm.h"
+#include "helm_plant.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \file
+ * Automatic tuning of helm_steady() by relay feedback followed by parallel,
+ * derivative-free refinement against a process model.
+ *
+ * Models are either a helm_plant with whole-step dead time or a discrete
+ * ARX model
+ * \f{align}{
+ *     y_k + a_1 y_{k-1} + \dots + a_{n_a} y_{k-n_a}
+ *     = b_1 u_{k-d-1} + \dots + b_{n_b} u_{k-d-n_b}
+ * \f}
+ * fitted by helm_tune_fit() to logged, equally spaced samples of actuator
+ * position \f$u\f$ and process output \f$y\f$.  Fitting subtracts means,
+ * estimates a constant offset alongside the coefficients, and solves the
+ * least squares problem by Givens rotations so that no data matrix is
+ * stored.  The dead time \f$d\f$ minimizing the residual is
+ * selected.  Either way the tuner sees the same linear response and works
+ * in deviation variables.
+ *
+ * Tuning follows Astrom and Hagglund.  First, helm_tune_relay() replaces the
+ * controller by a relay of amplitude \f$h\f$, which drives the loop into a
+ * limit cycle near the phase crossover.  Once consecutive cycles agree, the
+ * period is the ultimate period \f$P_u\f$ and the amplitude \f$a\f$ gives
+ * the ultimate gain \f$K_u = 4h/(\pi a)\f$.  Second, Ziegler--Nichols
+ * rules seed \f$k_p = 0.6 K_u\f$, \f$T_i = P_u/2\f$, \f$T_d = P_u/8\f$,
+ * and \f$T_f = T_d/10\f$, halving \f$k_p\f$ until the sensitivity peak
+ * found by \ref helm_freq.h is acceptable.  Third, a compass search over
+ * the logarithms of \f$k_p\f$, \f$T_i\f$, \f$T_d\f$, and \f$T_d/T_f\f$
+ * minimizes the integrated absolute error across a unit setpoint step
+ * followed midway by a unit load disturbance at the process input.  The
+ * ratio \f$T_d/T_f\f$ is confined to the customary range \f$[2, 20]\f$.
+ *
+ * Each search iteration polls every coordinate direction at once.  Its
+ * candidates are simulated concurrently by \ref helm_pool.h.  Candidates
+ * whose sensitivity peak exceeds a bound, or whose filter ratio lies outside
+ * its range, are rejected before simulating.
+ * Simulations terminate early once their accumulated cost exceeds that of
+ * the current center, which cannot then be improved upon, or once the
+ * process output diverges.  Because the bound is fixed for each iteration
+ * and ties resolve to the lowest candidate, results are independent of
+ * thread count.
+ *
+ * Sample tuning a third-order process sampled every 0.1 seconds:
+ * \code
+ *   struct helm_plant p;
+ *   struct helm_tune_model m;
+ *   struct helm_tune_options o;
+ *   struct helm_tune_result t;
+ *   helm_plant_init(&p, 3, a, b, 0.1, HELM_PLANT_ZOH);
+ *   helm_tune_model_plant(&m, &p, 0);
+ *   helm_tune_options_init(&o);
+ *   if (!helm_tune(&m, &o, &t)) {
+ *       h = t.tuned;
+ *   }
+ * \endcode
+ */
+
+/** Maximum ARX orders \f$n_a\f$ and \f$n_b\f$. */
+#define HELM_TUNE_ARX_MAX 8
+
+/** Kinds of process model accepted by helm_tune(). */
+enum helm_tune_kind
+{
+    HELM_TUNE_PLANT = 0,  /**< A helm_plant with dead time.       */
+    HELM_TUNE_ARX   = 1   /**< A discrete ARX model with dead time. */
+};
+
+/** A linear process model sampled every #dt. */
+struct helm_tune_model
+{
+    enum helm_tune_kind kind;           /**< Which members apply.          */
+    double            dt;               /**< Sampling interval.            */
+    size_t            delay;            /**< Dead time \f$d\f$ in steps.   */
+    struct helm_plant plant;            /**< Process when #HELM_TUNE_PLANT. */
+    size_t            na;               /**< Order \f$n_a\f$ when ARX.     */
+    size_t            nb;               /**< Order \f$n_b\f$ when ARX.     */
+    double            a[HELM_TUNE_ARX_MAX];  /**< \f$a_1, \dots, a_{n_a}\f$. */
+    double            b[HELM_TUNE_ARX_MAX];  /**< \f$b_1, \dots, b_{n_b}\f$. */
+};
+
+/** Settings for helm_tune() with defaults from helm_tune_options_init(). */
+struct helm_tune_options
+{
+    double   relay;     /**< Relay amplitude \f$h\f$.                       */
+    double   hysteresis;/**< Relay hysteresis about zero error.             */
+    double   ms;        /**< Largest acceptable sensitivity peak.           */
+    double   horizon;   /**< Simulated duration in units of \f$P_u\f$.      */
+    double   tol;       /**< Final relative step of the compass search.     */
+    unsigned iters;     /**< Maximum compass search iterations.             */
+    unsigned nworkers;  /**< Threads, where zero selects helm_pool_ncpu().  */
+};
+
+/** Outcome of helm_tune(). */
+struct helm_tune_result
+{
+    double            Ku;          /**< Ultimate gain from the relay.       */
+    double            Pu;          /**< Ultimate period from the relay.     */
+    struct helm_state seed;        /**< Detuned Ziegler--Nichols tuning.     */
+    double            seed_cost;   /**< Cost of #seed.                      */
+    struct helm_state tuned;       /**< Refined tuning.                     */
+    double            cost;        /**< Cost of #tuned.                     */
+    double            ms;          /**< Sensitivity peak of #tuned.         */
+    unsigned          iters;       /**< Compass search iterations taken.    */
+    size_t            simulated;   /**< Candidates simulated.               */
+    size_t            rejected;    /**< Candidates rejected unsimulated.    */
+    size_t            terminated;  /**< Simulations terminated early.       */
+};
+
+/**
+ * \brief Model process \c p, already initialized at the sampling interval,
+ * with a dead time of \c delay steps.
+ * \return Argument \c m to permit call chaining.
+ */
+struct helm_tune_model *
+helm_tune_model_plant(struct helm_tune_model *m,
+                      const struct helm_plant *p,
+                      size_t delay);
+
+/**
+ * \brief Fit an ARX model of orders \c na and \c nb to \c n logged samples.
+ *
+ * Every dead time within <tt>[0, dmax]</tt> is tried and the one giving
+ * the smallest mean square residual retained.  A longer dead time must
+ * reduce that residual by at least one percent to be preferred.
+ *
+ * \param[out] m    Fitted model.
+ * \param[in]  n    Number of samples.
+ * \param[in]  u    Actuator positions \f$u_k\f$.
+ * \param[in]  y    Process outputs \f$y_k\f$.
+ * \param[in]  dt   Sampling interval.
+ * \param[in]  na   Order \f$n_a\f$, at most #HELM_TUNE_ARX_MAX.
+ * \param[in]  nb   Order \f$n_b\f$, within <tt>[1, HELM_TUNE_ARX_MAX]</tt>.
+ * \param[in]  dmax Largest dead time tried in steps.
+ * \param[out] rms  If non-NULL, root mean square one-step residual.
+ *
+ * \return Zero on success, \c EINVAL on invalid arguments or too few
+ *         samples, or \c EDOM when the data cannot determine a model.
+ */
+int
+helm_tune_fit(struct helm_tune_model *m,
+              size_t n,
+              const double *u,
+              const double *y,
+              double dt,
+              size_t na,
+              size_t nb,
+              size_t dmax,
+              double *rms);
+
+/**
+ * \brief Run a relay experiment on \c m finding \c Ku and \c Pu.
+ *
+ * \param[in]  m          Process model.
+ * \param[in]  relay      Relay amplitude \f$h\f$.
+ * \param[in]  hysteresis Relay hysteresis about zero error.
+ * \param[out] Ku         Ultimate gain.
+ * \param[out] Pu         Ultimate period.
+ *
+ * \return Zero on success or \c EDOM when no steady limit cycle emerges.
+ */
+int
+helm_tune_relay(const struct helm_tune_model *m,
+                double relay,
+                double hysteresis,
+                double *Ku,
+                double *Pu);
+
+/**
+ * \brief Set default options: unit relay without hysteresis, sensitivity
+ * peak at most 1.7, a horizon of 20 ultimate periods, tolerance 0.01, 100
+ * iterations, and every online processor.
+ * \return Argument \c o to permit call chaining.
+ */
+struct helm_tune_options *
+helm_tune_options_init(struct helm_tune_options *o);
+
+/**
+ * \brief Tune a controller for process model \c m.
+ *
+ * Tuned parameters \c kp, \c Td, \c Tf, and \c Ti are set within \c
+ * r->tuned, with \c Tt infinite and state reset as by helm_approach().
+ *
+ * \return Zero on success, \c ENOMEM, or \c EDOM should the relay
+ *         experiment or seeding fail.
+ */
+int
+helm_tune(const struct helm_tune_model *m,
+          const struct helm_tune_options *o,
+          struct helm_tune_result *r);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* HELM_TUNE_H */
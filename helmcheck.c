@@ -0,0 +1,1480 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Executable checks of the invariants documented by the library headers.
+ *
+ * Each check exercises one module against the property its header
+ * promises, e.g. that concurrent retuning never tears a parameter set.
+ * Checks print one line each and the exit status is nonzero should any
+ * fail.  Naming one or more check prefixes restricts which run.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <float.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "helm.h"
+#include "helm_bank.h"
+#include "helm_cascade.h"
+#include "helm_ckpt.h"
+#include "helm_fixed.h"
+#include "helm_freq.h"
+#include "helm_gain.h"
+#include "helm_plant.h"
+#include "helm_retune.h"
+#include "helm_shm.h"
+#include "helm_sparse.h"
+#include "helm_trace.h"
+#include "helm_tune.h"
+
+/** Failures accumulated by the running check. */
+static unsigned long failures;
+
+/** Count a failure of \c cond, reporting only the first few. */
+#define CHECK(cond)                                                       \
+    do {                                                                  \
+        if (!(cond) && failures++ < 5) {                                  \
+            fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+        }                                                                 \
+    } while (0)
+
+/** Tuning shared by checks needing an arbitrary nontrivial controller. */
+static
+void
+tune(struct helm_state * const h)
+{
+    helm_reset(h);
+    h->kp = 2;
+    h->Td = 0.25;
+    h->Tf = 0.025;
+    h->Ti = 1.5;
+    h->Tt = 1.5;
+    helm_approach(h);
+}
+
+/** Uniform deviate on <tt>[lo, hi)</tt> from xorshift64* state \c s. */
+static
+double
+uniform(uint64_t * const s, const double lo, const double hi)
+{
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    const uint64_t x = *s * UINT64_C(2685821657736338717);
+    return lo + (hi - lo) * (double) (x >> 11) * 0x1p-53;
+}
+
+/** Random tunings within the compiled check. */
+enum { COMPILED_TUNINGS = 200000 };
+
+/**
+ * Step random tunings, including disabled terms, through helm_steady() and
+ * helm_steady_compiled() in lockstep, confirming transient state agrees bit
+ * for bit and each increment lies within the \f$7\epsilon\f$ bound
+ * documented by \ref helm_real.h.  Then confirm that changing \c dt or any
+ * tuning parameter rebuilds the record while an unchanged tuning does not.
+ */
+static
+void
+check_compiled(void)
+{
+    uint64_t seed = 12345;
+    for (int t = 0; t < COMPILED_TUNINGS; ++t) {
+        struct helm_state a, b;
+        helm_reset(&a);
+        a.kp = uniform(&seed, 0.1, 10);
+        a.Td = t % 5 ? uniform(&seed, 0, 1)      : 0;
+        a.Tf = t % 7 ? uniform(&seed, 0.01, 1)   : INFINITY;
+        a.Ti = t % 3 ? uniform(&seed, 0.1, 10)   : INFINITY;
+        a.Tt = t % 4 ? uniform(&seed, 0.1, 10)   : INFINITY;
+        helm_approach(&a);
+        b = a;
+        const double dt = uniform(&seed, 1e-3, 1e-1);
+        struct helm_compiled c = helm_compile(&b, dt);
+        for (int k = 0; k < 4; ++k) {
+            const double r = uniform(&seed, -1, 1), u = uniform(&seed, -1, 1);
+            const double v = uniform(&seed, -1, 1), y = uniform(&seed, -1, 1);
+            const double hy = isnan(a.f) ? y : a.y;
+            const double hf = isnan(a.f) ? y : a.f;
+            const double df = dt / (a.Tf + dt) * (y - hf), dy = y - hy;
+            const double bound = 7 * DBL_EPSILON * (
+                  fabs(a.kp * dt * (r - y) / a.Ti)
+                + fabs(a.kp * dt * (u - v) / a.Tt)
+                + fabs(a.kp * (a.Td / a.Tf) * (df - dy))
+                + fabs(a.kp * dy));
+            const double e = helm_steady(&a, dt, r, u, v, y);
+            const double d = helm_steady_compiled(&b, &c, dt, r, u, v, y);
+            CHECK(fabs(d - e) <= bound);
+            CHECK(!memcmp(&a.y, &b.y, sizeof(a.y)));
+            CHECK(!memcmp(&a.f, &b.f, sizeof(a.f)));
+        }
+    }
+
+    // Every change rebuilds the record and no change leaves it alone
+    struct helm_state h;
+    tune(&h);
+    double dt = 0.01;
+    struct helm_compiled c = helm_compile(&h, dt);
+    for (int field = 0; field <= 6; ++field) {
+        switch (field) {
+        case 0: dt   *= 2; break;
+        case 1: h.kp *= 2; break;
+        case 2: h.Td *= 2; break;
+        case 3: h.Tf *= 2; break;
+        case 4: h.Ti *= 2; break;
+        case 5: h.Tt *= 2; break;
+        case 6: c.ki  = 42; break;        // Unchanged tuning keeps a stale ki
+        }
+        helm_steady_compiled(&h, &c, dt, 1, 0, 0, 0);
+        const struct helm_compiled e = helm_compile(&h, dt);
+        CHECK(field == 6 ? c.ki == 42 : !memcmp(&c, &e, sizeof(c)));
+    }
+}
+
+/** Parameter sets published by the retune check's operator. */
+enum { PUBLISHES = 2000000 };
+
+/** Operator thread publishing parameter sets encoding one counter. */
+static
+void *
+retune_operator(void * const arg)
+{
+    struct helm_retune * const p = arg;
+    struct helm_state t;
+    helm_reset(&t);
+    for (long k = 1; k <= PUBLISHES; ++k) {
+        t.kp = k;
+        t.Td = 2.0 * k;
+        t.Tf = 3.0 * k;
+        t.Ti = 4.0 * k;
+        t.Tt = 5.0 * k;
+        helm_retune_publish(p, &t);
+    }
+    return NULL;
+}
+
+/**
+ * Retune a running controller from another thread as within \ref
+ * helm_retune.h, confirming every applied parameter set is one published
+ * whole, sequence numbers never regress, the final set is eventually
+ * applied, and transient state is untouched by retuning.
+ */
+static
+void
+check_retune(void)
+{
+    static struct helm_retune p;
+    struct helm_state h;
+    tune(&h);
+    unsigned seen = helm_retune_init(&p, &h);
+    CHECK(seen == 0);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, retune_operator, &p)) {
+        perror("retune");
+        exit(EXIT_FAILURE);
+    }
+    double v = 0, last = 0;
+    long applied = 0;
+    for (long i = 0; h.kp < PUBLISHES; ++i) {
+        const unsigned before = seen;
+        const double y = h.y, f = h.f;
+        if (helm_retune_apply(&p, &seen, &h)) {
+            ++applied;
+            CHECK(!(seen & 1) && seen > before);
+            CHECK(h.kp == floor(h.kp) && h.kp > last);
+            CHECK(   h.Td == 2*h.kp && h.Tf == 3*h.kp
+                  && h.Ti == 4*h.kp && h.Tt == 5*h.kp);
+            CHECK(y == h.y || (isnan(y) && isnan(h.y)));
+            CHECK(f == h.f || (isnan(f) && isnan(h.f)));
+            last = h.kp;
+        }
+        v += helm_steady(&h, 1e-3, 1, v, v, sin(1e-3 * i));
+        CHECK(isfinite(v));
+    }
+    pthread_join(thread, NULL);
+    CHECK(!helm_retune_apply(&p, &seen, &h));
+    CHECK(applied > 0 && seen == 2u * PUBLISHES);
+}
+
+/** Allocate \c bytes aligned for \ref helm_bank.h or exit. */
+static
+void *
+allocate(const size_t bytes)
+{
+    void *mem;
+    if (posix_memalign(&mem, HELM_BANK_ALIGN, bytes)) {
+        perror("allocate");
+        exit(EXIT_FAILURE);
+    }
+    return mem;
+}
+
+/** Lanes and steps within the bank check, lanes deliberately odd. */
+enum { BANK_LANES = 37, BANK_STEPS = 2000 };
+
+/** Kernels within \ref helm_bank.h, portable first. */
+enum { SCALAR, SSE2, AVX2, AVX512, KERNELS };
+
+/** Names of each kernel. */
+static const char * const kernel_name[KERNELS] = {
+    "scalar", "sse2", "avx2", "avx512"
+};
+
+/**
+ * Advance all of \c b by \c kernel, when supported, followed by the
+ * portable kernel for any remaining lanes.  Returns the lanes advanced by
+ * \c kernel itself or zero when the processor lacks it.
+ */
+static
+size_t
+bank_kernel(const int kernel,
+            struct helm_bank * const b,
+            const double * const dt, const double * const r,
+            const double * const u, const double * const v,
+            const double * const y, double * const dv)
+{
+    size_t i = 0;
+    switch (kernel) {
+    case SCALAR:
+        i = b->n;
+        break;
+#if HELM_BANK_X86
+    case SSE2:
+        if (__builtin_cpu_supports("sse2")) {
+            i = helm_bank_steady_sse2(b, 0, b->n, dt, r, u, v, y, dv);
+        }
+        break;
+    case AVX2:
+        if (__builtin_cpu_supports("avx2")) {
+            i = helm_bank_steady_avx2(b, 0, b->n, dt, r, u, v, y, dv);
+        }
+        break;
+    case AVX512:
+        if (__builtin_cpu_supports("avx512f")) {
+            i = helm_bank_steady_avx512(b, 0, b->n, dt, r, u, v, y, dv);
+        }
+        break;
+#endif
+    }
+    helm_bank_steady_scalar(b, kernel == SCALAR ? 0 : i, b->n,
+                            dt, r, u, v, y, dv);
+    return i;
+}
+
+/**
+ * Advance banks through every available kernel of \ref helm_bank.h,
+ * confirming each increment and each lane's \c y and \c f match
+ * helm_steady() bit for bit.  Lanes mix disabled terms, NaN observables,
+ * and periodically restarted filters so that every lane mask is taken.
+ */
+static
+void
+check_bank(void)
+{
+    const size_t n = BANK_LANES;
+    static double dt[BANK_LANES], r[BANK_LANES], u[BANK_LANES];
+    static double v[BANK_LANES], y[BANK_LANES], dv[BANK_LANES];
+    static struct helm_state h[BANK_LANES];
+    int ran = 0;
+    for (int kernel = 0; kernel < KERNELS; ++kernel) {
+        struct helm_bank b;
+        void * const mem = allocate(helm_bank_bytes(n));
+        helm_bank_init(&b, n, mem);
+        for (size_t i = 0; i < n; ++i) {
+            helm_reset(&h[i]);
+            h[i].kp = 0.5 + 0.25 * (i % 4);
+            h[i].Td = 0.1 * (i % 5);
+            h[i].Tf = i % 7 ? 0.02 * (i % 7) : INFINITY;
+            h[i].Ti = i % 3 ? 1.0 + i % 3 : INFINITY;
+            h[i].Tt = i % 4 ? 2.0 : INFINITY;
+            helm_approach(&h[i]);
+            helm_bank_set(&b, i, &h[i]);
+        }
+        size_t lanes = 0;
+        for (int k = 0; k < BANK_STEPS; ++k) {
+            for (size_t i = 0; i < n; ++i) {
+                if (k % 100 == 50 && i % 5 == (size_t) k / 100 % 5) {
+                    helm_approach(&h[i]);
+                    b.y[i] = b.f[i] = NAN;
+                }
+                dt[i] = 1e-2 * (1 + 0.5 * (i % 3));
+                r[i]  = (k / 200 + i) & 1 ? 1 : -1;
+                v[i]  = cos(0.03 * k + (double) i);
+                u[i]  = fmin(fmax(v[i], -0.5), 0.5);
+                y[i]  = (k + i) % 13 == 5 ? NAN : sin(0.05 * k + (double) i);
+            }
+            lanes = bank_kernel(kernel, &b, dt, r, u, v, y, dv);
+            if (!lanes) {
+                break;
+            }
+            for (size_t i = 0; i < n; ++i) {
+                const double e = helm_steady(&h[i], dt[i], r[i], u[i], v[i],
+                                             y[i]);
+                CHECK(!memcmp(&dv[i],  &e,      sizeof(e)));
+                CHECK(!memcmp(&b.y[i], &h[i].y, sizeof(h[i].y)));
+                CHECK(!memcmp(&b.f[i], &h[i].f, sizeof(h[i].f)));
+            }
+        }
+        if (lanes) {
+            ++ran;
+            CHECK(lanes > n / 2);
+        } else {
+            printf("%-14s skipped %s\n", "bank", kernel_name[kernel]);
+        }
+        free(mem);
+    }
+    CHECK(ran >= 1);
+}
+
+/** Lanes and steps within the fixed check, lanes not a multiple of 16. */
+enum { FIXED_LANES = 37, FIXED_STEPS = 4000 };
+
+/** Random counts favoring the extremes, zero, and small magnitudes. */
+static
+int32_t
+fixed_counts(uint64_t * const s)
+{
+    const double p = uniform(s, 0, 1);
+    return p < 0.15 ?  HELM_FIXED_MAX
+         : p < 0.30 ? -HELM_FIXED_MAX
+         : p < 0.40 ? 0
+         : p < 0.70 ? (int32_t) uniform(s, -1000, 1000)
+         :            (int32_t) uniform(s, -HELM_FIXED_MAX, HELM_FIXED_MAX);
+}
+
+/**
+ * Check that the AVX2 and AVX-512 kernels within \ref helm_fixed.h, each
+ * followed by the scalar kernel for the remaining lanes, match
+ * helm_fixed_steady() lane by lane and bit for bit.  Lanes mix disabled
+ * terms, gains large enough to saturate at \f$\pm\f$#HELM_FIXED_MAX, and
+ * missing #HELM_FIXED_NONE observables so that every lane mask is taken.
+ */
+static
+void
+check_fixed(void)
+{
+    const size_t n = FIXED_LANES;
+    static int32_t r[FIXED_LANES], u[FIXED_LANES], v[FIXED_LANES];
+    static int32_t y[FIXED_LANES], dv[FIXED_LANES];
+    static struct helm_fixed c[FIXED_LANES];
+    for (int kernel = AVX2; kernel <= AVX512; ++kernel) {
+        struct helm_fixed_bank b;
+        void * const mem = allocate(helm_fixed_bank_bytes(n));
+        helm_fixed_bank_init(&b, n, mem);
+        uint64_t seed = 7;
+        for (size_t i = 0; i < n; ++i) {
+            struct helm_state h;
+            helm_reset(&h);
+            h.kp = exp(uniform(&seed, -3, 9));
+            h.Td = i % 5 ? exp(uniform(&seed, -3, 1)) : 0;
+            h.Tf = i % 7 ? exp(uniform(&seed, -5, 0)) : INFINITY;
+            h.Ti = i % 3 ? exp(uniform(&seed, -2, 3)) : INFINITY;
+            h.Tt = i % 4 ? exp(uniform(&seed, -2, 3)) : INFINITY;
+            if (helm_fixed_compile(&c[i], &h, 0.01, 1e-3, 1e-3)) {
+                tune(&h);
+                CHECK(!helm_fixed_compile(&c[i], &h, 0.01, 1e-3, 1e-3));
+            }
+            helm_fixed_approach(&c[i]);
+            helm_fixed_bank_set(&b, i, &c[i]);
+        }
+        size_t lanes = 0, saturated = 0;
+        for (int k = 0; k < FIXED_STEPS; ++k) {
+            for (size_t i = 0; i < n; ++i) {
+                r[i] = fixed_counts(&seed);
+                u[i] = fixed_counts(&seed);
+                v[i] = fixed_counts(&seed);
+                y[i] = uniform(&seed, 0, 1) < 0.05 ? HELM_FIXED_NONE
+                                                   : fixed_counts(&seed);
+            }
+#if HELM_FIXED_X86
+            if (kernel == AVX2 && __builtin_cpu_supports("avx2")) {
+                lanes = helm_fixed_bank_steady_avx2(&b, 0, n, r, u, v, y, dv);
+            }
+            if (kernel == AVX512 && __builtin_cpu_supports("avx512f")) {
+                lanes = helm_fixed_bank_steady_avx512(&b, 0, n,
+                                                      r, u, v, y, dv);
+            }
+#endif
+            if (!lanes) {
+                break;
+            }
+            helm_fixed_bank_steady_scalar(&b, lanes, n, r, u, v, y, dv);
+            for (size_t i = 0; i < n; ++i) {
+                const int32_t e = helm_fixed_steady(&c[i], r[i], u[i], v[i],
+                                                    y[i]);
+                saturated += e == HELM_FIXED_MAX || e == -HELM_FIXED_MAX;
+                CHECK(dv[i] == e);
+                CHECK(b.y[i] == c[i].y);
+                CHECK(b.g[i] == c[i].g);
+                CHECK(b.q[i] == c[i].q);
+            }
+        }
+        if (lanes) {
+            CHECK(lanes > n / 2);
+            CHECK(saturated > 0);
+        } else {
+            printf("%-14s skipped %s\n", "fixed", kernel_name[kernel]);
+        }
+        free(mem);
+    }
+}
+
+/** Lanes and steps within the plant check, lanes not a multiple of 32. */
+enum { PLANT_LANES = 1029, PLANT_STEPS = 256 };
+
+/**
+ * Advance distinct third-order processes through helm_plant_bank_advance()
+ * and helm_plant_advance() under both discretizations, confirming outputs
+ * and states agree lane by lane as \ref helm_plant.h promises, including
+ * within the partial final block.  Then confirm helm_plant_retime() refuses
+ * negative and non-finite step sizes, leaving the plant untouched.
+ */
+static
+void
+check_plant(void)
+{
+    const size_t n = PLANT_LANES;
+    static struct helm_plant p[PLANT_LANES];
+    static double x[PLANT_LANES][3], u[PLANT_LANES], y[PLANT_LANES];
+    for (int method = HELM_PLANT_EULER; method <= HELM_PLANT_ZOH; ++method) {
+        struct helm_plant_bank pb;
+        void * const mem = allocate(helm_plant_bank_bytes(3, n));
+        helm_plant_bank_init(&pb, 3, n, mem);
+        for (size_t k = 0; k < n; ++k) {
+            const double a[3] = {1 + 1e-3*k, 3, 3 - 1e-3*k};
+            const double b[3] = {1, 0.1*(k & 3), 0};
+            CHECK(!helm_plant_init(&p[k], 3, a, b, 1e-2*(1 + (k & 7)),
+                                   (enum helm_plant_method) method));
+            helm_plant_bank_set(&pb, k, &p[k]);
+            x[k][0] = x[k][1] = x[k][2] = 0;
+        }
+        for (size_t i = 0; i < PLANT_STEPS; ++i) {
+            for (size_t k = 0; k < n; ++k) {
+                u[k] = sin(0.1 * (double) (i + k));
+            }
+            helm_plant_bank_advance(&pb, u, y);
+            for (size_t k = 0; k < n; ++k) {
+                const double e = helm_plant_advance(&p[k], x[k], u[k]);
+                CHECK(!memcmp(&y[k], &e, sizeof(e)));
+                for (size_t j = 0; j < 3; ++j) {
+                    CHECK(!memcmp(&pb.x[j*pb.stride + k], &x[k][j],
+                                  sizeof(x[k][j])));
+                }
+            }
+        }
+        free(mem);
+    }
+
+    const double bad[3] = { -1e-2, INFINITY, NAN };
+    for (int k = 0; k < 3; ++k) {
+        const struct helm_plant q = p[0];
+        CHECK(helm_plant_retime(&p[0], bad[k]) != 0);
+        CHECK(!memcmp(&q, &p[0], sizeof(q)));
+    }
+    CHECK(helm_plant_retime(&p[0], 0) == 0);
+}
+
+/** Cascades and steps within the cascade check. */
+enum { CASCADE_LANES = 300, CASCADE_STEPS = 3000 };
+
+/**
+ * Step one- and two-level cascades whose actuators track their requests,
+ * confirming \ref helm_cascade.h reproduces separate helm_steady() calls
+ * bit for bit across more than one block.  Then drive saturated two-level
+ * cascades, some with zero ratio, through a NaN inner observable and a NaN
+ * actuator position, confirming requests stay finite and the loops recover
+ * once the reference becomes achievable.
+ */
+static
+void
+check_cascade(void)
+{
+    const size_t n = CASCADE_LANES;
+    static double dt[CASCADE_LANES], r[CASCADE_LANES], u[CASCADE_LANES];
+    static double yo[CASCADE_LANES], yi[CASCADE_LANES];
+    static double vo[CASCADE_LANES], vi[CASCADE_LANES];
+    static double a[CASCADE_LANES], yn[CASCADE_LANES];
+    static struct helm_state ho[CASCADE_LANES], hi[CASCADE_LANES];
+    const double * const y[2] = { yo, yi };
+
+    for (size_t L = 1; L <= 2; ++L) {
+        struct helm_cascade c;
+        void * const mem = allocate(helm_cascade_bytes(L, n));
+        helm_cascade_init(&c, L, n, mem);
+        for (size_t i = 0; i < n; ++i) {
+            tune(&ho[i]);
+            ho[i].kp *= 1 + 0.1 * (i % 7);
+            tune(&hi[i]);
+            hi[i].Ti *= 1 + 0.2 * (i % 3);
+            helm_bank_set(&c.level[0], i, &ho[i]);
+            if (L > 1) {
+                helm_bank_set(&c.level[1], i, &hi[i]);
+                c.g[1][i] = 0.5 + 0.25 * (i % 5);
+            }
+            dt[i] = 1e-2;
+            yo[i] = yi[i] = vo[i] = vi[i] = 0;
+        }
+        helm_cascade_approach(&c);
+        for (int k = 0; k < CASCADE_STEPS; ++k) {
+            for (size_t i = 0; i < n; ++i) {
+                r[i] = (k / 500 + i) & 1 ? 1 : -1;
+                u[i] = c.v[L-1][i];
+            }
+            helm_cascade_steady(&c, dt, r, u, L > 1 ? y : y + 1);
+            for (size_t i = 0; i < n; ++i) {
+                const double * const yl = L > 1 ? yo : yi;
+                vo[i] += helm_steady(&ho[i], dt[i], r[i], vo[i], vo[i], yl[i]);
+                if (L > 1) {
+                    vi[i] += helm_steady(&hi[i], dt[i], c.g[1][i] * vo[i],
+                                         vi[i], vi[i], yi[i]);
+                }
+                CHECK(!memcmp(&c.v[0][i], &vo[i], sizeof(vo[i])));
+                CHECK(L < 2 || !memcmp(&c.v[1][i], &vi[i], sizeof(vi[i])));
+                yi[i] += dt[i] * (c.v[L-1][i] - yi[i]) / 0.05;
+                yo[i] += dt[i] * (yi[i] - yo[i]) / 0.5;
+            }
+        }
+        free(mem);
+    }
+
+    struct helm_cascade c;
+    void * const mem = allocate(helm_cascade_bytes(2, n));
+    helm_cascade_init(&c, 2, n, mem);
+    for (size_t i = 0; i < n; ++i) {
+        helm_reset(&ho[i]);                      // PI matching each plant
+        ho[i].kp = 1;
+        ho[i].Ti = ho[i].Tt = 0.5;
+        helm_approach(&ho[i]);
+        hi[i] = ho[i];
+        hi[i].Ti = hi[i].Tt = 0.05;
+        helm_bank_set(&c.level[0], i, &ho[i]);
+        helm_bank_set(&c.level[1], i, &hi[i]);
+        c.g[1][i] = i % 10 ? 0.5 + 0.25 * (i % 5) : 0;
+        yo[i] = yi[i] = 0;
+    }
+    helm_cascade_approach(&c);
+    const double * const ys[2] = { yo, yn };
+    for (int k = 0; k < CASCADE_STEPS; ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            r[i]  = k < CASCADE_STEPS / 3 ? 1 : 0.1;
+            a[i]  = fmin(fmax(c.v[1][i], -0.2), 0.2);
+            u[i]  = k == 40 ? NAN : a[i];
+            yn[i] = k == 20 ? NAN : yi[i];
+        }
+        helm_cascade_steady(&c, dt, r, u, ys);
+        for (size_t i = 0; i < n; ++i) {
+            CHECK(isfinite(c.v[0][i]) && isfinite(c.v[1][i]));
+            yi[i] += dt[i] * (a[i] - yi[i]) / 0.05;
+            yo[i] += dt[i] * (yi[i] - yo[i]) / 0.5;
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        CHECK(c.g[1][i] == 0 || fabs(yo[i] - 0.1) < 1e-3);
+    }
+    free(mem);
+}
+
+/** Samples within the series check. */
+enum { SERIES_SAMPLES = 5000 };
+
+/**
+ * Replay one recorded stream, including NaN dropouts and varying time
+ * steps, through helm_steady_series() under every combination of flags and
+ * through a per-sample helm_steady() loop.  Outputs and final transient
+ * state must agree bit for bit, and an empty series must touch nothing.
+ */
+static
+void
+check_series(void)
+{
+    const size_t n = SERIES_SAMPLES;
+    static double dt[SERIES_SAMPLES], r[SERIES_SAMPLES], u[SERIES_SAMPLES];
+    static double y[SERIES_SAMPLES], v[SERIES_SAMPLES], e[SERIES_SAMPLES];
+    for (size_t i = 0; i < n; ++i) {
+        dt[i] = 1e-2 * (1 + 0.25 * (double) (i % 4));
+        r[i]  = (i / 700) & 1 ? 1 : -0.5;
+        u[i]  = fmin(fmax(sin(1e-2 * (double) i), -0.8), 0.8);
+        y[i]  = i % 29 == 3 ? NAN : cos(7e-3 * (double) i);
+    }
+    for (unsigned flags = 0; flags < 4; ++flags) {
+        const int acc = (flags & HELM_SERIES_ACCUMULATE) != 0;
+        const int dtc = (flags & HELM_SERIES_DT_CONSTANT) != 0;
+        struct helm_state a, b;
+        tune(&a);
+        b = a;
+        double w = 0.125;                 // Requested before first sample
+        for (size_t i = 0; i < n; ++i) {
+            v[i] = acc ? (i ? NAN : w) : sin(3e-3 * (double) i);
+            const double dv = helm_steady(&b, dt[dtc ? 0 : i], r[i], u[i],
+                                          acc ? w : v[i], y[i]);
+            w   += dv;
+            e[i] = acc ? w : dv;
+        }
+        helm_steady_series(&a, n, dt, r, u, v, y, flags);
+        CHECK(!memcmp(v, e, sizeof(v)));
+        CHECK(!memcmp(&a, &b, sizeof(a)));
+
+        const double sentinel = v[0];
+        helm_steady_series(&a, 0, dt, r, u, v, y, flags);
+        CHECK(!memcmp(&a, &b, sizeof(a)));
+        CHECK(!memcmp(&v[0], &sentinel, sizeof(sentinel)));
+    }
+}
+
+/** Lanes and steps within the sparse check. */
+enum { SPARSE_LANES = 1001, SPARSE_STEPS = 4000 };
+
+/**
+ * Step identical closed loops densely by helm_bank_steady() and sparsely by
+ * helm_sparse_steady() with zero deadband, confirming that \ref
+ * helm_sparse.h reproduces every request bit for bit while loops sleep and
+ * wake.  A quarter of the loops never leave setpoint, a quarter sleep until
+ * a reference change, a quarter periodically change reference, and a
+ * quarter periodically saturate their actuators.
+ */
+static
+void
+check_sparse(void)
+{
+    const size_t n = SPARSE_LANES;
+    static double dt[SPARSE_LANES], r[SPARSE_LANES], dv[SPARSE_LANES];
+    static double u1[SPARSE_LANES], v1[SPARSE_LANES], y1[SPARSE_LANES];
+    static double u2[SPARSE_LANES], v2[SPARSE_LANES], y2[SPARSE_LANES];
+    static size_t lanes[SPARSE_LANES];
+    struct helm_bank dense, sparse;
+    struct helm_sparse s;
+    void * const m1 = allocate(helm_bank_bytes(n));
+    void * const m2 = allocate(helm_bank_bytes(n));
+    void * const ms = allocate(helm_sparse_bytes(n));
+    helm_bank_init(&dense,  n, m1);
+    helm_bank_init(&sparse, n, m2);
+    struct helm_state h;
+    tune(&h);
+    for (size_t i = 0; i < n; ++i) {
+        h.kp = 1 + 1e-3 * i;
+        helm_bank_set(&dense,  i, &h);
+        helm_bank_set(&sparse, i, &h);
+        dt[i] = 1e-2;
+        u1[i] = v1[i] = y1[i] = u2[i] = v2[i] = y2[i] = 0;
+    }
+    helm_bank_approach(&dense);
+    helm_bank_approach(&sparse);
+    helm_sparse_init(&s, &sparse, 0, ms);
+
+    static unsigned char was[SPARSE_LANES], now[SPARSE_LANES];
+    size_t stepped = 0, woke = 0;
+    for (size_t k = 0; k < SPARSE_STEPS; ++k) {
+        for (size_t i = 0; i < n; ++i) {
+            const int phase = (int) ((k + 37*i) / 500) & 1;
+            switch (i % 4) {
+            case 0:  r[i] = 0;                           break;
+            case 1:  r[i] = k >= 1000 + i ? 0.5 : 0;     break;
+            case 2:  r[i] = 0.5 * phase;                 break;
+            default: r[i] = 3.0 * phase;                 break;
+            }
+            helm_sparse_sense(&s, i, r[i], u2[i], v2[i], y2[i]);
+        }
+        helm_bank_steady(&dense, dt, r, u1, v1, y1, dv);
+        for (size_t i = 0; i < n; ++i) {
+            v1[i] += dv[i];
+        }
+        const size_t m = helm_sparse_steady(&s, dt[0], lanes, dv);
+        memset(now, 0, sizeof(now));
+        for (size_t j = 0; j < m; ++j) {
+            v2[lanes[j]] += dv[j];
+            now[lanes[j]] = 1;
+            woke += k && !was[lanes[j]];
+        }
+        memcpy(was, now, sizeof(was));
+        stepped += m;
+        for (size_t i = 0; i < n; ++i) {
+            CHECK(!memcmp(&v1[i], &v2[i], sizeof(double)));
+            u1[i] = fmin(fmax(v1[i], -1), 1);
+            u2[i] = fmin(fmax(v2[i], -1), 1);
+            y1[i] += dt[i] * (u1[i] - y1[i]) / 0.05;
+            y2[i] += dt[i] * (u2[i] - y2[i]) / 0.05;
+        }
+    }
+    CHECK(woke >= n / 4 && stepped < n * (size_t) SPARSE_STEPS * 3 / 4);
+    free(ms);
+    free(m2);
+    free(m1);
+}
+
+/** Whether tunings \c a and \c b are identical bit for bit. */
+static
+int
+same_tuning(const struct helm_state * const a,
+            const struct helm_state * const b)
+{
+    return !memcmp(&a->kp, &b->kp, sizeof(a->kp))
+        && !memcmp(&a->Td, &b->Td, sizeof(a->Td))
+        && !memcmp(&a->Tf, &b->Tf, sizeof(a->Tf))
+        && !memcmp(&a->Ti, &b->Ti, sizeof(a->Ti))
+        && !memcmp(&a->Tt, &b->Tt, sizeof(a->Tt));
+}
+
+/** Lanes within the checkpoint check, deliberately not a multiple of 8. */
+enum { CKPT_LANES = 37 };
+
+/** Step bank \c b with requests \c v through deterministic inputs \c k. */
+static
+void
+ckpt_step(struct helm_bank * const b,
+          double * const v,
+          const long k)
+{
+    static double dt[CKPT_LANES], r[CKPT_LANES], u[CKPT_LANES];
+    static double y[CKPT_LANES], dv[CKPT_LANES];
+    for (size_t i = 0; i < b->n; ++i) {
+        dt[i] = 1e-2;
+        r[i]  = (k / 50 + (long) i) & 1 ? 1 : -1;
+        u[i]  = fmin(fmax(v[i], -1), 1);
+        y[i]  = sin(1e-2 * (double) k + (double) i);
+    }
+    helm_bank_steady(b, dt, r, u, v, y, dv);
+    for (size_t i = 0; i < b->n; ++i) {
+        v[i] += dv[i];
+    }
+}
+
+/** Are banks \c a and \c b with requests \c va and \c vb bitwise equal? */
+static
+int
+same_lanes(const struct helm_bank * const a, const double * const va,
+           const struct helm_bank * const b, const double * const vb)
+{
+    const size_t bytes = a->n * sizeof(double);
+    return a->n == b->n
+        && !memcmp(a->kp, b->kp, bytes) && !memcmp(a->Td, b->Td, bytes)
+        && !memcmp(a->Tf, b->Tf, bytes) && !memcmp(a->Ti, b->Ti, bytes)
+        && !memcmp(a->Tt, b->Tt, bytes) && !memcmp(a->y,  b->y,  bytes)
+        && !memcmp(a->f,  b->f,  bytes) && !memcmp(va, vb, bytes);
+}
+
+/**
+ * In a child process, open \c path, take \c steps steps from \c k, and
+ * optionally begin one more before dying by \c SIGKILL.  Returns nonzero
+ * when the child died as intended.
+ */
+static
+int
+ckpt_killed(const char * const path,
+            const struct helm_state * const h,
+            const long k,
+            const long steps,
+            const int midstep)
+{
+    const pid_t pid = fork();
+    if (pid == 0) {
+        struct helm_ckpt c;
+        if (helm_ckpt_open(&c, path, CKPT_LANES, h, NULL)) {
+            _exit(EXIT_FAILURE);
+        }
+        for (long j = k; j < k + steps; ++j) {
+            helm_ckpt_begin(&c);
+            ckpt_step(&c.bank, c.v, j);
+            helm_ckpt_end(&c);
+        }
+        if (midstep) {
+            helm_ckpt_begin(&c);
+        }
+        kill(getpid(), SIGKILL);
+        _exit(EXIT_FAILURE);
+    }
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid
+        && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+}
+
+/**
+ * Flip one bit of the first occurrence of \c key within the leading page of
+ * \c path, returning nonzero on success.
+ */
+static
+int
+ckpt_corrupt(const char * const path,
+             const char * const key,
+             const size_t len)
+{
+    char buf[4096];
+    const int fd = open(path, O_RDWR);
+    const ssize_t got = fd < 0 ? -1 : pread(fd, buf, sizeof(buf), 0);
+    int done = 0;
+    for (ssize_t i = 0; !done && i + (ssize_t) len <= got; ++i) {
+        if (!memcmp(buf + i, key, len)) {
+            buf[i] ^= 1;
+            done = pwrite(fd, buf + i, 1, (off_t) i) == 1;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    return done;
+}
+
+/**
+ * Reopen a checkpointed bank as within \ref helm_ckpt.h after clean closes,
+ * after \c SIGKILL between steps and mid-step, after a reboot as mimicked by
+ * altering the recorded boot identifier, and with a corrupt snapshot.  Each
+ * reopening must report the documented origin and resume every lane's
+ * tuning, \c y, \c f, and \c v bit for bit against a reference bank.
+ * Mismatched lane counts in the live file or snapshot must give \c EINVAL.
+ */
+static
+void
+check_ckpt(void)
+{
+    const size_t n = CKPT_LANES;
+    char dir[] = "/tmp/helmcheck.XXXXXX";
+    if (!mkdtemp(dir)) {
+        perror("mkdtemp");
+        exit(EXIT_FAILURE);
+    }
+    char path[sizeof(dir) + 8], snap[sizeof(path) + 8];
+    snprintf(path, sizeof(path), "%s/loops", dir);
+    snprintf(snap, sizeof(snap), "%s.snap", path);
+    char boot[40] = "";
+    FILE * const f = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (f) {
+        CHECK(fgets(boot, sizeof(boot), f) != NULL);
+        fclose(f);
+    }
+
+    struct helm_state h;
+    tune(&h);
+    struct helm_bank ref, fresh, saved;
+    static double vref[CKPT_LANES], vfresh[CKPT_LANES], vsaved[CKPT_LANES];
+    void * const m1 = allocate(helm_bank_bytes(n));
+    void * const m2 = allocate(helm_bank_bytes(n));
+    void * const m3 = allocate(helm_bank_bytes(n));
+    helm_bank_init(&ref,   n, m1);
+    helm_bank_init(&fresh, n, m2);
+    helm_bank_init(&saved, n, m3);
+    for (size_t i = 0; i < n; ++i) {
+        helm_bank_set(&fresh, i, &h);
+    }
+    helm_bank_approach(&fresh);
+    memcpy(m1, m2, helm_bank_bytes(n));
+
+    // Fresh start, clean close, and resumption in place
+    struct helm_ckpt c;
+    enum helm_ckpt_origin o = HELM_CKPT_LIVE;
+    long k = 0;
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_FRESH);
+    CHECK(same_lanes(&c.bank, c.v, &fresh, vfresh));
+    for (; k < 200; ++k) {
+        helm_ckpt_begin(&c);
+        ckpt_step(&c.bank, c.v, k);
+        helm_ckpt_end(&c);
+        ckpt_step(&ref, vref, k);
+    }
+    CHECK(helm_ckpt_close(&c) == 0);
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_LIVE);
+    CHECK(same_lanes(&c.bank, c.v, &ref, vref));
+
+    // Snapshot, then keep stepping before another clean close
+    CHECK(helm_ckpt_snapshot(&c) == 0);
+    memcpy(m3, m1, helm_bank_bytes(n));
+    memcpy(vsaved, vref, sizeof(vsaved));
+    for (; k < 250; ++k) {
+        helm_ckpt_begin(&c);
+        ckpt_step(&c.bank, c.v, k);
+        helm_ckpt_end(&c);
+        ckpt_step(&ref, vref, k);
+    }
+    CHECK(helm_ckpt_close(&c) == 0);
+
+    // Lane count mismatches within the live file are refused
+    CHECK(helm_ckpt_open(&c, path, n + 1, &h, &o) == EINVAL);
+
+    // Killed between steps on an unchanged boot resumes in place
+    CHECK(ckpt_killed(path, &h, k, 50, 0));
+    for (long j = k; j < k + 50; ++j) {
+        ckpt_step(&ref, vref, j);
+    }
+    k += 50;
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_LIVE);
+    CHECK(same_lanes(&c.bank, c.v, &ref, vref));
+    CHECK(helm_ckpt_close(&c) == 0);
+
+    // Killed mid-step leaves an odd sequence so the snapshot is restored
+    CHECK(ckpt_killed(path, &h, k, 10, 1));
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_SNAPSHOT);
+    CHECK(same_lanes(&c.bank, c.v, &saved, vsaved));
+    CHECK(helm_ckpt_close(&c) == 0);
+
+    // Killed between steps before a reboot restores the snapshot
+    CHECK(ckpt_killed(path, &h, k, 10, 0));
+    CHECK(boot[0] && ckpt_corrupt(path, boot, strlen(boot)));
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_SNAPSHOT);
+    CHECK(same_lanes(&c.bank, c.v, &saved, vsaved));
+    CHECK(helm_ckpt_close(&c) == 0);
+
+    // Lane count mismatches within the snapshot are refused
+    CHECK(unlink(path) == 0);
+    CHECK(helm_ckpt_open(&c, path, n + 1, &h, &o) == EINVAL);
+
+    // An untrusted live file with a truncated snapshot starts fresh
+    CHECK(ckpt_killed(path, &h, k, 10, 1));
+    struct stat st;
+    CHECK(stat(snap, &st) == 0 && truncate(snap, st.st_size - 8) == 0);
+    CHECK(helm_ckpt_open(&c, path, n, &h, &o) == 0);
+    CHECK(o == HELM_CKPT_FRESH);
+    CHECK(same_lanes(&c.bank, c.v, &fresh, vfresh));
+    CHECK(helm_ckpt_close(&c) == 0);
+
+    unlink(snap);
+    unlink(path);
+    rmdir(dir);
+    free(m3);
+    free(m2);
+    free(m1);
+}
+
+/** Frequencies tabulated and samples per measurement in the freq check. */
+enum { FREQ_N = 4096, FREQ_SAMPLES = 4096 };
+
+/**
+ * Measure the loop response of \c h around \c p with \c delay steps of
+ * dead time and actuator lag \c Ta at \c m cycles per #FREQ_SAMPLES steps
+ * by breaking the loop at the process output, driving the controller with
+ * a unit cosine, and correlating the returning output once transients decay.
+ * \return The complex ratio of returning to applied signals, namely -L.
+ */
+static
+void
+freq_simulate(const struct helm_plant * const p,
+              const struct helm_state * const h,
+              const size_t delay,
+              const double Ta,
+              const int m,
+              double * const re,
+              double * const im)
+{
+    struct helm_state c = *h;
+    struct helm_delay dl;
+    double buf[8], x[HELM_PLANT_MAX] = { 0 };
+    helm_delay_init(&dl, delay, 1, buf, 0);
+    const double dt  = p->h;
+    const double rho = Ta > 0 ? exp(-dt / Ta) : 0;
+    const double w   = 2 * HELM_FREQ_PI * m / (FREQ_SAMPLES * dt);
+    double v = 0, a = 0, ar = 0, ai = 0, br = 0, bi = 0;
+    helm_approach(&c);
+    for (long k = 0; k < 8 * FREQ_SAMPLES; ++k) {
+        const double y = cos(w * dt * k);
+        v += helm_steady(&c, dt, 0, a, v, y);
+        a  = rho * a + (1 - rho) * v;     // Lagging actuator position
+        double in = a;
+        helm_delay_shift(&dl, &in);
+        const double out = helm_plant_advance(p, x, in);
+        if (k >= 7 * FREQ_SAMPLES) {      // Correlate whole periods only
+            ar += y   * cos(w * dt * k);
+            ai -= y   * sin(w * dt * k);
+            br += out * cos(w * dt * (k + 1));
+            bi -= out * sin(w * dt * (k + 1));
+        }
+    }
+    const double s = 1 / (ar*ar + ai*ai);
+    *re = (br*ar + bi*ai) * s;
+    *im = (bi*ar - br*ai) * s;
+}
+
+/**
+ * Check \ref helm_freq.h three ways.  Tabulated loop responses must match
+ * simulations of helm_steady() around the same helm_plant, including
+ * derivative action, dead time, and automatic reset through a lagging
+ * actuator.  Proportional loops around a first-order process and around a
+ * pure dead time must give closed-form phase and gain margins.  Every
+ * available kernel must agree with the scalar kernel bit for bit.
+ */
+static
+void
+check_freq(void)
+{
+    void * const mem = allocate(helm_freq_bytes(FREQ_N));
+    struct helm_freq g;
+    struct helm_plant p;
+    struct helm_state h;
+
+    // Loop responses versus simulation at whole cycles per window
+    const double dt = 0.05, a3[3] = { 1, 3, 3 }, b3[3] = { 1, 0, 0 };
+    CHECK(!helm_plant_init(&p, 3, a3, b3, dt, HELM_PLANT_ZOH));
+    tune(&h);
+    h.Tf = 0.1;
+    const int cycles[4] = { 3, 300, 30, 1000 };
+    for (int c = 0; c < 4; c += 2) {
+        const double w0 = 2 * HELM_FREQ_PI * cycles[c]   / (FREQ_SAMPLES*dt);
+        const double w1 = 2 * HELM_FREQ_PI * cycles[c+1] / (FREQ_SAMPLES*dt);
+        for (size_t delay = 0; delay <= 2; delay += 2) {
+            const double Ta = delay ? 0.3 : 0;
+            CHECK(!helm_freq_init(&g, 2, w0, w1, &p, delay, Ta, mem));
+            helm_freq_loop(&g, &h);
+            for (int i = 0; i < 2; ++i) {
+                double re, im;
+                freq_simulate(&p, &h, delay, Ta, cycles[c+i], &re, &im);
+                const double er = re + g.lr[i], ei = im + g.li[i];
+                CHECK(sqrt(er*er + ei*ei)
+                      <= 1e-6 * hypot(g.lr[i], g.li[i]));
+            }
+        }
+    }
+
+    // Proportional control makes L = K q / (1 - Phi q) with closed-form
+    // phase margin and a pure dead time L = K q^3 with closed-form gain
+    // margin at the phase crossover pi / (3 dt)
+    struct helm_freq_margins m;
+    const double Phi = 0.9, K = 0.5, a1[1] = { -log(Phi) / dt };
+    const double b1[1] = { K * a1[0] / (1 - Phi) };
+    CHECK(!helm_plant_init(&p, 1, a1, b1, dt, HELM_PLANT_ZOH));
+    helm_reset(&h);
+    CHECK(!helm_freq_init(&g, FREQ_N, 1e-2, HELM_FREQ_PI/dt, &p, 0, 0, mem));
+    helm_freq_analyze(&g, &h, &m);
+    const double theta = acos((1 + Phi*Phi - K*K) / (2*Phi));
+    const double pm = 180 - (theta + atan2(Phi*sin(theta),
+                                           1 - Phi*cos(theta)))
+                          * (180 / HELM_FREQ_PI);
+    CHECK(fabs(m.pm - pm) < 1e-2);
+    CHECK(fabs(m.wgc - theta / dt) < 1e-3 * theta / dt);
+
+    const double fast[1] = { 1000 }, gain[1] = { 1000 * K };
+    CHECK(!helm_plant_init(&p, 1, fast, gain, dt, HELM_PLANT_ZOH));
+    CHECK(!helm_freq_init(&g, FREQ_N, 1e-2, HELM_FREQ_PI/dt, &p, 2, 0, mem));
+    helm_freq_analyze(&g, &h, &m);
+    CHECK(fabs(m.gm - 1 / K) < 1e-4);
+    CHECK(fabs(m.wpc - HELM_FREQ_PI / (3*dt)) < 1e-3 * HELM_FREQ_PI / dt);
+    CHECK(isinf(m.pm));
+
+    // Every kernel reproduces the scalar kernel, including the tail
+    CHECK(!helm_plant_init(&p, 3, a3, b3, dt, HELM_PLANT_ZOH));
+    CHECK(!helm_freq_init(&g, FREQ_N - 3, 1e-2, 1e2, &p, 1, 0.3, mem));
+    tune(&h);
+    double c[HELM_FREQ_NCOEFF];
+    helm_freq_coeffs(&g, &h, c);
+    static double lr[FREQ_N], li[FREQ_N];
+    helm_freq_loop_scalar(&g, 0, g.n, c);
+    memcpy(lr, g.lr, g.n * sizeof(double));
+    memcpy(li, g.li, g.n * sizeof(double));
+    for (int kernel = AVX2; kernel <= AVX512; ++kernel) {
+        size_t i = 0;
+#if HELM_FREQ_X86
+        if (kernel == AVX2 && __builtin_cpu_supports("avx2")) {
+            i = helm_freq_loop_avx2(&g, 0, g.n, c);
+        }
+        if (kernel == AVX512 && __builtin_cpu_supports("avx512f")) {
+            i = helm_freq_loop_avx512(&g, 0, g.n, c);
+        }
+#endif
+        if (!i) {
+            printf("%-14s skipped %s\n", "freq", kernel_name[kernel]);
+            continue;
+        }
+        helm_freq_loop_scalar(&g, i, g.n, c);
+        CHECK(!memcmp(lr, g.lr, g.n * sizeof(double)));
+        CHECK(!memcmp(li, g.li, g.n * sizeof(double)));
+    }
+    free(mem);
+}
+
+/** Breakpoints along each axis within the gain check. */
+enum { GAIN_NX = 7, GAIN_NY = 4 };
+
+/**
+ * Schedule tuning as within \ref helm_gain.h, confirming that cached
+ * brackets give exactly the tuning found by a fresh cursor, including at
+ * breakpoints and beyond either end of 1-D and 2-D tables.  A variable
+ * clamped beyond an end must revalidate its cached edge bracket without
+ * searching, which poisoned interior breakpoints would otherwise reveal.
+ * Finally, tuning switching beneath a running loop must preserve \c y and
+ * \c f and produce no bump at equilibrium.
+ */
+static
+void
+check_gain(void)
+{
+    struct helm_gain g1, g2;
+    void * const m1 = allocate(helm_gain_bytes(GAIN_NX, 1));
+    void * const m2 = allocate(helm_gain_bytes(GAIN_NX, GAIN_NY));
+    helm_gain_init(&g1, GAIN_NX, 1, m1);
+    helm_gain_init(&g2, GAIN_NX, GAIN_NY, m2);
+    struct helm_state t;
+    tune(&t);
+    for (size_t i = 0; i < GAIN_NX; ++i) {
+        g1.x[i] = g2.x[i] = i * (i + 1.0);
+        for (size_t j = 0; j < GAIN_NY; ++j) {
+            g2.y[j] = 10.0 * j - 5;
+            t.kp = 1 + i + 0.5*j;
+            t.Td = 0.01 * (i + j);
+            t.Tf = 0.05 * (1 + j);
+            t.Ti = i == 3 ? INFINITY : 1.0 + i;
+            t.Tt = 2.0 + j;
+            helm_gain_set(&g2, i, j, &t);
+            if (!j) {
+                helm_gain_set(&g1, i, 0, &t);
+            }
+        }
+    }
+
+    // Tabulated points are reproduced exactly at breakpoints
+    struct helm_gain_cursor c, fresh;
+    struct helm_state h, k;
+    tune(&h);
+    helm_gain_cursor_init(&c);
+    for (size_t i = 0; i < GAIN_NX; ++i) {
+        CHECK(helm_gain_apply(&g1, &c, g1.x[i], 0, &h));
+        CHECK(h.kp == 1 + i && h.Td == 0.01 * i);
+        CHECK(i == 3 ? isinf(h.Ti) : h.Ti == 1.0 + i);
+    }
+
+    // Cached lookups match fresh ones across a walk leaving both ends
+    uint64_t z = 88172645463325252ull;
+    for (int n = 0; n < 100000; ++n) {
+        z ^= z << 13; z ^= z >> 7; z ^= z << 17;
+        const double unit = (z >> 11) * 0x1p-53;
+        const double sx = (z & 7) == 0 ? g1.x[(z >> 3) % GAIN_NX]
+                        : (z & 7) == 1 ? NAN
+                        : -10 + 70*unit;
+        const double sy = (z & 56) == 0 ? g2.y[(z >> 6) % GAIN_NY]
+                        : -20 + 50*unit*unit;
+        const double before = c.sx;
+        k = h;
+        const int wrote = helm_gain_apply(&g1, &c, sx, sy, &h);
+        CHECK(wrote == !(isnan(sx) || sx == before));
+        helm_gain_apply(&g1, helm_gain_cursor_init(&fresh), sx, sy, &k);
+        CHECK(same_tuning(&h, &k));
+        CHECK(c.ix <= GAIN_NX - 2);
+    }
+    helm_gain_cursor_init(&c);
+    for (int n = 0; n < 100000; ++n) {
+        z ^= z << 13; z ^= z >> 7; z ^= z << 17;
+        const double sx = -10 + 70 * ((z >> 11) * 0x1p-53);
+        const double sy = -20 + 50 * ((z & 0xffff) * 0x1p-16);
+        helm_gain_apply(&g2, &c, sx, sy, &h);
+        helm_gain_apply(&g2, helm_gain_cursor_init(&fresh), sx, sy, &k);
+        CHECK(same_tuning(&h, &k));
+        CHECK(c.ix <= GAIN_NX - 2 && c.iy <= GAIN_NY - 2);
+    }
+
+    // Beyond either end the edge points apply and edge brackets stick
+    static const double beyond[] = { -1e9, -1, 42, 43, 1e9, 1e300 };
+    for (size_t b = 0; b < sizeof(beyond)/sizeof(beyond[0]); ++b) {
+        const int high = beyond[b] > 0;
+        const size_t edge = high ? GAIN_NX - 1 : 0;
+        helm_gain_apply(&g1, helm_gain_cursor_init(&c), beyond[b], 0, &h);
+        CHECK(h.kp == 1 + edge && c.ix == (high ? GAIN_NX - 2 : 0));
+        double poisoned[GAIN_NX];
+        for (size_t i = 0; i < GAIN_NX; ++i) {
+            poisoned[i] = i == c.ix || i == c.ix + 1 ? g1.x[i] : NAN;
+        }
+        const size_t ix = c.ix;
+        const double w = helm_gain_bracket(poisoned, GAIN_NX,
+                                           beyond[b] * 2, &c.ix);
+        CHECK(c.ix == ix && w == high);
+    }
+
+    // Switching tuning preserves transient state and is bumpless at rest
+    tune(&h);
+    helm_gain_cursor_init(&c);
+    double u = 0, v = 0, y = 0;
+    for (int n = 0; n < 20000; ++n) {
+        const double r = (n / 2000) & 1 ? 2.0 : 0.5;
+        const double sx = 50 * (1 + sin(1e-3 * n)) - 5;
+        const double sy = 30 * cos(7e-4 * n);
+        const double hy = h.y, hf = h.f;
+        helm_gain_apply(&g2, &c, sx, sy, &h);
+        CHECK(!memcmp(&hy, &h.y, sizeof(hy)) && !memcmp(&hf, &h.f, sizeof(hf)));
+        v += helm_steady(&h, 1e-2, r, u, v, y);
+        u  = v;
+        y += 1e-2 * (u - y) / 0.2;
+        CHECK(isfinite(v));
+    }
+    h.y = h.f = y = 1;
+    u = v;
+    for (size_t i = 0; i < GAIN_NX; ++i) {
+        const double dv = helm_steady_scheduled(&h, &g2, &c, g2.x[i],
+                                                g2.y[i % GAIN_NY],
+                                                1e-2, y, u, v, y);
+        CHECK(dv == 0 && h.y == 1 && h.f == 1);
+    }
+    free(m2);
+    free(m1);
+}
+
+/** Samples fitted, true dead time, and most workers in the tune check. */
+enum { TUNE_SAMPLES = 2000, TUNE_DELAY = 3, TUNE_WORKERS = 3 };
+
+/**
+ * Check \ref helm_tune.h three ways.  Fitting noiseless data logged from a
+ * known ARX process with an offset must recover its coefficients and dead
+ * time.  The relay experiment on \f$1/(s+1)^3\f$ must find \f$K_u\f$ and
+ * \f$P_u\f$ near the analytic \f$8\f$ and \f$2\pi/\sqrt{3}\f$, allowing
+ * for the describing function approximation.  Tuning must not depend on
+ * the number of workers.
+ */
+static
+void
+check_tune(void)
+{
+    // Fit data logged from y_k + a1 y_{k-1} + a2 y_{k-2}
+    //                     = b1 u_{k-d-1} + b2 u_{k-d-2} + offset
+    static double u[TUNE_SAMPLES], y[TUNE_SAMPLES];
+    const double a[2] = { -1.5, 0.7 }, b[2] = { 0.5, 0.25 };
+    uint64_t seed = 5;
+    for (size_t k = 0; k < TUNE_SAMPLES; ++k) {
+        u[k] = uniform(&seed, 0, 1) < 0.5 ? -1 : 1;
+        y[k] = 0.3;
+        for (size_t j = 1; j <= 2 && j <= k; ++j) {
+            y[k] -= a[j-1] * y[k-j];
+        }
+        for (size_t j = 1; j <= 2 && j + TUNE_DELAY <= k; ++j) {
+            y[k] += b[j-1] * u[k-TUNE_DELAY-j];
+        }
+    }
+    struct helm_tune_model m;
+    double rms;
+    CHECK(!helm_tune_fit(&m, TUNE_SAMPLES, u, y, 0.1, 2, 2, 6, &rms));
+    CHECK(m.kind == HELM_TUNE_ARX && m.na == 2 && m.nb == 2);
+    CHECK(m.delay == TUNE_DELAY && m.dt == 0.1 && rms < 1e-9);
+    for (int j = 0; j < 2; ++j) {
+        CHECK(fabs(m.a[j] - a[j]) < 1e-9 && fabs(m.b[j] - b[j]) < 1e-9);
+    }
+
+    // Relay experiment versus the analytic ultimate gain and period
+    struct helm_plant p;
+    const double a3[3] = { 1, 3, 3 }, b3[3] = { 1, 0, 0 };
+    CHECK(!helm_plant_init(&p, 3, a3, b3, 0.01, HELM_PLANT_ZOH));
+    helm_tune_model_plant(&m, &p, 0);
+    double Ku, Pu;
+    CHECK(!helm_tune_relay(&m, 1, 0, &Ku, &Pu));
+    CHECK(fabs(Ku - 8) < 0.05 * 8);
+    CHECK(fabs(Pu - 2 * HELM_FREQ_PI / sqrt(3)) < 0.05 * Pu);
+
+    // Identical tunings regardless of the number of workers
+    CHECK(!helm_plant_init(&p, 3, a3, b3, 0.1, HELM_PLANT_ZOH));
+    helm_tune_model_plant(&m, &p, 2);
+    struct helm_tune_options o;
+    helm_tune_options_init(&o);
+    struct helm_tune_result r[TUNE_WORKERS];
+    for (unsigned w = 1; w <= TUNE_WORKERS; ++w) {
+        o.nworkers = w;
+        CHECK(!helm_tune(&m, &o, &r[w-1]));
+        CHECK(same_tuning(&r[w-1].tuned, &r[0].tuned));
+        CHECK(!memcmp(&r[w-1].cost, &r[0].cost, sizeof(r[0].cost)));
+        CHECK(!memcmp(&r[w-1].ms,   &r[0].ms,   sizeof(r[0].ms)));
+        CHECK(r[w-1].iters == r[0].iters);
+        CHECK(r[w-1].simulated  == r[0].simulated);
+        CHECK(r[w-1].rejected   == r[0].rejected);
+        CHECK(r[w-1].terminated == r[0].terminated);
+    }
+    CHECK(r[0].cost < r[0].seed_cost);
+}
+
+/** Lanes and client slots within the shm check's segment. */
+enum { SHM_LANES = 3, SHM_CLIENTS = 2 };
+
+/** Serve segment \c arg until helm_shm_stop(). */
+static
+void *
+shm_serve(void * const arg)
+{
+    helm_shm_serve(arg);
+    return NULL;
+}
+
+/**
+ * In a child process, attach to segment \c name, take one step, and die by
+ * \c SIGKILL while holding the slot.  Returns nonzero when the child died as
+ * intended.
+ */
+static
+int
+shm_killed(const char * const name)
+{
+    const pid_t pid = fork();
+    if (pid == 0) {
+        struct helm_shm * const s = helm_shm_open(name);
+        struct helm_shm_client * const c = s ? helm_shm_attach(s) : NULL;
+        double v;
+        if (!c || helm_shm_step(c, 1, 0.1, 1, 0, 0, &v)) {
+            _exit(EXIT_FAILURE);
+        }
+        kill(getpid(), SIGKILL);
+        _exit(EXIT_FAILURE);
+    }
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid
+        && WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+}
+
+/**
+ * Check \ref helm_shm.h against a server thread.  Steps round tripped
+ * through the rings must match helm_steady() bit for bit.  The slot of a
+ * client killed by \c SIGKILL must be reclaimed while another client keeps
+ * the server busy.  Once the server exits, a waiting client must fail with
+ * \c EPIPE rather than hang.
+ */
+static
+void
+check_shm(void)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "/helmcheck-%ld", (long) getpid());
+    struct helm_state h;
+    tune(&h);
+    struct helm_shm * const s
+        = helm_shm_create(name, SHM_LANES, SHM_CLIENTS, 4, &h);
+    CHECK(s);
+    if (!s) {
+        return;
+    }
+    pthread_t thread;
+    CHECK(!pthread_create(&thread, NULL, shm_serve, s));
+    struct helm_shm_client * const c = helm_shm_attach(s);
+    CHECK(c);
+
+    // Round trips match local steps exactly
+    struct helm_state l = h;
+    helm_approach(&l);
+    double v = 0;
+    for (int k = 0; c && k < 100; ++k) {
+        const double y = sin(0.1 * k);
+        const double e = v + helm_steady(&l, 0.1, 1, v, v, y);
+        CHECK(!helm_shm_step(c, 0, 0.1, 1, v, y, &v) && v == e);
+    }
+
+    // A killed client's slot is reclaimed even while the server is busy
+    CHECK(shm_killed(name));
+    struct helm_shm_client *d = NULL;
+    double w = 0;
+    const time_t deadline = time(NULL) + 5;
+    for (long k = 0; c && !d && time(NULL) < deadline; ++k) {
+        CHECK(!helm_shm_step(c, 2, 0.1, 0, w, 0, &w));
+        if (k % 64 == 0) {
+            d = helm_shm_attach(s);
+        }
+    }
+    CHECK(d);
+    helm_shm_detach(d);
+
+    // Clients fail with EPIPE once the server is gone
+    helm_shm_stop(s);
+    CHECK(!pthread_join(thread, NULL));
+    CHECK(!c || EPIPE == helm_shm_step(c, 0, 0.1, 1, v, 0, &v));
+    helm_shm_detach(c);
+    helm_shm_close(s);
+}
+
+/** Records within the trace check's ring, drained after every step. */
+enum { TRACE_CAPACITY = 4 };
+
+/**
+ * Replay one stream, including NaN dropouts and a retuning midway, through
+ * helm_steady_trace() and helm_steady() as within \ref helm_trace.h.
+ * Increments, transient state, and each pushed record's \c dv must agree
+ * bit for bit, and the four contributions must sum to \c dv closely.
+ */
+static
+void
+check_trace(void)
+{
+    struct helm_trace t;
+    struct helm_trace_record rec[TRACE_CAPACITY];
+    helm_trace_init(&t, TRACE_CAPACITY, rec);
+    struct helm_state a, b;
+    tune(&a);
+    tune(&b);
+    double v = 0, y = 0;
+    for (int n = 0; n < 20000; ++n) {
+        if (n == 10000) {
+            a.kp = b.kp = 0.5;
+            a.Tt = b.Tt = INFINITY;
+        }
+        const double r  = (n / 1000) & 1 ? 1 : -1;
+        const double yn = n % 23 == 7 ? NAN : y;
+        const double u  = fmin(fmax(v, -1.5), 1.5);
+        const double dv    = helm_steady_trace(&a, &t, 1e-2, r, u, v, yn);
+        const double plain = helm_steady(&b, 1e-2, r, u, v, yn);
+        CHECK(!memcmp(&dv, &plain, sizeof(dv)));
+        CHECK(!memcmp(&a.y, &b.y, sizeof(a.y)));
+        CHECK(!memcmp(&a.f, &b.f, sizeof(a.f)));
+        struct helm_trace_record out;
+        CHECK(helm_trace_pop(&t, &out, 1) == 1);
+        CHECK(!memcmp(&out.dv, &dv, sizeof(dv)));
+        CHECK(isnan(yn) ? isnan(out.dy)
+                        : fabs(out.I + out.R + out.D + out.P - dv)
+                              <= 1e-12 * (1 + fabs(dv)));
+        v += dv;
+        y += 1e-2 * (u - y) / 0.1;
+    }
+    CHECK(helm_trace_dropped(&t) == 0);
+}
+
+/** Every check in reporting order. */
+static const struct
+{
+    const char *name;        ///< Name used for selection
+    void      (*fn)(void);   ///< Check implementation
+} checks[] = {
+    { "bank",     check_bank     },
+    { "cascade",  check_cascade  },
+    { "ckpt",     check_ckpt     },
+    { "compiled", check_compiled },
+    { "fixed",    check_fixed    },
+    { "freq",     check_freq     },
+    { "gain",     check_gain     },
+    { "plant",    check_plant    },
+    { "retune",   check_retune   },
+    { "series",   check_series   },
+    { "shm",      check_shm      },
+    { "sparse",   check_sparse   },
+    { "trace",    check_trace    },
+    { "tune",     check_tune     },
+};
+
+int
+main(int argc, char *argv[])
+{
+    int failed = 0;
+    for (size_t c = 0; c < sizeof(checks)/sizeof(checks[0]); ++c) {
+        int selected = argc < 2;
+        for (int a = 1; a < argc; ++a) {
+            selected |= !strncmp(checks[c].name, argv[a], strlen(argv[a]));
+        }
+        if (!selected) {
+            continue;
+        }
+        failures = 0;
+        checks[c].fn();
+        printf("%-14s %s\n", checks[c].name, failures ? "FAILED" : "ok");
+        fflush(stdout);
+        failed |= failures > 0;
+    }
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
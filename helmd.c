@@ -0,0 +1,141 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Daemon serving a bank of controllers to local processes through the
+ * shared-memory rings of \ref helm_shm.h.
+ *
+ * Every lane starts from the same tuning, which clients may later change
+ * per lane.  The daemon serves on its main thread until interrupted or
+ * terminated, whereupon the segment is unlinked.  See \ref helmload.c for
+ * a matching load generator.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "helm.h"
+#include "helm_shm.h"
+
+static const char     default_name[]   = "/helm"; ///< Default segment name
+static const size_t   default_lanes    = 1024;    ///< Default lanes served
+static const unsigned default_clients  = 16;      ///< Default client slots
+static const unsigned default_capacity = 64;      ///< Default ring entries
+static const double   default_kp       = 1;       ///< Default unified gain
+
+/** Segment being served, for #on_signal. */
+static struct helm_shm *served;
+
+/** Ask the server to stop upon SIGINT or SIGTERM. */
+static
+void
+on_signal(int signum)
+{
+    (void) signum;
+    helm_shm_stop(served);
+}
+
+/** Print usage on the given stream. */
+static
+void
+print_usage(const char *arg0, FILE *out)
+{
+    fprintf(out, "Usage: %s [OPTION...]\n", arg0);
+    fprintf(out, "Serve a bank of controllers through shared memory.\n");
+    fputc('\n', out);
+    fprintf(out, "Service:\n");
+    fprintf(out, "  -s name\tSegment name     (default %s)\n", default_name);
+    fprintf(out, "  -n N\t\tLanes served      (default %zu)\n", default_lanes);
+    fprintf(out, "  -c N\t\tClient slots      (default %u)\n",
+                    default_clients);
+    fprintf(out, "  -q N\t\tEntries per ring  (default %u)\n",
+                    default_capacity);
+    fputc('\n', out);
+    fprintf(out, "Initial tuning of every lane per struct helm_state:\n");
+    fprintf(out, "  -p kp\t\tUnified gain     (default %g)\n", default_kp);
+    fprintf(out, "  -d Td\t\tDerivative time  (default 0)\n");
+    fprintf(out, "  -f Tf\t\tFilter time      (default inf)\n");
+    fprintf(out, "  -i Ti\t\tIntegral time    (default inf)\n");
+    fprintf(out, "  -t Tt\t\tReset time       (default inf)\n");
+    fputc('\n', out);
+    fprintf(out, "Miscellaneous:\n");
+    fprintf(out, "  -h\t\tDisplay this help and exit\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *name     = default_name;
+    long        lanes    = (long) default_lanes;
+    long        clients  = default_clients;
+    long        capacity = default_capacity;
+    struct helm_state h;
+    helm_reset(&h);
+    h.kp = default_kp;
+
+    // Process incoming arguments
+    for (int opt; -1 != (opt = getopt(argc, argv, "c:d:f:i:n:p:q:s:t:h"));) {
+        switch (opt) {
+        case 'c': clients  = atol(optarg); break;
+        case 'd': h.Td     = atof(optarg); break;
+        case 'f': h.Tf     = atof(optarg); break;
+        case 'i': h.Ti     = atof(optarg); break;
+        case 'n': lanes    = atol(optarg); break;
+        case 'p': h.kp     = atof(optarg); break;
+        case 'q': capacity = atol(optarg); break;
+        case 's': name     = optarg;       break;
+        case 't': h.Tt     = atof(optarg); break;
+        case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
+        default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc) {
+        print_usage(argv[0], stderr);
+        return EXIT_FAILURE;
+    }
+    if (lanes < 1 || lanes > UINT32_MAX || clients < 1 || clients > 65536
+            || capacity < 1 || capacity > (1L << 20)) {
+        fprintf(stderr, "Lanes, clients, and capacity must be positive and "
+                        "reasonably sized\n");
+        return EXIT_FAILURE;
+    }
+    if (!(h.Td >= 0 && h.Tf > 0 && h.Ti > 0 && h.Tt > 0)) {
+        fprintf(stderr, "Time scales must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    // Create the segment and serve until signaled
+    served = helm_shm_create(name, (size_t) lanes, (unsigned) clients,
+                             (unsigned) capacity, &h);
+    if (!served) {
+        fprintf(stderr, "Unable to create %s: %s\n", name, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = on_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT,  &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    const int err = helm_shm_serve(served);
+    helm_shm_close(served);
+    if (err) {
+        fprintf(stderr, "Serving %s failed: %s\n", name, strerror(err));
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
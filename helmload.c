@@ -0,0 +1,273 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Load generator measuring round-trip latency and throughput against a
+ * running \ref helmd.c.
+ *
+ * Each thread attaches its own client and steps its own lanes, each lane
+ * closing the loop around a first-order process.  Up to a given depth of
+ * requests is kept in flight per client.  Every request's round trip, from
+ * just before helm_shm_send() until its reply is received, is timed.  The
+ * distribution across all threads and the aggregate throughput are output.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helm_shm.h"
+
+static const char   default_name[]  = "/helm"; ///< Default segment name
+static const long   default_threads = 1;       ///< Default client threads
+static const double default_count   = 1e6;     ///< Default requests each
+static const long   default_lanes   = 1;       ///< Default lanes each
+static const long   default_depth   = 1;       ///< Default requests in flight
+static const double default_dt      = 1e-3;    ///< Time step of each lane
+
+/** Work and results of one client thread. */
+struct client
+{
+    pthread_t        thread;  ///< Running this client
+    struct helm_shm *s;       ///< Shared mapping
+    size_t           first;   ///< First lane stepped
+    size_t           lanes;   ///< Number of lanes stepped
+    size_t           count;   ///< Requests to issue
+    size_t           depth;   ///< Maximum requests in flight
+    double          *y;       ///< Process output per lane
+    double          *v;       ///< Latest request per lane
+    uint64_t        *sent;    ///< Send time of each request in flight
+    uint64_t        *ns;      ///< Round trip of each request
+    int              err;     ///< Zero on success or an errno value
+};
+
+/** Monotonic nanoseconds. */
+static
+uint64_t
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * UINT64_C(1000000000) + (uint64_t) ts.tv_nsec;
+}
+
+/** Issue every request of one client, keeping up to its depth in flight. */
+static
+void *
+run(void *arg)
+{
+    struct client * const c = arg;
+    struct helm_shm_client * const k = helm_shm_attach(c->s);
+    if (!k) {
+        c->err = errno;
+        return NULL;
+    }
+    size_t issued = 0, done = 0;
+    while (done < c->count) {
+        // Send while permitted, each request to the next lane in turn
+        while (issued < c->count && issued - done < c->depth) {
+            const size_t i = issued % c->lanes;
+            struct helm_shm_request q;
+            q.op          = HELM_SHM_STEP;
+            q.lane        = (uint32_t) (c->first + i);
+            q.arg.step.dt = default_dt;
+            q.arg.step.r  = 1;
+            q.arg.step.u  = c->v[i];
+            q.arg.step.y  = c->y[i];
+            const uint64_t t = now();
+            if (helm_shm_send(k, &q)) {
+                break;                      // Ring full so receive first
+            }
+            c->sent[issued % c->depth] = t;
+            ++issued;
+        }
+
+        // Receive the oldest reply, advancing its lane's process
+        struct helm_shm_reply p;
+        if ((c->err = helm_shm_recv(k, &p, 1))) {
+            break;
+        }
+        c->ns[done] = now() - c->sent[done % c->depth];
+        if ((c->err = p.status)) {
+            break;
+        }
+        const size_t i = p.lane - c->first;
+        c->v[i]  = p.v;
+        c->y[i] += default_dt * (p.v - c->y[i]);
+        ++done;
+    }
+    helm_shm_detach(k);
+    return NULL;
+}
+
+/** Ascending comparison for qsort. */
+static
+int
+ascending(const void *a, const void *b)
+{
+    const uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+/** Print usage on the given stream. */
+static
+void
+print_usage(const char *arg0, FILE *out)
+{
+    fprintf(out, "Usage: %s [OPTION...]\n", arg0);
+    fprintf(out, "Measure round trips against a running helmd.\n");
+    fputc('\n', out);
+    fprintf(out, "  -s name\tSegment name           (default %s)\n",
+                    default_name);
+    fprintf(out, "  -c N\t\tClient threads         (default %ld)\n",
+                    default_threads);
+    fprintf(out, "  -n N\t\tRequests per client    (default %g)\n",
+                    default_count);
+    fprintf(out, "  -l N\t\tLanes per client       (default %ld)\n",
+                    default_lanes);
+    fprintf(out, "  -d N\t\tRequests in flight     (default %ld)\n",
+                    default_depth);
+    fprintf(out, "  -h\t\tDisplay this help and exit\n");
+    fputc('\n', out);
+    fprintf(out, "Output is the round-trip latency distribution in "
+                    "nanoseconds followed by\nthe aggregate throughput in "
+                    "requests per second.\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *name    = default_name;
+    long        threads = default_threads;
+    double      count   = default_count;
+    long        lanes   = default_lanes;
+    long        depth   = default_depth;
+
+    // Process incoming arguments
+    for (int opt; -1 != (opt = getopt(argc, argv, "c:d:l:n:s:h"));) {
+        switch (opt) {
+        case 'c': threads = atol(optarg); break;
+        case 'd': depth   = atol(optarg); break;
+        case 'l': lanes   = atol(optarg); break;
+        case 'n': count   = atof(optarg); break;
+        case 's': name    = optarg;       break;
+        case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
+        default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc) {
+        print_usage(argv[0], stderr);
+        return EXIT_FAILURE;
+    }
+    if (threads < 1 || lanes < 1 || depth < 1 || !(count >= 1 && count < 1e12)) {
+        fprintf(stderr, "Threads, requests, lanes, and depth must be "
+                        "positive\n");
+        return EXIT_FAILURE;
+    }
+
+    // Map the segment and allocate per-client state
+    struct helm_shm * const s = helm_shm_open(name);
+    if (!s) {
+        fprintf(stderr, "Unable to open %s: %s\n", name, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if ((size_t) threads * (size_t) lanes > helm_shm_lanes(s)) {
+        fprintf(stderr, "Requested %ld lanes but %s serves only %zu\n",
+                threads * lanes, name, helm_shm_lanes(s));
+        helm_shm_close(s);
+        return EXIT_FAILURE;
+    }
+    const size_t n = (size_t) count;
+    struct client * const c = calloc((size_t) threads, sizeof(*c));
+    uint64_t * const ns = malloc((size_t) threads * n * sizeof(*ns));
+    int status = EXIT_FAILURE;
+    if (!c || !ns) {
+        fprintf(stderr, "Unable to allocate %zu samples\n",
+                (size_t) threads * n);
+        goto done;
+    }
+    for (long t = 0; t < threads; ++t) {
+        c[t].s     = s;
+        c[t].first = (size_t) (t * lanes);
+        c[t].lanes = (size_t) lanes;
+        c[t].count = n;
+        c[t].depth = (size_t) depth;
+        c[t].y     = calloc((size_t) lanes, sizeof(double));
+        c[t].v     = calloc((size_t) lanes, sizeof(double));
+        c[t].sent  = calloc((size_t) depth, sizeof(uint64_t));
+        c[t].ns    = ns + (size_t) t * n;
+        if (!c[t].y || !c[t].v || !c[t].sent) {
+            fprintf(stderr, "Unable to allocate client state\n");
+            goto done;
+        }
+    }
+
+    // Run every client concurrently
+    const uint64_t begin = now();
+    long started = 0;
+    for (; started < threads; ++started) {
+        if ((errno = pthread_create(&c[started].thread, NULL, run,
+                                    &c[started]))) {
+            fprintf(stderr, "Unable to start thread: %s\n", strerror(errno));
+            break;
+        }
+    }
+    int err = 0;
+    for (long t = 0; t < started; ++t) {
+        pthread_join(c[t].thread, NULL);
+        if (c[t].err && !err) {
+            err = c[t].err;
+        }
+    }
+    const double elapsed = (now() - begin) * 1e-9;
+    if (started < threads) {
+        goto done;
+    }
+    if (err) {
+        fprintf(stderr, "Client failed: %s\n", strerror(err));
+        goto done;
+    }
+
+    // Summarize latency and throughput
+    const size_t total = (size_t) threads * n;
+    qsort(ns, total, sizeof(*ns), ascending);
+    static const double p[] = { 0.50, 0.90, 0.99, 0.999, 0.9999 };
+    printf("%-12s %12zu\n", "requests", total);
+    printf("%-12s %12" PRIu64 "\n", "min", ns[0]);
+    for (size_t j = 0; j < sizeof(p)/sizeof(p[0]); ++j) {
+        char label[16];
+        snprintf(label, sizeof(label), "p%g", 100*p[j]);
+        printf("%-12s %12" PRIu64 "\n", label,
+               ns[(size_t) (p[j] * (double) (total - 1))]);
+    }
+    printf("%-12s %12" PRIu64 "\n", "max", ns[total - 1]);
+    printf("%-12s %12.0f\n", "per_second", (double) total / elapsed);
+    status = EXIT_SUCCESS;
+
+done:
+    if (c) {
+        for (long t = 0; t < threads; ++t) {
+            free(c[t].y);
+            free(c[t].v);
+            free(c[t].sent);
+        }
+    }
+    free(c);
+    free(ns);
+    helm_shm_close(s);
+    return status;
+}
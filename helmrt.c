@@ -0,0 +1,233 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Drives \ref helm_rt.h with several groups at different periods and
+ * reports helm_rt_stats() for each.
+ *
+ * Every lane closes the loop around a first-order process whose time
+ * constant is twenty periods of its group, tracking a reference that
+ * alternates sign every second through an actuator saturating at unity.
+ * Each group's callback additionally records the measured \c dt it receives
+ * so that the true sampling interval may be compared against the period.
+ * The exit status is nonzero when any group never stepped or when the
+ * scheduler could not be started.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helm_rt.h"
+
+static const char  *default_periods = "1000,5000,20000";  ///< Microseconds
+static const long   default_lanes   = 1000;  ///< Lanes within each group
+static const double default_seconds = 2;     ///< Running time
+enum { MAX_GROUPS = 16 };                    ///< Most groups accepted
+
+/** Process model and measured timing for one group. */
+struct plant
+{
+    double tau;     ///< Process time constant in seconds
+    double dtsum;   ///< Sum of measured time steps
+    double dtmin;   ///< Smallest measured time step
+    double dtmax;   ///< Largest measured time step
+    long   calls;   ///< Time steps measured
+    double error;   ///< Sum of absolute tracking error across lanes
+};
+
+/** Group callback advancing each process then applying each request. */
+static
+void
+callback(void * const ctx,
+         const enum helm_rt_phase phase,
+         struct helm_rt_io * const io)
+{
+    struct plant * const p = ctx;
+    if (phase == HELM_RT_SENSE) {
+        p->dtsum += io->dt;
+        p->dtmin  = fmin(p->dtmin, io->dt);
+        p->dtmax  = fmax(p->dtmax, io->dt);
+        p->calls += 1;
+        const double r = fmod(io->t, 2) < 1 ? 0.5 : -0.5;
+        for (size_t k = 0; k < io->n; ++k) {
+            io->r[k]  = r;
+            io->y[k] += io->dt * (io->u[k] - io->y[k]) / p->tau;
+            p->error += fabs(r - io->y[k]);
+        }
+    } else {
+        for (size_t k = 0; k < io->n; ++k) {
+            io->v[k] += io->dv[k];
+            io->u[k]  = fmin(fmax(io->v[k], -1), 1);
+        }
+    }
+}
+
+/** Upper bound in microseconds of the log2 bucket reaching quantile \c q. */
+static
+double
+lateness(const struct helm_rt_stats * const s,
+         const double q)
+{
+    uint64_t total = 0, seen = 0;
+    for (int b = 0; b < HELM_RT_BUCKETS; ++b) {
+        total += s->late[b];
+    }
+    int b = 0;
+    for (; b < HELM_RT_BUCKETS - 1; ++b) {
+        if ((seen += s->late[b]) >= ceil(q * total)) {
+            break;
+        }
+    }
+    return total ? 1e-3 * ldexp(1, b + 1) : 0;
+}
+
+/** Print usage on the given stream. */
+static
+void
+print_usage(const char *arg0, FILE *out)
+{
+    fprintf(out, "Usage: %s [OPTION...]\n", arg0);
+    fprintf(out, "Schedule controller groups by helm_rt and report their "
+                    "timing.\n");
+    fputc('\n', out);
+    fprintf(out, "  -p LIST\tComma-separated group periods in microseconds "
+                    "(default %s)\n", default_periods);
+    fprintf(out, "  -n N\t\tLanes within each group (default %ld)\n",
+                    default_lanes);
+    fprintf(out, "  -j N\t\tThreads or zero for one per CPU (default 0)\n");
+    fprintf(out, "  -s SEC\tSeconds to run (default %g)\n", default_seconds);
+    fprintf(out, "  -h\t\tDisplay this help and exit\n");
+    fputc('\n', out);
+    fprintf(out, "Each row reports a group's period, steps taken versus "
+                    "expected, deadline misses,\nthe mean, least, and "
+                    "greatest measured dt, the median, 99th percentile, and"
+                    "\nmaximum wakeup lateness bounded above by log2 bucket, "
+                    "and the mean absolute\ntracking error, with times in "
+                    "microseconds.\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *periods = default_periods;
+    long        lanes   = default_lanes;
+    long        threads = 0;
+    double      seconds = default_seconds;
+
+    // Process incoming arguments
+    for (int opt; -1 != (opt = getopt(argc, argv, "p:n:j:s:h"));) {
+        switch (opt) {
+        case 'p': periods = optarg;       break;
+        case 'n': lanes   = atol(optarg); break;
+        case 'j': threads = atol(optarg); break;
+        case 's': seconds = atof(optarg); break;
+        case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
+        default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc || lanes < 1 || threads < 0 || !(seconds > 0)) {
+        print_usage(argv[0], stderr);
+        return EXIT_FAILURE;
+    }
+
+    // Parse periods, one group apiece
+    long period[MAX_GROUPS];
+    int  ngroups = 0;
+    for (const char *s = periods; *s;) {
+        char *end;
+        const double us = strtod(s, &end);
+        if (end == s || !(us >= 1) || ngroups == MAX_GROUPS
+                || (*end && *end != ',')) {
+            fprintf(stderr, "Periods must be at most %d values of at least "
+                            "one microsecond\n", MAX_GROUPS);
+            return EXIT_FAILURE;
+        }
+        period[ngroups++] = (long) (1e3 * us);
+        s = *end ? end + 1 : end;
+    }
+
+    // Build groups of identically tuned PI controllers
+    struct helm_rt * const rt = helm_rt_create((unsigned) threads, NULL);
+    if (!rt) {
+        fprintf(stderr, "Unable to create scheduler\n");
+        return EXIT_FAILURE;
+    }
+    static struct plant plant[MAX_GROUPS];
+    int group[MAX_GROUPS];
+    for (int i = 0; i < ngroups; ++i) {
+        plant[i].tau   = 20e-9 * period[i];
+        plant[i].dtmin = INFINITY;
+        plant[i].dtmax = 0;
+        group[i] = helm_rt_group(rt, period[i], callback, &plant[i]);
+        struct helm_state h;
+        helm_reset(&h);
+        h.kp = 1;
+        h.Ti = plant[i].tau;
+        h.Tt = plant[i].tau;
+        helm_approach(&h);
+        for (long k = 0; group[i] >= 0 && k < lanes; ++k) {
+            if (helm_rt_add(rt, group[i], &h) < 0) {
+                group[i] = -1;
+            }
+        }
+        if (group[i] < 0) {
+            fprintf(stderr, "Unable to add group %d\n", i);
+            helm_rt_destroy(rt);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Run for the requested duration
+    const int err = helm_rt_start(rt);
+    if (err) {
+        fprintf(stderr, "Unable to start: %s\n", strerror(err));
+        helm_rt_destroy(rt);
+        return EXIT_FAILURE;
+    }
+    struct timespec ts;
+    ts.tv_sec  = (time_t) seconds;
+    ts.tv_nsec = (long) (1e9 * (seconds - (double) ts.tv_sec));
+    while (nanosleep(&ts, &ts) && errno == EINTR) {
+        // Resume after any signal
+    }
+    helm_rt_stop(rt);
+
+    printf("%-10s %8s %8s %7s %9s %9s %9s %9s %9s %9s %9s\n",
+           "period", "steps", "expect", "misses", "dt_mean", "dt_min",
+           "dt_max", "late_p50", "late_p99", "late_max", "mean|e|");
+    int status = EXIT_SUCCESS;
+    for (int i = 0; i < ngroups; ++i) {
+        struct helm_rt_stats s;
+        if (helm_rt_stats(rt, group[i], &s)) {
+            abort();  // Every group was validated upon creation
+        }
+        const struct plant * const p = &plant[i];
+        printf("%-10.6g %8llu %8.0f %7llu %9.6g %9.6g %9.6g %9.4g %9.4g "
+               "%9.4g %9.3g\n", 1e-3 * period[i],
+               (unsigned long long) s.steps, 1e9 * seconds / period[i],
+               (unsigned long long) s.misses,
+               p->calls ? 1e6 * p->dtsum / p->calls : NAN,
+               1e6 * p->dtmin, 1e6 * p->dtmax,
+               lateness(&s, 0.5), lateness(&s, 0.99), lateness(&s, 1),
+               p->error / ((double) lanes * (p->calls ? p->calls : 1)));
+        if (!s.steps || s.steps != (uint64_t) p->calls) {
+            status = EXIT_FAILURE;
+        }
+    }
+    helm_rt_destroy(rt);
+    return status;
+}
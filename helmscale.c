@@ -0,0 +1,180 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Scaling benchmark for \ref helm_par.h reporting steps per second from one
+ * worker up to one worker per available CPU.
+ *
+ * Every lane closes the loop around a first-order process.  A leading
+ * fraction of lanes tracks a sinusoidal reference while the remainder sit
+ * at setpoint, so that sparse stepping concentrates work upon the first
+ * shards and exercises rebalancing.  Only time spent within
+ * helm_par_steady() is measured, excluding the serial process updates.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "helm_par.h"
+
+static const double default_lanes  = 1 << 20;  ///< Default lanes
+static const long   default_steps  = 200;      ///< Default timed steps
+static const double default_band   = -1;       ///< Default is dense
+static const double default_active = 1;        ///< Default tracking fraction
+static const double default_dt     = 1e-3;     ///< Time step of each lane
+static const long   warmup         = 16;       ///< Untimed steps first
+
+/** Monotonic seconds. */
+static
+double
+now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+/** Print usage on the given stream. */
+static
+void
+print_usage(const char *arg0, FILE *out)
+{
+    fprintf(out, "Usage: %s [OPTION...]\n", arg0);
+    fprintf(out, "Measure helm_par steps per second across worker "
+                    "counts.\n");
+    fputc('\n', out);
+    fprintf(out, "  -n N\t\tLanes                  (default %g)\n",
+                    default_lanes);
+    fprintf(out, "  -s N\t\tTimed steps per row    (default %ld)\n",
+                    default_steps);
+    fprintf(out, "  -j N\t\tMost workers           (default %ld)\n",
+                    sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "  -b band\tSparse deadband or negative for dense "
+                    "(default %g)\n", default_band);
+    fprintf(out, "  -a frac\tFraction of lanes tracking a moving "
+                    "reference (default %g)\n", default_active);
+    fprintf(out, "  -h\t\tDisplay this help and exit\n");
+    fputc('\n', out);
+    fprintf(out, "Rows double the workers from one until all are used, "
+                    "reporting phases and\nlane steps per second, speedup "
+                    "and efficiency against one worker, the final\nload "
+                    "skew, and the rebalances and shard migrations "
+                    "performed.\n");
+}
+
+int
+main(int argc, char *argv[])
+{
+    double count  = default_lanes;
+    long   steps  = default_steps;
+    long   most   = sysconf(_SC_NPROCESSORS_ONLN);
+    double band   = default_band;
+    double active = default_active;
+
+    // Process incoming arguments
+    for (int opt; -1 != (opt = getopt(argc, argv, "a:b:j:n:s:h"));) {
+        switch (opt) {
+        case 'a': active = atof(optarg); break;
+        case 'b': band   = atof(optarg); break;
+        case 'j': most   = atol(optarg); break;
+        case 'n': count  = atof(optarg); break;
+        case 's': steps  = atol(optarg); break;
+        case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
+        default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc) {
+        print_usage(argv[0], stderr);
+        return EXIT_FAILURE;
+    }
+    if (!(count >= 1 && count < 1e12) || steps < 1 || most < 1
+            || !(active >= 0 && active <= 1) || isnan(band)) {
+        fprintf(stderr, "Lanes, steps, and workers must be positive with "
+                        "fraction within [0, 1]\n");
+        return EXIT_FAILURE;
+    }
+
+    // Allocate aligned inputs and outputs
+    const size_t n = (size_t) count, moving = (size_t) (active * n);
+    double *mem = NULL;
+    if (posix_memalign((void **) &mem, 64, 4 * n * sizeof(double))) {
+        fprintf(stderr, "Unable to allocate %zu lanes\n", n);
+        return EXIT_FAILURE;
+    }
+    double * const r  = mem + 0*n;
+    double * const u  = mem + 1*n;
+    double * const y  = mem + 2*n;
+    double * const dv = mem + 3*n;
+    struct helm_state h;
+    helm_reset(&h);
+    h.kp = 2;
+    h.Ti = 0.05;
+
+    printf("%-8s %12s %14s %8s %8s %6s %6s %8s\n", "threads", "steps/s",
+           "lanes/s", "speedup", "effic", "skew", "rebal", "migrate");
+    double base = 0;
+    for (long k = 1;; k = 2*k < most ? 2*k : most) {
+        struct helm_par * const p = helm_par_create(n, (unsigned) k,
+                                                    NULL, band);
+        if (!p) {
+            fprintf(stderr, "Unable to create %ld workers\n", k);
+            free(mem);
+            return EXIT_FAILURE;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            helm_par_set(p, i, &h);
+            r[i] = u[i] = y[i] = 0;
+        }
+        helm_par_approach(p);
+
+        // Step, timing only helm_par_steady(), then advance each process
+        double elapsed = 0;
+        for (long s = 0; s < warmup + steps; ++s) {
+            const double t0 = now();
+            helm_par_steady(p, default_dt, r, u, u, y, dv);
+            if (s >= warmup) {
+                elapsed += now() - t0;
+            }
+            const double ref = sin(2 * 3.14159265358979323846 * s / 50.0);
+            for (size_t i = 0; i < moving; ++i) {
+                r[i]  = ref;
+                u[i] += dv[i];
+                y[i] += default_dt * (u[i] - y[i]) / 0.01;
+            }
+            for (size_t i = moving; i < n; ++i) {
+                u[i] += dv[i];  // Remains at setpoint once settled
+            }
+        }
+
+        struct helm_par_stats st;
+        helm_par_stats(p, &st);
+        helm_par_destroy(p);
+        const double rate = steps / elapsed;
+        if (k == 1) {
+            base = rate;
+        }
+        printf("%-8ld %12.1f %14.4g %8.2f %8.2f %6.2f %6llu %8llu\n",
+               k, rate, rate * n, rate / base, rate / base / k, st.skew,
+               (unsigned long long) st.rebalances,
+               (unsigned long long) st.migrations);
+        fflush(stdout);
+        if (k == most) {
+            break;
+        }
+    }
+    free(mem);
+    return EXIT_SUCCESS;
+}
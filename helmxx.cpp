@@ -0,0 +1,135 @@
+//--------------------------------------------------------------------------
+//
+// Copyright (C) 2026 Rhys Ulerich
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+//
+//--------------------------------------------------------------------------
+
+/** \file
+ * Compiles \ref helm.hpp and confirms that helm::controller::steady()
+ * matches helm_steady() and helm_steadyf() for every helm::Terms.
+ *
+ * Each specialization and its helm_state equivalent replay one stream of
+ * observations, including NaN dropouts, while tracking a moving reference
+ * through a saturating actuator.  Increments must agree exactly, treating
+ * zeros of either sign as equal.  Conversion in both directions between
+ * controllers and both helm_state and helm_statef is also exercised,
+ * including that converting a helm_state resets parameters of disabled
+ * terms.  The exit status is nonzero upon any mismatch.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include "helm.hpp"
+
+namespace {
+
+/** Samples replayed per case. */
+const int samples = 4096;
+
+/** Overload resolving helm_steady() or helm_steadyf() by state type. */
+inline double
+steady(helm_state& h, double dt, double r, double u, double v, double y)
+{
+    return helm_steady(&h, dt, r, u, v, y);
+}
+
+/** Overload resolving helm_steady() or helm_steadyf() by state type. */
+inline float
+steady(helm_statef& h, float dt, float r, float u, float v, float y)
+{
+    return helm_steadyf(&h, dt, r, u, v, y);
+}
+
+/** Conversion to helm_state or helm_statef by state type. */
+template <typename Controller>
+void
+convert(const Controller& c, helm_state& h)
+{
+    h = c.state();
+}
+
+/** Conversion to helm_state or helm_statef by state type. */
+template <typename Controller>
+void
+convert(const Controller& c, helm_statef& h)
+{
+    h = c.statef();
+}
+
+/**
+ * Replay one stream through \c controller<terms,Real> and its \c State
+ * equivalent.
+ * \return Number of mismatched increments.
+ */
+template <helm::Terms terms, typename Real, typename State>
+int
+compare(const char *name)
+{
+    typedef helm::controller<terms, Real> controller;
+    controller c(2, Real(0.25), Real(0.025), Real(1.5), Real(1.5));
+    c.approach();
+
+    State h;
+    convert(c, h);
+    const controller round(h);               // Converting constructor
+    int mismatches = !(round.kp == c.kp && round.Td == c.Td
+                       && round.Tf == c.Tf && round.Ti == c.Ti
+                       && round.Tt == c.Tt);
+
+    State full = h;                          // Every term enabled
+    full.Td = 0.25;
+    full.Ti = 1.5;
+    full.Tt = 1.5;
+    const controller pruned(full);           // Disabled terms normalized
+    mismatches += !(pruned.Td == c.Td && pruned.Ti == c.Ti
+                    && pruned.Tt == c.Tt);
+
+    const Real dt = Real(0.01);
+    Real uc = 0, vc = 0, yc = 0, uh = 0, vh = 0, yh = 0;
+    for (int i = 0; i < samples; ++i) {
+        const Real r    = (i / 512) & 1 ? 1 : Real(-0.5);
+        const bool drop = i % 37 == 5;
+        const Real dvc  = c.steady(dt, r, uc, vc, drop ? NAN : yc);
+        const Real dvh  = steady(h, dt, r, uh, vh, drop ? NAN : yh);
+        if (!(dvc == dvh)) {
+            if (!mismatches++) {
+                std::printf("%s: sample %d gave %.17g versus %.17g\n",
+                            name, i, double(dvc), double(dvh));
+            }
+        }
+        vc += dvc;  uc = vc > 1 ? 1 : vc < -1 ? -1 : vc;
+        vh += dvh;  uh = vh > 1 ? 1 : vh < -1 ? -1 : vh;
+        yc += dt * (uc - yc) / Real(0.2);
+        yh += dt * (uh - yh) / Real(0.2);
+    }
+    std::printf("%-12s %s\n", name, mismatches ? "MISMATCH" : "ok");
+    return mismatches;
+}
+
+} // namespace
+
+int
+main()
+{
+    using helm::Terms;
+    int failures = 0;
+    failures += compare<Terms::P,    double, helm_state >("P");
+    failures += compare<Terms::PI,   double, helm_state >("PI");
+    failures += compare<Terms::PD,   double, helm_state >("PD");
+    failures += compare<Terms::PID,  double, helm_state >("PID");
+    failures += compare<Terms::PIT,  double, helm_state >("PIT");
+    failures += compare<Terms::PIDT, double, helm_state >("PIDT");
+    failures += compare<Terms::P,    float,  helm_statef>("P float");
+    failures += compare<Terms::PI,   float,  helm_statef>("PI float");
+    failures += compare<Terms::PD,   float,  helm_statef>("PD float");
+    failures += compare<Terms::PID,  float,  helm_statef>("PID float");
+    failures += compare<Terms::PIT,  float,  helm_statef>("PIT float");
+    failures += compare<Terms::PIDT, float,  helm_statef>("PIDT float");
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -16,120 +16,33 @@
  * href="http://www.cds.caltech.edu/~murray/amwiki/index.php/PID_Control">
  * Chapter 10</a> of <a href="http://www.worldcat.org/isbn/0691135762">Astrom
  * and Murray</a>.
+ *
+ * The process is simulated using \ref helm_plant.h with its propagator
+ * computed once for the fixed step size and once more for any shortened
+ * final step.
+ *
+ * Option \c -m instead runs a Monte Carlo robustness analysis simulating
+ * many trials perturbed by sensor noise, measurement dropouts, sampling
+ * jitter, and plant coefficient uncertainty.  Randomness comes from the
+ * counter-based Philox4x32-10 generator keyed by seed and addressed by trial
+ * and step so results are bit-reproducible regardless of thread count.
  */
 
 #include <getopt.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "helm.h"
-
-/**
- * Advance the temporal state of a model given by transfer function \f$
- * \frac{y(s)}{u(s)} = \frac{b_0}{s^3 + a_2 s^2 + a_1 s + a_0} \f$.
- *
- * Given the process transfer function
- * \f{align}{
- *     \frac{y(s)}{u(s)} = \frac{b_0}{s^3 + a_2 s^2 + a_1 s + a_0}
- * \f}
- * a matching state space model consisting of 1st order differential equations
- * <a
- * href="http://lpsa.swarthmore.edu/Representations/SysRepTransformations/SysRepTransfAll.html">
- * can be derived</a> with the form
- * \f{align}{
- *     \frac{\mathrm{d}}{\mathrm{d}t}
- *     \begin{bmatrix} y_0(t) \\ y_1(t) \\ y_2(t) \end{bmatrix}
- *     &=
- *     \begin{bmatrix}
- *            0 &    1 &    0 \\
- *            0 &    0 &    1 \\
- *         -a_0 & -a_1 & -a_2
- *     \end{bmatrix}
- *     \begin{bmatrix} y_0(t) \\ y_1(t) \\ y_2(t) \end{bmatrix}
- *     +
- *     \begin{bmatrix}   0 \\   0 \\ b_0 \end{bmatrix} u(t)
- * \f}
- * for constants \f$a_0\f$, \f$a_1\f$, \f$a_2\f$, and \f$b_0\f$ and time-varying
- * input data \f$u(t)\f$.  Using a semi-implicit Euler integration scheme,
- * \f{align}{
- *     \vec{y}\left(t_{i+1}\right)
- *     &=
- *       \vec{y}\left(t_i\right)
- *     + h \vec{f}\left(\vec{y}\left(t_{i+1}\right), u\left(t_i\right)\right)
- *     ,
- * \f}
- * yields a constant-coefficient linear problem for advancing by time \f$h\f$:
- * \f{align}{
- *     \begin{bmatrix}
- *            1 &   -h &      0 \\
- *            0 &    1 &     -h \\
- *         ha_0 & ha_1 & 1+ha_2
- *     \end{bmatrix}
- *     \begin{bmatrix} y_0(t_{i+1})\\y_1(t_{i+1})\\y_2(t_{i+1}) \end{bmatrix}
- *     &=
- *     \begin{bmatrix} y_0(t_i) \\ y_1(t_i) \\ y_2(t_i) \end{bmatrix}
- *     +
- *     \begin{bmatrix}   0 \\   0 \\ b_0 \end{bmatrix} u(t_i)
- * \f}
- * Left multiplying by the matrix cofactor and dividing by the determinant gives
- * a form amenable to computation,
- * \f{align}{
- *     \begin{bmatrix} y_0(t_{i+1})\\y_1(t_{i+1})\\y_2(t_{i+1}) \end{bmatrix}
- *     &=
- *     \frac{
- *       \begin{bmatrix}
- *        h (a_2+a_1 h)+1 & h (a_2 h+1)    & h^2 \\
- *        -a_0 h^2        & a_2 h+1        & h \\
- *        -a_0 h          & -h (a_1+a_0 h) & 1
- *       \end{bmatrix}
- *       \left(
- *           \begin{bmatrix} y_0(t_i) \\ y_1(t_i) \\ y_2(t_i) \end{bmatrix}
- *           +
- *           \begin{bmatrix}   0 \\   0 \\ b_0 \end{bmatrix} u(t_i)
- *       \right)
- *     }{h (h (a_0 h+a_1)+a_2)+1}
- *     .
- * \f}
- * This routine advances \f$\vec{y}(t)\f$ to \f$\vec{y}(t + h)\f$ using
- * the above result.
- *
- * @param[in    ] h Time step \f$h\f$ to be taken.
- * @param[in    ] a Coefficients \f$a_0\f$, \f$a_1\f$, and \f$a_2\f$.
- * @param[in    ] b Coefficient \f$b_0\f$.
- * @param[in    ] u Input \f$u(t)\f$.
- * @param[in,out] y On input,  state \f$y_0(t)\f$, \f$y_1(t)\f$,
- *                  and \f$y_2(t)\f$.  On output, state \f$y_0(t+h)\f$,
- *                  \f$y_1(t+h)\f$, and \f$y_2(t+h)\f$.
- */
-static
-void
-advance(const double h,
-        const double a[restrict static 3],
-        const double b[restrict static 1],
-        const double u[restrict static 1],
-              double y[restrict static 3])
-{
-    const double rhs[3] = {
-        y[0],
-        y[1],
-        y[2] + b[0]*u[0]
-    };
-    const double cof[3][3] = {
-        { h*(a[2] + a[1]*h) + 1 , h*(a[2]*h + 1)     , h*h },
-        { -a[0]*h*h             , a[2]*h + 1         , h   },
-        { -a[0]*h               , -h*(a[1] + a[0]*h) , 1   }
-    };
-    const double det = h*(h*(a[0]*h + a[1]) + a[2]) + 1;
-
-    for (int i = 0; i < 3; ++i) {
-        y[i] = 0;
-        for (int j = 0; j < 3; ++j) {
-            y[i] += cof[i][j]*rhs[j];
-        }
-        y[i] /= det;
-    }
-}
+#include "helm_fixed.h"
+#include "helm_freq.h"
+#include "helm_hist.h"
+#include "helm_plant.h"
+#include "helm_pool.h"
+#include "helm_tune.h"
 
 static const double default_a[3] = {1, 3, 3}; ///< Default process parameters
 static const double default_b[1] = {1};       ///< Default process parameters
@@ -140,6 +53,11 @@ static const double default_kp   = 1;         ///< Default proportional gain
 static const double default_r    = 1;         ///< Default reference value
 static const double default_t    = 1;         ///< Default time step size
 static const double default_T    = 25;        ///< Default final time
+static const double default_D    = 0;         ///< Default dead time
+static const double settle_band  = 0.02;      ///< Relative settling band
+static const size_t default_W    = 1;         ///< Default worst trials shown
+static const size_t arx_order    = 3;         ///< ARX orders fitted by -L
+static const size_t arx_dmax     = 32;        ///< ARX dead times tried by -L
 
 /** Print usage on the given stream. */
 static
@@ -156,6 +74,10 @@ print_usage(const char *arg0, FILE *out)
     fprintf(out, "  -1 a1\t\tSet coefficient a1 (default %g)\n", default_a[1]);
     fprintf(out, "  -2 a2\t\tSet coefficient a2 (default %g)\n", default_a[2]);
     fprintf(out, "  -b b0\t\tSet coefficient b0 (default %g)\n", default_b[0]);
+    fprintf(out, "  -D L\t\tDead time rounded to whole steps (default %g)\n",
+                    default_D);
+    fprintf(out, "  -z\t\tDiscretize by exact zero-order hold "
+                    "(default semi-implicit Euler)\n");
     fputc('\n', out);
     fprintf(out, "Term-by-term, parallel-form PID settings\n");
     fprintf(out, "  -p kp\t\tProportional gain  (default %g)\n", default_kp);
@@ -163,6 +85,72 @@ print_usage(const char *arg0, FILE *out)
     fprintf(out, "  -d kd\t\tDerivative gain    (default %g)\n", default_kd);
     fprintf(out, "  -f Tf\t\tFilter time scale  (default %g)\n", default_f);
     fprintf(out, "  -r sp\t\tReference value    (default %g)\n", default_r);
+    fprintf(out, "  -s\t\tUse single precision helm_steadyf()\n");
+    fprintf(out, "  -q N\t\tUse fixed point helm_fixed_steady() quantizing "
+                    "r, u, and y0\n\t\tto N counts per unit\n");
+    fputc('\n', out);
+    fprintf(out, "Sweeping:\n");
+    fprintf(out, "  Options -0, -1, -2, -b, -p, -i, -d, and -f accept lists "
+                    "'x,y,z' or\n  inclusive ranges 'lo:hi:step'.  When any "
+                    "holds multiple values, every\n  combination is simulated "
+                    "in parallel and only a summary table of IAE,\n  ISE, "
+                    "overshoot, %g%% settling time, and peak |u| is output.\n",
+                    100*settle_band);
+    fprintf(out, "  -j N\t\tUse N threads      (default all online)\n");
+    fprintf(out, "  -M\t\tAppend gain margin, phase margin in degrees, and "
+                    "Ms\n\t\tfrom the frequency response, implying a "
+                    "summary table\n");
+    fputc('\n', out);
+    fprintf(out, "Monte Carlo:\n");
+    fprintf(out, "  -m N\t\tSimulate N randomly perturbed trials\n");
+    fprintf(out, "  -S seed\tSet generator seed (default 0)\n");
+    fprintf(out, "  -N sigma\tAdd Gaussian sensor noise to y0 (default 0)\n");
+    fprintf(out, "  -x p\t\tDrop each measurement as NaN w.p. p "
+                    "(default 0)\n");
+    fprintf(out, "  -J frac\tJitter each step by up to +/-frac of dt "
+                    "(default 0)\n");
+    fprintf(out, "  -u pct\t\tPerturb a0, a1, a2, b0 by up to +/-pct%% "
+                    "(default 0)\n");
+    fprintf(out, "  -W K\t\tOutput the K trials of largest IAE "
+                    "(default %zu)\n", default_W);
+    fprintf(out, "  Outputs distributions of IAE, ISE, overshoot, settling "
+                    "time, and peak\n  |u| followed by text trajectories of "
+                    "the worst trials.  Results depend\n  only upon the "
+                    "seed and never upon -j.\n");
+    fputc('\n', out);
+    fprintf(out, "Autotuning:\n");
+    fprintf(out, "  -A\t\tTune the process by relay feedback and compass "
+                    "search\n");
+    fprintf(out, "  -L file\tInstead tune a model fitted to a text log of "
+                    "t, u, y0\n");
+    fprintf(out, "  -E amp\t\tDither u by a pseudorandom +/-amp binary "
+                    "signal (default 0)\n");
+    fprintf(out, "  Outputs Ku, Pu, the seed and tuned settings, and "
+                    "finally tuned flags\n  -p, -i, -d, and -f for this "
+                    "program.  Candidates are simulated\n  concurrently "
+                    "per -j with results independent of thread count.\n"
+                    "  Logs from closed loops require dither, e.g. "
+                    "-E 0.1, to determine a model.\n");
+    fputc('\n', out);
+    fprintf(out, "Output:\n");
+    fprintf(out, "  -o fmt\t\tOne of text, binary, or columnar "
+                    "(default text)\n");
+    fprintf(out, "  -k K\t\tOutput only every K-th step (default 1)\n");
+    fprintf(out, "  -e eps\t\tOutput only steps where u or y changed "
+                    "by more than eps\n");
+    fprintf(out, "  Binary records are little-endian binary64 t, u, y0, "
+                    "y1, y2.  Columnar\n  output begins with a "
+                    "self-describing text header ending in '# end'.\n");
+    fprintf(out, "  The first and final steps are always output.\n");
+    fputc('\n', out);
+    fprintf(out, "Latency:\n");
+    fprintf(out, "  -H file\tWrite text latency histograms to file\n");
+    fprintf(out, "  -G file\tWrite binary latency histograms to file\n");
+    fprintf(out, "  Times every sense-control-actuate cycle and every "
+                    "controller call,\n  recording per-loop histograms "
+                    "and group histograms shared by all\n  threads.  "
+                    "Sweeps and Monte Carlo trials record only the "
+                    "group.\n");
     fputc('\n', out);
     fprintf(out, "Miscellaneous:\n");
     fprintf(out, "  -r r \t\tAdjust setpoint    (default %g)\n", default_r);
@@ -171,6 +159,1171 @@ print_usage(const char *arg0, FILE *out)
     fprintf(out, "  -h\t\tDisplay this help and exit\n");
 }
 
+/** One combination of plant coefficients and controller gains. */
+struct setting
+{
+    double a[3];  ///< Process coefficients a0, a1, and a2
+    double b[1];  ///< Process coefficient b0
+    double kp;    ///< Proportional gain
+    double ki;    ///< Integral gain
+    double kd;    ///< Derivative gain
+    double f;     ///< Filter time scale
+};
+
+/** Performance metrics accumulated while simulating one setting. */
+struct metrics
+{
+    double iae;        ///< Integrated absolute error
+    double ise;        ///< Integrated squared error
+    double overshoot;  ///< Peak y[0] beyond r relative to |r|
+    double settle;     ///< Time after which y[0] remains within the band
+    double umax;       ///< Peak actuator effort |u|
+};
+
+/** Number of fields within each output record. */
+enum { NFIELDS = 5 };
+
+/** Names of each output field, in record order. */
+static const char * const field_name[NFIELDS] = { "t", "u", "y0", "y1", "y2" };
+
+/** Supported output formats. */
+enum format
+{
+    TEXT,      ///< Tab-delimited %-22.16g text, one record per line
+    BINARY,    ///< Raw little-endian binary64 records
+    COLUMNAR   ///< Text header followed by little-endian columnar blocks
+};
+
+/** Records per block within the columnar format. */
+enum { BLOCK = 4096 };
+
+/**
+ * Buffered, decimating writer of per-step output records.  Binary formats
+ * are encoded into large in-memory buffers and handed to stdio in bulk.
+ */
+struct writer
+{
+    FILE          *out;              ///< Destination stream
+    enum format    format;           ///< Output format
+    size_t         every;            ///< Emit every k-th step
+    double         eps;              ///< Emit only changes beyond, if >= 0
+    double         last[NFIELDS];    ///< Most recently emitted record
+    int            any;              ///< Has any record been emitted?
+    size_t         fill;             ///< Bytes or records buffered
+    unsigned char  buf[1 << 16];     ///< Encoded binary records
+    double         col[NFIELDS][BLOCK]; ///< Buffered columnar records
+};
+
+/** Encode \c x into 8 little-endian bytes at \c p regardless of host. */
+static
+void
+put_le64(unsigned char * const p, const uint64_t x)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    memcpy(p, &x, sizeof(x));
+#else
+    for (int k = 0; k < 8; ++k) {
+        p[k] = (unsigned char) (x >> 8*k);
+    }
+#endif
+}
+
+/** Encode double \c d as little-endian binary64 at \c p. */
+static
+void
+put_double(unsigned char * const p, const double d)
+{
+    uint64_t x;
+    memcpy(&x, &d, sizeof(x));
+    put_le64(p, x);
+}
+
+/** Output any buffered columnar records as one block. */
+static
+void
+writer_flush_block(struct writer * const w)
+{
+    if (w->fill) {
+        unsigned char head[8];
+        put_le64(head, w->fill);
+        fwrite(head, sizeof(head), 1, w->out);
+        for (int f = 0; f < NFIELDS; ++f) {
+            for (size_t k = 0; k < w->fill; k += sizeof(w->buf) / 8) {
+                const size_t n = w->fill - k < sizeof(w->buf) / 8
+                               ? w->fill - k : sizeof(w->buf) / 8;
+                for (size_t j = 0; j < n; ++j) {
+                    put_double(w->buf + 8*j, w->col[f][k + j]);
+                }
+                fwrite(w->buf, 8, n, w->out);
+            }
+        }
+        w->fill = 0;
+    }
+}
+
+/** Prepare \c w for use emitting any format preamble. */
+static
+void
+writer_open(struct writer * const w,
+            FILE * const out,
+            const enum format format,
+            const size_t every,
+            const double eps)
+{
+    w->out    = out;
+    w->format = format;
+    w->every  = every;
+    w->eps    = eps;
+    w->any    = 0;
+    w->fill   = 0;
+    if (format == COLUMNAR) {
+        fprintf(out, "# helm step3 columnar output\n# fields:");
+        for (int f = 0; f < NFIELDS; ++f) {
+            fprintf(out, " %s", field_name[f]);
+        }
+        fprintf(out, "\n# encoding: IEEE 754 binary64 little-endian\n"
+                     "# layout: blocks of uint64 count n then n values "
+                     "per field in field order\n"
+                     "# end\n");
+    }
+}
+
+/**
+ * Consider record \c rec from step \c i, counting from one, for output.
+ * The first and \c final steps are always emitted.  Otherwise only every
+ * k-th step is considered and, when a threshold is in effect, emitted only
+ * if some field other than time changed by more than the threshold since
+ * the previously emitted record.
+ */
+static
+void
+writer_put(struct writer * const w,
+           const size_t i,
+           const int final,
+           const double rec[NFIELDS])
+{
+    if (w->any && !final) {
+        if ((i - 1) % w->every) {
+            return;
+        }
+        if (w->eps >= 0) {
+            int changed = 0;
+            for (int f = 1; f < NFIELDS; ++f) {
+                changed |= !(fabs(rec[f] - w->last[f]) <= w->eps);
+            }
+            if (!changed) {
+                return;
+            }
+        }
+    }
+    memcpy(w->last, rec, sizeof(w->last));
+    w->any = 1;
+
+    switch (w->format) {
+    case TEXT:
+        fprintf(w->out, "%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\n",
+                rec[0], rec[1], rec[2], rec[3], rec[4]);
+        break;
+    case BINARY:
+        if (w->fill + 8*NFIELDS > sizeof(w->buf)) {
+            fwrite(w->buf, 1, w->fill, w->out);
+            w->fill = 0;
+        }
+        for (int f = 0; f < NFIELDS; ++f) {
+            put_double(w->buf + w->fill, rec[f]);
+            w->fill += 8;
+        }
+        break;
+    case COLUMNAR:
+        for (int f = 0; f < NFIELDS; ++f) {
+            w->col[f][w->fill] = rec[f];
+        }
+        if (++w->fill == BLOCK) {
+            writer_flush_block(w);
+        }
+        break;
+    }
+}
+
+/** Output anything buffered within \c w. */
+static
+void
+writer_close(struct writer * const w)
+{
+    switch (w->format) {
+    case TEXT:
+        break;
+    case BINARY:
+        fwrite(w->buf, 1, w->fill, w->out);
+        w->fill = 0;
+        break;
+    case COLUMNAR:
+        writer_flush_block(w);
+        break;
+    }
+    fflush(w->out);
+}
+
+/**
+ * Apply the Philox4x32-10 bijection to counter \c c in place under \c key.
+ * See Salmon et al., "Parallel random numbers: as easy as 1, 2, 3" (2011).
+ */
+static
+void
+philox(uint32_t c[4], const uint64_t key)
+{
+    uint32_t k0 = (uint32_t) key, k1 = (uint32_t) (key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        const uint64_t p0 = (uint64_t) 0xD2511F53u * c[0];
+        const uint64_t p1 = (uint64_t) 0xCD9E8D57u * c[2];
+        const uint32_t c1 = c[1], c3 = c[3];
+        c[0] = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c[1] = (uint32_t) p1;
+        c[2] = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c[3] = (uint32_t) p0;
+        k0  += 0x9E3779B9u;
+        k1  += 0xBB67AE85u;
+    }
+}
+
+/** Map \c x onto the open interval (0, 1). */
+static
+double
+unit(const uint32_t x)
+{
+    return (x + 0.5) * 0x1p-32;
+}
+
+/** Independent streams of random words drawn within one trial. */
+enum stream
+{
+    STREAM_STEP   = 0,  ///< Per-step noise, dropout, and jitter
+    STREAM_PLANT  = 1,  ///< Per-trial plant coefficient uncertainty
+    STREAM_DITHER = 2   ///< Per-step actuator dither shared by every trial
+};
+
+/** Perturbations applied to one Monte Carlo trial. */
+struct perturb
+{
+    uint64_t seed;    ///< Generator key shared by every trial
+    uint64_t trial;   ///< Trial number addressing the generator
+    double   noise;   ///< Standard deviation of additive sensor noise
+    double   drop;    ///< Probability that a measurement is NaN
+    double   jitter;  ///< Relative half-width of uniform step jitter
+};
+
+/**
+ * Draw the four random words at \c index within \c stream of trial \c p.
+ * Words are a pure function of seed, trial, stream, and index.
+ */
+static
+void
+draw(const struct perturb * const p,
+     const enum stream stream,
+     const size_t index,
+     uint32_t w[4])
+{
+    w[0] = (uint32_t) index;
+    w[1] = (uint32_t) stream;
+    w[2] = (uint32_t) p->trial;
+    w[3] = (uint32_t) (p->trial >> 32);
+    philox(w, p->seed);
+}
+
+/** Set the tuning of \c h from the parallel-form gains within \c s. */
+static
+void
+tune(const struct setting * const s, struct helm_state * const h)
+{
+    helm_reset(h);
+    h->kp = s->kp;          // Unified gain
+    h->Td = s->kd / h->kp;  // Convert to derivative time scale
+    h->Tf = s->f;           // Astrom and Murray p.308 suggests (Td / 2--20)
+    h->Ti = h->kp / s->ki;  // Convert to integral time scale
+}
+
+/** Options common to every simulated setting. */
+struct options
+{
+    double r;                       ///< Reference value
+    double t;                       ///< Time step size
+    double T;                       ///< Final time
+    double D;                       ///< Dead time
+    enum helm_plant_method method;  ///< Process discretization
+    int    single;                  ///< Use helm_steadyf()?
+    double counts;                  ///< Use helm_fixed_steady() if nonzero
+    double dither;                  ///< Amplitude of binary actuator dither
+    struct helm_hist *group;        ///< Shared LATENCIES histograms or NULL
+};
+
+/** Latency histograms kept per loop and per group. */
+enum { CYCLE, CONTROL, LATENCIES };
+
+/** Names of each latency histogram. */
+static const char * const latency_name[LATENCIES] = { "cycle", "control" };
+
+/**
+ * Record the latency of one \c cycle and of the \c control within it into
+ * any per-loop histograms \c loop and any shared histograms \c group.
+ */
+static
+void
+record_latency(struct helm_hist * const loop,
+               struct helm_hist * const group,
+               const uint64_t cycle,
+               const uint64_t control)
+{
+    if (loop) {
+        helm_hist_record(&loop[CYCLE],   cycle);
+        helm_hist_record(&loop[CONTROL], control);
+    }
+    if (group) {
+        helm_hist_record_shared(&group[CYCLE],   cycle);
+        helm_hist_record_shared(&group[CONTROL], control);
+    }
+}
+
+/**
+ * Simulate the controlled process for one setting, accumulating metrics and
+ * optionally outputting status after each step.
+ *
+ * When perturbed, each step's duration is scaled by a uniform jitter that the
+ * controller observes as its \c dt, while the measurement of \c y[0] given
+ * to the controller is either replaced by NaN or offset by Gaussian noise.
+ * Metrics always use the true process output.
+ *
+ * When latency histograms are given, each cycle from sensing through
+ * actuation is timed along with the controller call within it.
+ *
+ * \param[in]  s      Process coefficients and controller gains.
+ * \param[in]  o      Options common to every setting.
+ * \param[in]  p      Perturbations to apply or \c NULL for none.
+ * \param[out] out    Writer receiving per-step status or \c NULL.
+ * \param[out] m      Metrics accumulated across the simulation.
+ * \param[out] lat    LATENCIES per-loop histograms or \c NULL.
+ *
+ * \return Zero on success or nonzero if the process cannot be simulated.
+ */
+static
+int
+simulate(const struct setting * const s,
+         const struct options * const o,
+         const struct perturb * const p,
+         struct writer * const out,
+         struct metrics * const m,
+         struct helm_hist * const lat)
+{
+    const double r = o->r, t = o->t, T = o->T;
+    const int timed = lat || o->group;
+    uint64_t t0 = 0, t1 = 0, t2 = 0;
+
+    // Initialize process propagators for the full and any final step size
+    const double b[3] = {s->b[0], 0, 0};
+    struct helm_plant full, last;
+    if (helm_plant_init(&full, 3, s->a, b, t, o->method)) {
+        return 1;
+    }
+    last = full;
+
+    // Initialize dead time holding zero input before time zero
+    const size_t d = (size_t) (o->D / t + 0.5);
+    struct helm_delay dl;
+    double * const buf = d ? malloc(d * sizeof(double)) : NULL;
+    if (d && !buf) {
+        return 1;
+    }
+    helm_delay_init(&dl, d, 1, buf, 0);
+
+    // Initialize state
+    double u[1] = {0};        // Actuator signal
+    double v[1] = {0};        // Control signal
+    double x[3] = {0, 0, 0};  // Model state
+
+    // Initialize controller setting PID parameters from kp, ki, and kd
+    struct helm_state h;
+    tune(s, &h);
+    struct helm_statef g = {
+        (float) h.kp, (float) h.Td, (float) h.Tf, (float) h.Ti, (float) h.Tt,
+        NAN, NAN
+    };
+    struct helm_fixed q;                  // Fixed point counts of size sq
+    const double sq = o->counts ? 1 / o->counts : 1;
+    double qt = t;                        // Step size compiled within q
+    int32_t vq = 0;                       // Control signal in counts
+    if (o->counts && helm_fixed_compile(&q, &h, qt, sq, sq)) {
+        free(buf);
+        return 1;
+    }
+
+    // Accumulate metrics relative to the reference value
+    const double scale = r != 0 ? fabs(r) : 1;
+    double peak = -INFINITY;
+    m->iae    = 0;
+    m->ise    = 0;
+    m->settle = 0;
+    m->umax   = 0;
+
+    // Simulate controlled model, outputting status after each step
+    helm_approach(&h);
+    helm_approachf(&g);
+    helm_fixed_approach(&q);
+    double now = 0;
+    for (size_t i = 0; i*t < T+t;) {
+        double dt = ++i*t > T ? T - (i-1)*t : t;   // Process step size
+        double dc = t;                             // Controller step size
+        uint32_t w[4] = {0, 0, 0, 0};
+        if (p) {
+            draw(p, STREAM_STEP, i, w);
+            if (p->jitter) {
+                const double scale = 1 + p->jitter*(2*unit(w[3]) - 1);
+                dt *= scale;
+                dc *= scale;
+            }
+        }
+        now = p && p->jitter ? now + dt : i*t > T ? T : i*t;
+        if (dt != t && dt != last.h && helm_plant_retime(&last, dt)) {
+            free(buf);
+            return 1;
+        }
+        double ud = u[0];
+        helm_delay_shift(&dl, &ud);                                // Delay
+        helm_plant_advance(dt == t ? &full : &last, x, ud);        // Advance
+        const double y[3] = {b[0]*x[0], b[0]*x[1], b[0]*x[2]};
+        if (out) {
+            const double rec[NFIELDS] = { now, u[0], y[0], y[1], y[2] };
+            writer_put(out, i, !(i*t < T+t), rec);                 // Output
+        }
+        const double e = r - y[0];                                 // Measure
+        m->iae  += dt*fabs(e);
+        m->ise  += dt*e*e;
+        m->umax  = fmax(m->umax, fabs(u[0]));
+        peak     = fmax(peak, y[0]);
+        if (!(fabs(e) <= settle_band*scale)) {
+            m->settle = now;
+        }
+        if (timed) {
+            t0 = helm_hist_ticks();
+        }
+        double ym = y[0];                                          // Sense
+        if (p && unit(w[2]) < p->drop) {
+            ym = NAN;
+        } else if (p && p->noise) {                                // Box-Muller
+            ym += p->noise * sqrt(-2*log(unit(w[0])))
+                           * cos(6.283185307179586*unit(w[1]));
+        }
+        if (timed) {
+            t1 = helm_hist_ticks();
+        }
+        if (o->counts) {                                           // Control
+            if (dc != qt) {
+                qt = dc;
+                if (helm_fixed_compile(&q, &h, qt, sq, sq)) {
+                    free(buf);
+                    return 1;
+                }
+            }
+            vq   = helm_fixed_add(vq, helm_fixed_steady(&q,
+                       helm_fixed_quantize(r,    sq),
+                       helm_fixed_quantize(u[0], sq), vq,
+                       helm_fixed_quantize(ym,   sq)));
+            v[0] = vq * sq;
+        } else {
+            v[0] += o->single ? helm_steadyf(&g, dc, r, u[0], v[0], ym)
+                              : helm_steady (&h, dc, r, u[0], v[0], ym);
+        }
+        if (timed) {
+            t2 = helm_hist_ticks();
+        }
+        u[0]  = v[0];                                              // Ideal
+        if (o->dither) {                                           // Excite
+            uint32_t c[4] = { (uint32_t) i, STREAM_DITHER, 0, 0 };
+            philox(c, 0);
+            u[0] += c[0] & 1 ? o->dither : -o->dither;
+        }
+        if (timed) {
+            record_latency(lat, o->group, helm_hist_ticks() - t0, t2 - t1);
+        }
+    }
+    m->overshoot = fmax(0, peak - r) / scale;
+    if (m->settle >= (p && p->jitter ? now : T)) {
+        m->settle = INFINITY;  // Never settled within the horizon
+    }
+
+    free(buf);
+    return 0;
+}
+
+/** Frequencies at which option -M evaluates each loop response. */
+enum { FREQS = 2048 };
+
+/**
+ * Find the stability margins of one setting from its loop response across
+ * <tt>[1e-4, 1]</tt> times the Nyquist frequency using scratch \c mem of at
+ * least helm_freq_bytes(FREQS) bytes.  Returns zero on success.
+ */
+static
+int
+analyze(const struct setting * const s,
+        const struct options * const o,
+        void * const mem,
+        struct helm_freq_margins * const m)
+{
+    const double b[3]    = {s->b[0], 0, 0};
+    const size_t d       = (size_t) (o->D / o->t + 0.5);
+    const double nyquist = HELM_FREQ_PI / o->t;
+    struct helm_plant p;
+    struct helm_freq  g;
+    struct helm_state h;
+    if (   helm_plant_init(&p, 3, s->a, b, o->t, o->method)
+        || helm_freq_init(&g, FREQS, 1e-4*nyquist, nyquist, &p, d, 0, mem)) {
+        return 1;
+    }
+    tune(s, &h);
+    helm_freq_analyze(&g, &h, m);
+    return 0;
+}
+
+/** Values taken by one sweepable option. */
+struct axis
+{
+    double *v;  ///< Values
+    size_t  n;  ///< Number of values
+};
+
+/**
+ * Parse a single value, a list 'x,y,z', or an inclusive range 'lo:hi:step'
+ * into \c x replacing any prior values.  Returns zero on success.
+ */
+static
+int
+parse_axis(const char *arg, struct axis * const x)
+{
+    double lo = 0, hi = 0, step = 0;
+    char tail;
+    size_t n;
+    const int range = 3 == sscanf(arg, "%lf:%lf:%lf%c", &lo, &hi, &step, &tail);
+    if (range) {
+        if (!(step > 0) || !(hi >= lo)) {
+            return -1;
+        }
+        n = (size_t) floor((hi - lo) / step + 1e-9) + 1;
+    } else {
+        n = 1;
+        for (const char *c = arg; *c; ++c) {
+            n += *c == ',';
+        }
+    }
+
+    double * const v = realloc(x->v, n * sizeof(*v));
+    if (!v) {
+        return -1;
+    }
+    x->v = v;
+    x->n = n;
+    if (range) {
+        for (size_t k = 0; k < n; ++k) {
+            v[k] = lo + k*step;
+        }
+    } else {
+        for (size_t k = 0; k < n; ++k) {
+            char *end;
+            v[k] = strtod(arg, &end);
+            if (end == arg || (*end != ',' && *end != '\0')) {
+                return -1;
+            }
+            arg = end + (*end == ',');
+        }
+    }
+    return 0;
+}
+
+/** Parse output format name \c arg into \c f.  Returns zero on success. */
+static
+int
+parse_format(const char *arg, enum format * const f)
+{
+    if      (0 == strcmp(arg, "text"))     *f = TEXT;
+    else if (0 == strcmp(arg, "binary"))   *f = BINARY;
+    else if (0 == strcmp(arg, "columnar")) *f = COLUMNAR;
+    else                                   return -1;
+    return 0;
+}
+
+/** Indices of each sweepable option within a struct axis array. */
+enum { A0, A1, A2, B0, KP, KI, KD, TF, NAXES };
+
+/** Names of each sweepable option, used as summary table headings. */
+static const char * const axis_name[NAXES] = {
+    "a0", "a1", "a2", "b0", "kp", "ki", "kd", "Tf"
+};
+
+/** Everything needed to simulate the k-th combination during a sweep. */
+struct sweep
+{
+    const struct axis    *x;        ///< Values for each sweepable option
+    const struct options *o;        ///< Options common to every combination
+    struct metrics       *results;  ///< Metrics for each combination
+    struct helm_freq_margins *margins; ///< Margins for each or NULL
+};
+
+/** Decode combination \c k into a setting with option -0 varying slowest. */
+static
+void
+decode(const struct axis * const x, size_t k, struct setting * const s)
+{
+    double val[NAXES];
+    for (int j = NAXES; j-- > 0;) {
+        val[j] = x[j].v[k % x[j].n];
+        k     /= x[j].n;
+    }
+    s->a[0] = val[A0];
+    s->a[1] = val[A1];
+    s->a[2] = val[A2];
+    s->b[0] = val[B0];
+    s->kp   = val[KP];
+    s->ki   = val[KI];
+    s->kd   = val[KD];
+    s->f    = val[TF];
+}
+
+/** Callback for helm_pool_run() simulating combinations [begin, end). */
+static
+void
+sweep_range(void *ctx, size_t begin, size_t end, unsigned worker)
+{
+    const struct sweep * const w = (const struct sweep *) ctx;
+    (void) worker;
+    void * const mem = w->margins ? malloc(helm_freq_bytes(FREQS)) : NULL;
+    for (size_t k = begin; k < end; ++k) {
+        struct setting s;
+        decode(w->x, k, &s);
+        if (simulate(&s, w->o, NULL, NULL, &w->results[k], NULL)) {
+            const struct metrics nan = { NAN, NAN, NAN, NAN, NAN };
+            w->results[k] = nan;
+        }
+        if (w->margins && (!mem || analyze(&s, w->o, mem, &w->margins[k]))) {
+            const struct helm_freq_margins nan = {
+                NAN, NAN, NAN, NAN, NAN, NAN
+            };
+            w->margins[k] = nan;
+        }
+    }
+    free(mem);
+}
+
+/** Number of metrics within struct metrics. */
+enum { NMETRICS = 5 };
+
+/** Names of each metric, used as summary table headings. */
+static const char * const metric_name[NMETRICS] = {
+    "IAE", "ISE", "overshoot", "settle", "umax"
+};
+
+/** Offsets of each metric within struct metrics. */
+static const size_t metric_offset[NMETRICS] = {
+    offsetof(struct metrics, iae),
+    offsetof(struct metrics, ise),
+    offsetof(struct metrics, overshoot),
+    offsetof(struct metrics, settle),
+    offsetof(struct metrics, umax)
+};
+
+/** Retrieve the \c k-th metric from \c m. */
+static
+double
+metric(const struct metrics * const m, const int k)
+{
+    return *(const double *) ((const char *) m + metric_offset[k]);
+}
+
+/**
+ * Trials per chunk.  Chunks, not threads, are the unit of accumulation so
+ * that floating point reductions are independent of thread count.
+ */
+enum { CHUNK = 256 };
+
+/** Most trials whose trajectories may be output. */
+enum { WORST_MAX = 16 };
+
+/**
+ * Histogram bins per metric.  Bin zero counts zeros, the final bin counts
+ * infinities, and the remainder split each of OCTAVES binary octaves
+ * centered upon one into SUBBINS pieces for roughly 4% quantile accuracy.
+ */
+enum { OCTAVES = 128, SUBBINS = 16, NBINS = 2 + OCTAVES*SUBBINS };
+
+/** Histogram bin for nonnegative, non-NaN \c x. */
+static
+size_t
+bin(const double x)
+{
+    if (!(x > 0)) {
+        return 0;
+    }
+    if (isinf(x)) {
+        return NBINS - 1;
+    }
+    int e;
+    const double f = frexp(x, &e);  // x = f 2^e for f within [1/2, 1)
+    e += OCTAVES / 2;
+    if (e < 0) {
+        return 1;
+    }
+    if (e >= OCTAVES) {
+        return NBINS - 2;
+    }
+    return 1 + (size_t) e*SUBBINS + (size_t) ((2*f - 1)*SUBBINS);
+}
+
+/** Representative value, namely the midpoint, of histogram bin \c k. */
+static
+double
+bin_value(const size_t k)
+{
+    if (k == 0) {
+        return 0;
+    }
+    if (k == NBINS - 1) {
+        return INFINITY;
+    }
+    const size_t e = (k - 1) / SUBBINS, s = (k - 1) % SUBBINS;
+    return ldexp(0.5 * (1 + (s + 0.5) / SUBBINS), (int) e - OCTAVES/2);
+}
+
+/** Statistics accumulated across the trials of one or more chunks. */
+struct tally
+{
+    size_t n[NMETRICS];            ///< Finite samples of each metric
+    size_t bad[NMETRICS];          ///< Non-finite samples of each metric
+    size_t seen[NMETRICS];         ///< Non-NaN samples of each metric
+    double mean[NMETRICS];         ///< Running mean of finite samples
+    double m2[NMETRICS];           ///< Running sum of squared deviations
+    double min[NMETRICS];          ///< Least non-NaN sample
+    double max[NMETRICS];          ///< Greatest non-NaN sample
+    size_t nworst;                 ///< Entries within #worst
+    size_t worst[WORST_MAX];       ///< Trials by decreasing IAE
+    double worst_iae[WORST_MAX];   ///< IAE of each trial in #worst
+};
+
+/** Prepare \c t to accumulate statistics. */
+static
+void
+tally_init(struct tally * const t)
+{
+    memset(t, 0, sizeof(*t));
+    for (int k = 0; k < NMETRICS; ++k) {
+        t->min[k] =  INFINITY;
+        t->max[k] = -INFINITY;
+    }
+}
+
+/**
+ * Consider \c trial having \c iae for inclusion among the \c K worst within
+ * \c t.  NaN ranks worst of all and ties favor the earlier trial so that the
+ * outcome is independent of the order of consideration.
+ */
+static
+void
+tally_worst(struct tally * const t,
+            const size_t K,
+            const size_t trial,
+            const double iae)
+{
+    const double key = isnan(iae) ? INFINITY : iae;
+    size_t k = t->nworst;
+    while (k > 0 && (   key >  t->worst_iae[k-1]
+                     || (key == t->worst_iae[k-1] && trial < t->worst[k-1]))) {
+        --k;
+    }
+    if (k >= K) {
+        return;
+    }
+    const size_t last = t->nworst < K ? t->nworst : K - 1;
+    memmove(t->worst     + k + 1, t->worst     + k,
+            (last - k) * sizeof(*t->worst));
+    memmove(t->worst_iae + k + 1, t->worst_iae + k,
+            (last - k) * sizeof(*t->worst_iae));
+    t->worst[k]     = trial;
+    t->worst_iae[k] = key;
+    t->nworst       = last + 1;
+}
+
+/** Merge \c b into \c a using Chan et al.'s pairwise update. */
+static
+void
+tally_merge(struct tally * const a,
+            const struct tally * const b,
+            const size_t K)
+{
+    for (int k = 0; k < NMETRICS; ++k) {
+        const size_t n = a->n[k] + b->n[k];
+        if (b->n[k]) {
+            const double d = b->mean[k] - a->mean[k];
+            a->mean[k] += d * b->n[k] / n;
+            a->m2[k]   += b->m2[k] + d*d * a->n[k] * b->n[k] / n;
+        }
+        a->n[k]     = n;
+        a->bad[k]  += b->bad[k];
+        a->seen[k] += b->seen[k];
+        a->min[k]   = fmin(a->min[k], b->min[k]);
+        a->max[k]   = fmax(a->max[k], b->max[k]);
+    }
+    for (size_t i = 0; i < b->nworst; ++i) {
+        tally_worst(a, K, b->worst[i], b->worst_iae[i]);
+    }
+}
+
+/** Everything needed to simulate trials during a Monte Carlo analysis. */
+struct montecarlo
+{
+    const struct setting *s;       ///< Nominal setting
+    const struct options *o;       ///< Options common to every trial
+    struct perturb        p;       ///< Perturbations less trial number
+    double                u;       ///< Relative plant coefficient uncertainty
+    size_t                n;       ///< Number of trials
+    size_t                K;       ///< Worst trials retained
+    struct tally         *tally;   ///< One tally per chunk
+    size_t               *hist;    ///< Per-worker NMETRICS by NBINS counts
+};
+
+/** Prepare the setting \c s and perturbations \c p of trial \c k. */
+static
+void
+trial(const struct montecarlo * const mc,
+      const size_t k,
+      struct setting * const s,
+      struct perturb * const p)
+{
+    *s       = *mc->s;
+    *p       = mc->p;
+    p->trial = k;
+    if (mc->u) {
+        uint32_t w[4];
+        draw(p, STREAM_PLANT, 0, w);
+        s->a[0] *= 1 + mc->u*(2*unit(w[0]) - 1);
+        s->a[1] *= 1 + mc->u*(2*unit(w[1]) - 1);
+        s->a[2] *= 1 + mc->u*(2*unit(w[2]) - 1);
+        s->b[0] *= 1 + mc->u*(2*unit(w[3]) - 1);
+    }
+}
+
+/** Callback for helm_pool_run() simulating chunks [begin, end). */
+static
+void
+montecarlo_range(void *ctx, size_t begin, size_t end, unsigned worker)
+{
+    const struct montecarlo * const mc = (const struct montecarlo *) ctx;
+    size_t * const hist = mc->hist + (size_t) worker * NMETRICS * NBINS;
+    for (size_t c = begin; c < end; ++c) {
+        struct tally * const t = &mc->tally[c];
+        tally_init(t);
+        const size_t last = (c + 1)*CHUNK < mc->n ? (c + 1)*CHUNK : mc->n;
+        for (size_t k = c*CHUNK; k < last; ++k) {
+            struct setting s;
+            struct perturb p;
+            struct metrics m;
+            trial(mc, k, &s, &p);
+            if (simulate(&s, mc->o, &p, NULL, &m, NULL)) {
+                const struct metrics nan = { NAN, NAN, NAN, NAN, NAN };
+                m = nan;
+            }
+            for (int j = 0; j < NMETRICS; ++j) {
+                const double x = metric(&m, j);
+                if (isfinite(x)) {                              // Welford
+                    const double d = x - t->mean[j];
+                    t->mean[j] += d / ++t->n[j];
+                    t->m2[j]   += d * (x - t->mean[j]);
+                } else {
+                    ++t->bad[j];
+                }
+                if (!isnan(x)) {
+                    t->min[j] = fmin(t->min[j], x);
+                    t->max[j] = fmax(t->max[j], x);
+                    ++t->seen[j];
+                    ++hist[j*NBINS + bin(x)];
+                }
+            }
+            tally_worst(t, mc->K, k, m.iae);
+        }
+    }
+}
+
+/**
+ * Approximate quantile \c q of a metric from histogram \c h of \c n
+ * non-NaN samples, clamped to the observed extrema.
+ */
+static
+double
+quantile(const size_t * const h,
+         const size_t n,
+         const double q,
+         const double min,
+         const double max)
+{
+    if (!n) {
+        return NAN;
+    }
+    const double want = q * n;
+    size_t seen = 0, k = 0;
+    while (k < NBINS - 1 && (seen += h[k]) < want) {
+        ++k;
+    }
+    return fmin(fmax(bin_value(k), min), max);
+}
+
+/**
+ * Run \c mc->n perturbed trials in parallel using \c j threads, output
+ * metric distributions, and then output the trajectories of the worst.
+ * Returns zero on success.
+ */
+static
+int
+montecarlo(struct montecarlo * const mc,
+           const unsigned j,
+           const size_t every,
+           const double eps)
+{
+    const unsigned nworkers = j ? j : helm_pool_ncpu();
+    const size_t   nchunks  = (mc->n + CHUNK - 1) / CHUNK;
+    mc->tally = malloc(nchunks * sizeof(*mc->tally));
+    mc->hist  = calloc((size_t) nworkers * NMETRICS * NBINS, sizeof(size_t));
+    if (!mc->tally || !mc->hist) {
+        free(mc->tally);
+        free(mc->hist);
+        return 1;
+    }
+    helm_pool_run(nchunks, 1, nworkers, montecarlo_range, mc);
+
+    // Reduce chunks in order and histograms in any order
+    struct tally all;
+    tally_init(&all);
+    for (size_t c = 0; c < nchunks; ++c) {
+        tally_merge(&all, &mc->tally[c], mc->K);
+    }
+    for (unsigned w = 1; w < nworkers; ++w) {
+        for (size_t k = 0; k < (size_t) NMETRICS * NBINS; ++k) {
+            mc->hist[k] += mc->hist[(size_t) w * NMETRICS * NBINS + k];
+        }
+    }
+
+    // Output the distribution of every metric...
+    printf("# %zu trials, seed %llu, noise %g, dropout %g, jitter %g, "
+           "uncertainty %g%%\n", mc->n, (unsigned long long) mc->p.seed,
+           mc->p.noise, mc->p.drop, mc->p.jitter, 100*mc->u);
+    printf("#%-13s\t%-14s\t%-14s\t%-14s\t%-14s\t%-14s\t%-14s\t%-14s\t%s\n",
+           "metric", "mean", "std", "min", "p50", "p90", "p99", "max",
+           "nonfinite");
+    for (int k = 0; k < NMETRICS; ++k) {
+        const size_t * const h = mc->hist + (size_t) k * NBINS;
+        const size_t n = all.n[k], seen = all.seen[k];
+        const double lo = all.min[k], hi = all.max[k];
+        printf("%-14s\t%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g\t"
+               "%-14.8g\t%-14.8g\t%zu\n", metric_name[k],
+               n ? all.mean[k] : NAN, n > 1 ? sqrt(all.m2[k] / (n-1)) : NAN,
+               seen ? lo : NAN, quantile(h, seen, 0.50, lo, hi),
+               quantile(h, seen, 0.90, lo, hi),
+               quantile(h, seen, 0.99, lo, hi), seen ? hi : NAN,
+               all.bad[k]);
+    }
+
+    // ...and then reproduce the worst trials outputting their trajectories,
+    // omitting them from any latency histograms already holding them
+    static struct writer w;
+    struct options again = *mc->o;
+    again.group = NULL;
+    for (size_t i = 0; i < all.nworst; ++i) {
+        struct setting s;
+        struct perturb p;
+        struct metrics m;
+        trial(mc, all.worst[i], &s, &p);
+        printf("\n\n# worst %zu: trial %zu a0 %.8g a1 %.8g a2 %.8g b0 %.8g "
+               "IAE %.8g\n", i + 1, all.worst[i],
+               s.a[0], s.a[1], s.a[2], s.b[0], all.worst_iae[i]);
+        writer_open(&w, stdout, TEXT, every, eps);
+        if (simulate(&s, &again, &p, &w, &m, NULL)) {
+            printf("# unable to simulate the process\n");
+        }
+        writer_close(&w);
+    }
+
+    free(mc->tally);
+    free(mc->hist);
+    return 0;
+}
+
+/**
+ * Read columns t, u, and y0 from a text log as output by this program into
+ * newly allocated arrays, setting \c dt to the mean step.  Lines beginning
+ * with '#' are skipped.  Each line holds the input applied over the step
+ * ending at its time, so inputs are shifted to pair each output with the
+ * input applied after it.  Returns the number of samples or zero on failure.
+ */
+static
+size_t
+read_log(const char * const path,
+         double ** const u,
+         double ** const y,
+         double * const dt)
+{
+    FILE * const f = fopen(path, "r");
+    if (!f) {
+        return 0;
+    }
+    size_t n = 0, cap = 0;
+    double t0 = NAN, t1 = NAN;
+    char line[1024];
+    *u = *y = NULL;
+    while (fgets(line, sizeof(line), f)) {
+        double t, a, b;
+        if (line[0] == '#' || sscanf(line, "%lf %lf %lf", &t, &a, &b) != 3
+                || (n && !(t > t1))) {
+            continue;                   // Also skip repeated final samples
+        }
+        if (n == cap) {
+            cap = cap ? 2*cap : 1024;
+            double * const nu = realloc(*u, cap * sizeof(double));
+            double * const ny = nu ? realloc(*y, cap * sizeof(double)) : NULL;
+            if (nu) {
+                *u = nu;
+            }
+            if (!ny) {
+                n = 0;
+                break;
+            }
+            *y = ny;
+        }
+        t0 = n ? t0 : t;
+        t1 = t;
+        (*u)[n]   = a;
+        (*y)[n++] = b;
+    }
+    fclose(f);
+    *dt = n > 1 ? (t1 - t0) / (n - 1) : NAN;
+    if (!(*dt > 0)) {
+        n = 0;
+    } else {
+        memmove(*u, *u + 1, --n * sizeof(double));
+    }
+    if (!n) {
+        free(*u);
+        free(*y);
+        *u = *y = NULL;
+    }
+    return n;
+}
+
+/**
+ * Tune a controller for setting \c s, or for a model fitted to the log at
+ * \c replay when non-NULL, using \c j threads and output the result.
+ * Returns zero on success.
+ */
+static
+int
+autotune(const struct setting * const s,
+         const struct options * const o,
+         const char * const replay,
+         const unsigned j)
+{
+    struct helm_tune_model m;
+    if (replay) {
+        double *u, *y, dt, rms;
+        const size_t n = read_log(replay, &u, &y, &dt);
+        if (!n) {
+            fprintf(stderr, "Unable to read samples t, u, y0 from %s\n",
+                    replay);
+            return 1;
+        }
+        const int err = helm_tune_fit(&m, n, u, y, dt, arx_order, arx_order,
+                                      arx_dmax, &rms);
+        free(u);
+        free(y);
+        if (err) {
+            fprintf(stderr, "Unable to fit a model to %zu samples from %s\n",
+                    n, replay);
+            return 1;
+        }
+        printf("# fit\tsamples %zu\tdt %.8g\tna %zu\tnb %zu\tdelay %zu"
+               "\trms %.8g\n", n, dt, m.na, m.nb, m.delay, rms);
+    } else {
+        const double b[3] = {s->b[0], 0, 0};
+        struct helm_plant p;
+        if (helm_plant_init(&p, 3, s->a, b, o->t, o->method)) {
+            fprintf(stderr, "Unable to simulate the process\n");
+            return 1;
+        }
+        helm_tune_model_plant(&m, &p, (size_t) (o->D / o->t + 0.5));
+    }
+
+    struct helm_tune_options opt;
+    struct helm_tune_result  r;
+    helm_tune_options_init(&opt);
+    opt.nworkers = j;
+    if (helm_tune(&m, &opt, &r)) {
+        fprintf(stderr, "Unable to tune: no steady relay oscillation "
+                        "or no robust seed\n");
+        return 1;
+    }
+    const struct helm_state * const h[2] = { &r.seed, &r.tuned };
+    const char * const name[2] = { "seed", "tuned" };
+    const double cost[2] = { r.seed_cost, r.cost };
+    printf("# relay\tKu %.8g\tPu %.8g\n", r.Ku, r.Pu);
+    for (int k = 0; k < 2; ++k) {
+        printf("# %s\tkp %.8g\tki %.8g\tkd %.8g\tf %.8g\tIAE %.8g\n",
+               name[k], h[k]->kp, h[k]->kp / h[k]->Ti, h[k]->kp * h[k]->Td,
+               h[k]->Tf, cost[k]);
+    }
+    printf("# search\titerations %u\tsimulated %zu\trejected %zu"
+           "\tterminated %zu\tMs %.8g\n",
+           r.iters, r.simulated, r.rejected, r.terminated, r.ms);
+    printf("-p %.8g -i %.8g -d %.8g -f %.8g\n", r.tuned.kp,
+           r.tuned.kp / r.tuned.Ti, r.tuned.kp * r.tuned.Td, r.tuned.Tf);
+    return 0;
+}
+
+/**
+ * Write the group latency histograms followed by those of \c n loops as
+ * text to path \c text and as binary to path \c binary, either of which
+ * may be NULL.  Returns zero on success.
+ */
+static
+int
+write_latency(const char * const text,
+              const char * const binary,
+              const struct helm_hist * const group,
+              const struct helm_hist * const loop,
+              const size_t n)
+{
+    const char * const path[2] = { text, binary };
+    for (int b = 0; b < 2; ++b) {
+        FILE * const f = path[b] ? fopen(path[b], b ? "wb" : "w") : NULL;
+        if (path[b] && !f) {
+            fprintf(stderr, "Unable to open %s\n", path[b]);
+            return 1;
+        }
+        int err = 0;
+        for (size_t k = 0; f && !err && k < LATENCIES*(n + 1); ++k) {
+            const struct helm_hist * const h = k < LATENCIES
+                                             ? &group[k]
+                                             : &loop[k - LATENCIES];
+            char label[64];
+            if (k < LATENCIES) {
+                snprintf(label, sizeof(label), "group %s",
+                         latency_name[k]);
+            } else {
+                snprintf(label, sizeof(label), "loop %zu %s",
+                         k / LATENCIES - 1, latency_name[k % LATENCIES]);
+            }
+            err = b ? helm_hist_write_binary(f, label, h)
+                    : helm_hist_write_text  (f, label, h);
+        }
+        if (f && (fclose(f) || err)) {
+            fprintf(stderr, "Unable to write %s\n", path[b]);
+            return 1;
+        }
+    }
+    return 0;
+}
+
 /**
  * Control the process with transfer function \f$ \frac{y(s)}{u(s)} =
  * \frac{b_0}{s^3 + a_2 s^2 + a_1 s + a_0} \f$ across a unit step change in
@@ -179,73 +1332,253 @@ print_usage(const char *arg0, FILE *out)
  * derivatives are zero.  At time zero, step change \f$r(t) = 1\f$ is
  * introduced.  The transfer function, in conjunction with the controller
  * dynamics, determines the controlled system response.
+ *
+ * When any of the process coefficients or controller settings are given
+ * multiple values, every combination is instead simulated in parallel
+ * and a summary table of performance metrics is output.  When Monte Carlo
+ * trials are requested, metric distributions across perturbed trials are
+ * output followed by the trajectories of the worst trials.
  */
 int
 main (int argc, char *argv[])
 {
     // Establish mutable settings
-    double a[3] = {default_a[0], default_a[1], default_a[2]};
-    double b[1] = {default_b[0]};
-    double f    = default_f;
-    double kd   = default_kd;
-    double ki   = default_ki;
-    double kp   = default_kp;
-    double r    = default_r;
-    double t    = default_t;
-    double T    = default_T;
+    struct axis x[NAXES] = {{NULL, 0}};
+    const double defaults[NAXES] = {
+        default_a[0], default_a[1], default_a[2], default_b[0],
+        default_kp, default_ki, default_kd, default_f
+    };
+    for (int j = 0; j < NAXES; ++j) {
+        x[j].n = 1;
+        x[j].v = malloc(sizeof(*x[j].v));
+        if (!x[j].v) {
+            fprintf(stderr, "Unable to allocate settings\n");
+            return EXIT_FAILURE;
+        }
+        x[j].v[0] = defaults[j];
+    }
+    struct options o = {
+        default_r, default_t, default_T, default_D, HELM_PLANT_EULER, 0, 0, 0,
+        NULL
+    };
+    unsigned j = 0;
+    enum format format = TEXT;
+    long   every = 1;
+    double eps   = -1;
+    int    margins = 0;
+    int    tuning  = 0;
+    const char *replay = NULL;
+    const char *latency_text = NULL, *latency_binary = NULL;
+    double trials = 0;
+    long   worst  = (long) default_W;
+    struct montecarlo mc = { NULL, &o, { 0, 0, 0, 0, 0 }, 0, 0, 0, NULL, NULL };
 
     // Process incoming arguments
-    static const char optstring[] = "0:1:2:b:d:f:i:p:r:t:T:h";
-    for (int opt; -1 != (opt = getopt(argc, argv, optstring));) {
+    static const char optstring[] =
+        "0:1:2:Ab:d:D:e:E:f:G:H:i:j:J:k:L:m:MN:o:p:q:r:sS:t:T:u:W:x:zh";
+    for (int opt, bad = 0; -1 != (opt = getopt(argc, argv, optstring));) {
         switch (opt) {
-        case '0': a[0] = atof(optarg);          break;
-        case '1': a[1] = atof(optarg);          break;
-        case '2': a[2] = atof(optarg);          break;
-        case 'b': b[0] = atof(optarg);          break;
-        case 'd': kd   = atof(optarg);          break;
-        case 'f': f    = atof(optarg);          break;
-        case 'i': ki   = atof(optarg);          break;
-        case 'p': kp   = atof(optarg);          break;
-        case 'r': r    = atof(optarg);          break;
-        case 't': t    = atof(optarg);          break;
-        case 'T': T    = atof(optarg);          break;
+        case '0': bad = parse_axis(optarg, &x[A0]); break;
+        case '1': bad = parse_axis(optarg, &x[A1]); break;
+        case '2': bad = parse_axis(optarg, &x[A2]); break;
+        case 'A': tuning = 1;                       break;
+        case 'b': bad = parse_axis(optarg, &x[B0]); break;
+        case 'd': bad = parse_axis(optarg, &x[KD]); break;
+        case 'D': o.D = atof(optarg);               break;
+        case 'e': eps = atof(optarg);               break;
+        case 'E': o.dither = atof(optarg);          break;
+        case 'f': bad = parse_axis(optarg, &x[TF]); break;
+        case 'G': latency_binary = optarg;          break;
+        case 'H': latency_text = optarg;            break;
+        case 'i': bad = parse_axis(optarg, &x[KI]); break;
+        case 'j': j   = (unsigned) atoi(optarg);    break;
+        case 'J': mc.p.jitter = atof(optarg);       break;
+        case 'k': every = atol(optarg);             break;
+        case 'L': replay = optarg;                  break;
+        case 'm': trials = atof(optarg);            break;
+        case 'M': margins = 1;                      break;
+        case 'N': mc.p.noise = atof(optarg);        break;
+        case 'o': bad = parse_format(optarg, &format); break;
+        case 'p': bad = parse_axis(optarg, &x[KP]); break;
+        case 'q': o.counts = atof(optarg);          break;
+        case 'r': o.r = atof(optarg);               break;
+        case 's': o.single = 1;                     break;
+        case 'S': mc.p.seed = strtoull(optarg, NULL, 0); break;
+        case 't': o.t = atof(optarg);               break;
+        case 'T': o.T = atof(optarg);               break;
+        case 'u': mc.u = atof(optarg) / 100;        break;
+        case 'W': worst = atol(optarg);             break;
+        case 'x': mc.p.drop = atof(optarg);         break;
+        case 'z': o.method = HELM_PLANT_ZOH;        break;
         case 'h': print_usage(argv[0], stdout); return EXIT_SUCCESS;
         default:  print_usage(argv[0], stderr); return EXIT_FAILURE;
         }
+        if (bad) {
+            fprintf(stderr, "Unable to parse -%c %s\n", opt, optarg);
+            return EXIT_FAILURE;
+        }
     }
 
     // Avoid infinite loops by sanitizing inputs
-    if (t <= 0) {
+    if (o.t <= 0) {
         fprintf(stderr, "Step size t must be strictly positive\n");
         return EXIT_FAILURE;
     }
-    if (T <= 0) {
+    if (o.T <= 0) {
         fprintf(stderr, "Final time T must be strictly positive\n");
         return EXIT_FAILURE;
     }
+    if (every < 1) {
+        fprintf(stderr, "Decimation K must be strictly positive\n");
+        return EXIT_FAILURE;
+    }
+    if (o.D < 0) {
+        fprintf(stderr, "Dead time L must be nonnegative\n");
+        return EXIT_FAILURE;
+    }
+    if (!(o.counts >= 0 && o.counts < INFINITY)) {
+        fprintf(stderr, "Fixed point counts N must be nonnegative\n");
+        return EXIT_FAILURE;
+    }
+    if (!(trials >= 0 && trials == floor(trials) && trials < 0x1p63)) {
+        fprintf(stderr, "Trial count N must be a nonnegative integer\n");
+        return EXIT_FAILURE;
+    }
+    if (worst < 0 || worst > WORST_MAX) {
+        fprintf(stderr, "Worst trial count K must be in [0, %d]\n",
+                WORST_MAX);
+        return EXIT_FAILURE;
+    }
+    if (!(mc.p.noise >= 0 && mc.p.drop >= 0 && mc.p.drop <= 1
+          && mc.p.jitter >= 0 && mc.p.jitter < 1 && mc.u >= 0)) {
+        fprintf(stderr, "Perturbations must be nonnegative with "
+                        "p within [0, 1] and frac below 1\n");
+        return EXIT_FAILURE;
+    }
 
-    // Initialize state
-    double u[1] = {0};        // Actuator signal
-    double v[1] = {0};        // Control signal
-    double y[3] = {0, 0, 0};  // Model state
+    // Prepare group latency histograms shared by every thread
+    static struct helm_hist group[LATENCIES];
+    if (latency_text || latency_binary) {
+        for (int k = 0; k < LATENCIES; ++k) {
+            helm_hist_init(&group[k], helm_hist_tick_ns());
+        }
+        o.group = group;
+    }
 
-    // Initialize controller setting PID parameters from kp, ki, and kd
-    struct helm_state h;
-    helm_reset(&h);
-    h.kp = kp;         // Unified gain
-    h.Td = kd / h.kp;  // Convert to derivative time scale
-    h.Tf = f;          // Astrom and Murray p.308 suggests (h.Td / 2--20)
-    h.Ti = h.kp / ki;  // Convert to integral time scale
+    // Count combinations detecting overflow
+    size_t n = 1;
+    for (int k = 0; k < NAXES; ++k) {
+        if (n > SIZE_MAX / x[k].n) {
+            fprintf(stderr, "Too many combinations requested\n");
+            return EXIT_FAILURE;
+        }
+        n *= x[k].n;
+    }
 
-    // Simulate controlled model, outputting status after each step
-    helm_approach(&h);
-    for (size_t i = 0; i*t < T+t;) {
-        advance((++i*t > T ? T - (i-1)*t : t), a, b, u, y);      // Advance
-        printf("%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\t%-22.16g\n",
-               i*t > T ? T : i*t, u[0], y[0], y[1], y[2]);       // Output
-        v[0] += helm_steady(&h, t, r, u[0], v[0], y[0]);         // Control
-        u[0]  = v[0];                                            // Ideal
+    static char buf[1 << 20];
+    setvbuf(stdout, buf, _IOFBF, sizeof(buf));
+
+    // Tune a single combination automatically
+    if (tuning || replay) {
+        if (n != 1) {
+            fprintf(stderr, "Autotuning requires a single combination\n");
+            return EXIT_FAILURE;
+        }
+        struct setting one;
+        decode(x, 0, &one);
+        const int err = autotune(&one, &o, replay, j);
+        for (int k = 0; k < NAXES; ++k) {
+            free(x[k].v);
+        }
+        return err ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Analyze robustness of a single combination by Monte Carlo
+    if (trials > 0) {
+        if (n != 1) {
+            fprintf(stderr, "Monte Carlo requires a single combination\n");
+            return EXIT_FAILURE;
+        }
+        struct setting one;
+        decode(x, 0, &one);
+        mc.s = &one;
+        mc.n = (size_t) trials;
+        mc.K = (size_t) worst;
+        if (montecarlo(&mc, j, (size_t) every, eps)) {
+            fprintf(stderr, "Unable to allocate %zu trials\n", mc.n);
+            return EXIT_FAILURE;
+        }
+        for (int k = 0; k < NAXES; ++k) {
+            free(x[k].v);
+        }
+        return write_latency(latency_text, latency_binary, group, NULL, 0)
+             ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Simulate a single combination outputting status after each step
+    if (n == 1 && !margins) {
+        static struct writer w;
+        static struct helm_hist loop[LATENCIES];
+        struct setting one;
+        struct metrics ignored;
+        decode(x, 0, &one);
+        for (int k = 0; k < LATENCIES; ++k) {
+            helm_hist_init(&loop[k], helm_hist_tick_ns());
+        }
+        writer_open(&w, stdout, format, (size_t) every, eps);
+        if (simulate(&one, &o, NULL, &w, &ignored, o.group ? loop : NULL)) {
+            fprintf(stderr, "Unable to simulate the process\n");
+            return EXIT_FAILURE;
+        }
+        writer_close(&w);
+        return write_latency(latency_text, latency_binary, group, loop, 1)
+             ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Otherwise simulate every combination in parallel, timing only the
+    // group so that latency recording costs nothing per combination...
+    struct sweep w = {
+        x, &o, malloc(n * sizeof(struct metrics)),
+        margins ? malloc(n * sizeof(struct helm_freq_margins)) : NULL
+    };
+    if (!w.results || (margins && !w.margins)) {
+        fprintf(stderr, "Unable to allocate results for %zu combinations\n", n);
+        return EXIT_FAILURE;
     }
+    helm_pool_run(n, 0, j, sweep_range, &w);
 
-    return EXIT_SUCCESS;
+    // ...and then output only the summary table
+    for (int k = 0; k < NAXES; ++k) {
+        printf("%s%-14s", k ? "\t" : "#", axis_name[k]);
+    }
+    printf("\t%-14s\t%-14s\t%-14s\t%-14s\t%-14s",
+           "IAE", "ISE", "overshoot", "settle", "umax");
+    if (margins) {
+        printf("\t%-14s\t%-14s\t%-14s", "GM", "PM", "Ms");
+    }
+    putchar('\n');
+    for (size_t k = 0; k < n; ++k) {
+        struct setting c;
+        decode(x, k, &c);
+        const struct metrics * const m = &w.results[k];
+        printf("%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g\t"
+               "%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g\t",
+               c.a[0], c.a[1], c.a[2], c.b[0], c.kp, c.ki, c.kd, c.f);
+        printf("%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g\t%-14.8g",
+               m->iae, m->ise, m->overshoot, m->settle, m->umax);
+        if (margins) {
+            const struct helm_freq_margins * const g = &w.margins[k];
+            printf("\t%-14.8g\t%-14.8g\t%-14.8g", g->gm, g->pm, g->ms);
+        }
+        putchar('\n');
+    }
+
+    const int err = write_latency(latency_text, latency_binary, group,
+                                  NULL, 0);
+    free(w.results);
+    free(w.margins);
+    for (int k = 0; k < NAXES; ++k) {
+        free(x[k].v);
+    }
+    return err ? EXIT_FAILURE : EXIT_SUCCESS;
 }